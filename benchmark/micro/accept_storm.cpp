@@ -0,0 +1,99 @@
+// Microbenchmark: accept throughput during a reconnect storm.
+//
+// Opens N connections at once against a tcp_socket_server running on its own thread and
+// reports how fast the server accepts them, for several accept budgets (connections
+// accepted per readiness event). A budget of 1 behaves like accepting one connection per
+// completion. The connections are kept open until the end of each run.
+//
+// Linux only: the descriptor limit is raised with setrlimit.
+
+#include <thinger/asio/tcp_socket_server.hpp>
+
+#include <boost/asio.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace thinger;
+
+namespace {
+
+    size_t raise_descriptor_limit(size_t wanted) {
+        rlimit limit{};
+        getrlimit(RLIMIT_NOFILE, &limit);
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, wanted);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+        return limit.rlim_cur;
+    }
+
+    void run(size_t budget, size_t connections) {
+        boost::asio::io_context server_context;
+        auto work = boost::asio::make_work_guard(server_context);
+
+        asio::tcp_socket_server server("127.0.0.1", "0",
+                                       [&]() -> boost::asio::io_context& { return server_context; },
+                                       [&]() -> boost::asio::io_context& { return server_context; });
+        server.set_max_listening_attempts(1);
+        server.set_accept_budget(budget);
+
+        std::vector<std::shared_ptr<asio::socket>> accepted;
+        accepted.reserve(connections);
+        std::atomic<size_t> count{0};
+        server.set_handler([&](std::shared_ptr<asio::socket> sock) {
+            accepted.emplace_back(std::move(sock));
+            count.store(accepted.size(), std::memory_order_release);
+        });
+        if (!server.start()) {
+            std::fprintf(stderr, "cannot listen\n");
+            std::exit(1);
+        }
+        std::thread server_thread([&] { server_context.run(); });
+
+        boost::asio::io_context client_context;
+        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address("127.0.0.1"), server.local_port());
+        std::vector<boost::asio::ip::tcp::socket> clients;
+        clients.reserve(connections);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < connections; ++i) {
+            clients.emplace_back(client_context).async_connect(endpoint, [](const boost::system::error_code&) {});
+        }
+        client_context.run();
+        while (count.load(std::memory_order_acquire) < connections) {
+            std::this_thread::yield();
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("  budget %-4zu %10.0f connections/s\n", budget, connections / elapsed);
+
+        server.stop();
+        work.reset();
+        boost::asio::post(server_context, [&] { accepted.clear(); });
+        server_context.stop();
+        server_thread.join();
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t connections = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    size_t descriptors = raise_descriptor_limit(connections * 2 + 64);
+    if (descriptors < connections * 2 + 64) {
+        connections = (descriptors - 64) / 2;
+    }
+
+    std::printf("%zu connections per run\n", connections);
+    for (size_t budget : {1, 16, 64}) {
+        run(budget, connections);
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Microbenchmark: contiguous versus scatter/gather response writes, over TCP and TLS.
+//
+// Sends sequential "Hello World" requests over a keep-alive connection to an in-process
+// http::server, once with small responses copied into a contiguous output buffer (the
+// default) and once with every header block and body written as its own buffer
+// (set_max_coalesced_size(0)). Reports requests/s, the send()/sendmsg() calls of the server
+// thread per response and, over TLS, the SSL_write() calls (i.e., TLS records) per response.
+//
+// Linux only: the wrappers below shadow the libc and OpenSSL symbols to count the calls.
+
+#include <thinger/http/server/server_standalone.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+
+#include <dlfcn.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using namespace thinger;
+
+namespace {
+
+    // only calls made from the server thread are counted
+    thread_local bool count_calls = false;
+    std::atomic<size_t> server_sends{0};
+    std::atomic<size_t> server_records{0};
+
+}
+
+extern "C" ssize_t sendmsg(int fd, const struct msghdr* msg, int flags) {
+    if (count_calls) server_sends.fetch_add(1, std::memory_order_relaxed);
+    return syscall(SYS_sendmsg, fd, msg, flags);
+}
+
+extern "C" ssize_t send(int fd, const void* data, size_t size, int flags) {
+    if (count_calls) server_sends.fetch_add(1, std::memory_order_relaxed);
+    return syscall(SYS_sendto, fd, data, size, flags, nullptr, 0);
+}
+
+extern "C" int SSL_write(SSL* ssl, const void* data, int size) {
+    using ssl_write_function = int (*)(SSL*, const void*, int);
+    static auto next = reinterpret_cast<ssl_write_function>(dlsym(RTLD_NEXT, "SSL_write"));
+    if (count_calls) server_records.fetch_add(1, std::memory_order_relaxed);
+    return next(ssl, data, size);
+}
+
+namespace {
+
+    constexpr std::string_view body = "Hello World!";
+
+    template<typename Stream>
+    void send_requests(Stream& stream, size_t requests) {
+        const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        boost::asio::streambuf buffer;
+        for (size_t i = 0; i < requests; ++i) {
+            boost::asio::write(stream, boost::asio::buffer(request));
+            boost::asio::read_until(stream, buffer, body);
+            buffer.consume(buffer.size());
+        }
+    }
+
+    void run(bool tls, size_t max_coalesced_size, size_t requests) {
+        http::server server;
+        server.enable_ssl(tls);
+        server.set_max_coalesced_size(max_coalesced_size);
+        server.get("/", [](http::response& res) {
+            res.send(std::string(body));
+        });
+
+        if (!server.listen("127.0.0.1", 0)) {
+            std::fprintf(stderr, "cannot listen\n");
+            std::exit(1);
+        }
+        std::thread server_thread([&server] {
+            count_calls = true;
+            server.wait();
+        });
+
+        boost::asio::io_context ioc;
+        boost::asio::ssl::context ssl_context(boost::asio::ssl::context::tls_client);
+        boost::asio::ssl::stream<boost::asio::ip::tcp::socket> stream(ioc, ssl_context);
+        auto& sock = stream.next_layer();
+        sock.connect({boost::asio::ip::make_address("127.0.0.1"), server.local_port()});
+        sock.set_option(boost::asio::ip::tcp::no_delay(true));
+        if (tls) stream.handshake(boost::asio::ssl::stream_base::client);
+
+        auto exchange = [&](size_t count) {
+            if (tls) send_requests(stream, count);
+            else send_requests(sock, count);
+        };
+
+        // warm up: handshake, thread local caches and pools
+        exchange(1000);
+
+        size_t sends = server_sends.load();
+        size_t records = server_records.load();
+        auto start = std::chrono::steady_clock::now();
+        exchange(requests);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sends = server_sends.load() - sends;
+        records = server_records.load() - records;
+
+        std::printf("  %-4s %-15s %10.0f req/s   %5.2f sends/response",
+                    tls ? "TLS" : "TCP", max_coalesced_size ? "contiguous" : "scatter/gather",
+                    requests / elapsed, static_cast<double>(sends) / requests);
+        if (tls) std::printf("   %5.2f records/response", static_cast<double>(records) / requests);
+        std::printf("\n");
+
+        sock.close();
+        server.stop();
+        server_thread.join();
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t requests = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000;
+
+    std::printf("%zu sequential requests per run\n", requests);
+    for (bool tls : {false, true}) {
+        run(tls, 0, requests);
+        run(tls, 4096, requests);
+    }
+    return 0;
+}
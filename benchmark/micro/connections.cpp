@@ -0,0 +1,118 @@
+// Microbenchmark: keep-alive throughput with many concurrent connections.
+//
+// Opens N connections to an in-process http::server and keeps one "Hello World" request in
+// flight on each of them for a fixed time, reporting requests/s. The client side runs on a
+// single asio::io_context. The event loop backend is chosen when the library is built, so
+// epoll and io_uring are compared by running this against a library built without and with
+// -DTHINGER_HTTP_ENABLE_IO_URING=ON; the backend in use is printed first.
+//
+// Linux only: the descriptor limit is raised with setrlimit for the larger runs.
+
+#include <thinger/http/server/server_standalone.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+#include <thinger/asio/io_uring.hpp>
+
+#include <boost/asio.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace thinger;
+
+namespace {
+
+    constexpr std::string_view body = "Hello World!";
+    const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+    // each connection needs two descriptors (client and server side)
+    size_t raise_descriptor_limit(size_t wanted) {
+        rlimit limit{};
+        getrlimit(RLIMIT_NOFILE, &limit);
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, wanted);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+        return limit.rlim_cur;
+    }
+
+    // sends a request, waits for its response and starts over until stopped
+    awaitable<void> client(boost::asio::ip::tcp::socket sock, const bool& running, size_t& completed) {
+        boost::asio::streambuf buffer;
+        while (running) {
+            auto [write_ec, written] = co_await boost::asio::async_write(sock, boost::asio::buffer(request), use_nothrow_awaitable);
+            if (write_ec) co_return;
+            auto [read_ec, read] = co_await boost::asio::async_read_until(sock, buffer, body, use_nothrow_awaitable);
+            if (read_ec) co_return;
+            buffer.consume(buffer.size());
+            ++completed;
+        }
+    }
+
+    void run(uint16_t port, size_t connections, std::chrono::seconds duration) {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address("127.0.0.1"), port);
+
+        std::vector<boost::asio::ip::tcp::socket> sockets;
+        sockets.reserve(connections);
+        for (size_t i = 0; i < connections; ++i) {
+            sockets.emplace_back(ioc).connect(endpoint);
+            sockets.back().set_option(boost::asio::ip::tcp::no_delay(true));
+        }
+
+        bool running = true;
+        size_t completed = 0;
+        for (auto& sock : sockets) {
+            co_spawn(ioc, client(std::move(sock), running, completed), detached);
+        }
+
+        boost::asio::steady_timer timer(ioc, duration);
+        timer.async_wait([&](const boost::system::error_code&) { running = false; });
+
+        auto start = std::chrono::steady_clock::now();
+        ioc.run();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("  %-6zu connections %12.0f req/s\n", connections, completed / elapsed);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    auto duration = std::chrono::seconds(argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10);
+
+    http::server server;
+    server.set_connection_timeout(std::chrono::seconds(600));
+    server.get("/", [](http::response& res) {
+        res.send(std::string(body));
+    });
+
+    if (!server.listen("127.0.0.1", 0)) {
+        std::fprintf(stderr, "cannot listen\n");
+        return 1;
+    }
+    std::thread server_thread([&server] { server.wait(); });
+
+    std::printf("backend: %s, %llds per run\n", thinger::asio::io_backend(),
+                static_cast<long long>(duration.count()));
+    size_t descriptors = raise_descriptor_limit(2 * 10000 + 64);
+    for (size_t connections : {size_t{100}, size_t{10000}}) {
+        if (connections * 2 + 64 > descriptors) {
+            std::printf("  %-6zu connections skipped: descriptor limit %zu\n", connections, descriptors);
+            continue;
+        }
+        run(server.local_port(), connections, duration);
+    }
+
+    server.stop();
+    server_thread.join();
+    return 0;
+}
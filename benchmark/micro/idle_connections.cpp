@@ -0,0 +1,106 @@
+// Microbenchmark: resident memory held by idle keep-alive connections.
+//
+// Opens N connections to an in-process http::server, sends one request on each and
+// waits for the response, so every connection has been used and is idle again. The
+// growth of the process resident set size divided by N approximates the cost of an
+// idle connection (server side plus the client's socket object; kernel socket buffers
+// are not part of the RSS).
+//
+// Linux only: the resident set size is read from /proc/self/statm.
+
+#include <thinger/http/server/server_standalone.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+
+#include <boost/asio.hpp>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace thinger;
+
+namespace {
+
+    size_t resident_bytes() {
+        size_t pages = 0, resident = 0;
+        std::ifstream statm("/proc/self/statm");
+        statm >> pages >> resident;
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    // each connection needs two descriptors (client and server side)
+    size_t raise_descriptor_limit(size_t wanted) {
+        rlimit limit{};
+        getrlimit(RLIMIT_NOFILE, &limit);
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, wanted);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+        return limit.rlim_cur;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t connections = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    size_t descriptors = raise_descriptor_limit(connections * 2 + 64);
+    if (descriptors < connections * 2 + 64) {
+        connections = (descriptors - 64) / 2;
+        std::printf("descriptor limit %zu: using %zu connections\n", descriptors, connections);
+    }
+
+    http::server server;
+    server.set_connection_timeout(std::chrono::seconds(600));
+    server.get("/", [](http::response& res) {
+        res.send("Hello World!");
+    });
+
+    if (!server.listen("127.0.0.1", 0)) {
+        std::fprintf(stderr, "cannot listen\n");
+        return 1;
+    }
+    std::thread server_thread([&server] { server.wait(); });
+
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address("127.0.0.1"), server.local_port());
+    const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+    std::vector<std::unique_ptr<boost::asio::ip::tcp::socket>> sockets;
+    sockets.reserve(connections);
+
+    // let the server settle before taking the baseline
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    size_t before = resident_bytes();
+
+    char response[1024];
+    for (size_t i = 0; i < connections; ++i) {
+        auto sock = std::make_unique<boost::asio::ip::tcp::socket>(ioc);
+        sock->connect(endpoint);
+        boost::asio::write(*sock, boost::asio::buffer(request));
+        // the response is small enough to arrive in a single read
+        sock->read_some(boost::asio::buffer(response));
+        sockets.push_back(std::move(sock));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    size_t after = resident_bytes();
+
+    std::printf("%zu idle connections\n", connections);
+    std::printf("  resident before: %8.1f MB\n", before / 1048576.0);
+    std::printf("  resident after:  %8.1f MB\n", after / 1048576.0);
+    std::printf("  per connection:  %8.0f bytes\n", static_cast<double>(after - before) / connections);
+
+    sockets.clear();
+    server.stop();
+    server_thread.join();
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Microbenchmark: JSON response serialization.
+//
+// Serializes documents of about 100 KB and 1 MB as response::json() does, with dump() into a
+// single string, and as response::json_chunked() does, with json_writer in parts of the size
+// of a chunk. Reports the time per document and the most output held in memory at once.
+
+#include <thinger/http/data/out_json_stream.hpp>
+#include <thinger/http/util/json_writer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace thinger::http;
+using thinger::util::output_buffer;
+
+namespace {
+
+    nlohmann::json document(size_t items) {
+        nlohmann::json result = nlohmann::json::array();
+        for (size_t i = 0; i < items; ++i) {
+            result.push_back({
+                {"id", i},
+                {"name", "device-" + std::to_string(i)},
+                {"online", i % 3 == 0},
+                {"temperature", 20.0 + (i % 100) / 10.0},
+                {"tags", {"sensor", "outdoor"}}
+            });
+        }
+        return result;
+    }
+
+    template<typename F>
+    double time_us(size_t iterations, F&& f) {
+        size_t total = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            total += f();
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        // keep the result alive
+        if (total == 1) std::printf("unexpected\n");
+        return elapsed / iterations;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200;
+
+    for (size_t items : {1000, 10000}) {
+        auto doc = document(items);
+        auto size = doc.dump().size();
+
+        double dump = time_us(iterations, [&] {
+            std::string content = doc.dump();
+            return content.size();
+        });
+
+        size_t held = 0;
+        double chunked = time_us(iterations, [&] {
+            util::json_writer writer(doc);
+            output_buffer chunk;
+            size_t written = 0;
+            bool done = false;
+            while (!done) {
+                done = writer.write(chunk, data::out_json_stream::FLUSH_SIZE);
+                held = std::max(held, chunk.size());
+                written += chunk.size();
+                chunk.clear();
+            }
+            return written;
+        });
+
+        std::printf("%zu bytes: dump() %8.1f us, %zu bytes held   chunked %8.1f us, %zu bytes held\n",
+                    size, dump, size, chunked, held);
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Microbenchmark: pipelined requests on a single keep-alive connection.
+//
+// Sends batches of pipelined GET requests to an in-process http::server and reports the
+// throughput together with the number of sendmsg() calls issued by the server thread per
+// response, i.e., how many write syscalls the output path needs for each response.
+//
+// Linux only: the sendmsg() wrapper below shadows the libc symbol to count the calls.
+
+#include <thinger/http/server/server_standalone.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+
+#include <boost/asio.hpp>
+
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using namespace thinger;
+
+namespace {
+
+    // only calls made from the server thread are counted
+    thread_local bool count_sends = false;
+    std::atomic<size_t> server_sends{0};
+
+}
+
+extern "C" ssize_t sendmsg(int fd, const struct msghdr* msg, int flags) {
+    if (count_sends) server_sends.fetch_add(1, std::memory_order_relaxed);
+    return syscall(SYS_sendmsg, fd, msg, flags);
+}
+
+namespace {
+
+    constexpr std::string_view body = "Hello World!";
+
+    // read from the socket until `responses` bodies have been received
+    void read_responses(boost::asio::ip::tcp::socket& sock, size_t responses) {
+        char data[65536];
+        std::string pending;
+        size_t received = 0;
+        while (received < responses) {
+            size_t n = sock.read_some(boost::asio::buffer(data));
+            pending.append(data, n);
+            size_t pos = 0;
+            while ((pos = pending.find(body, pos)) != std::string::npos) {
+                ++received;
+                pos += body.size();
+            }
+            // keep a tail that may hold the beginning of a split body
+            size_t keep = std::min(pending.size(), body.size() - 1);
+            pending.erase(0, pending.size() - keep);
+        }
+    }
+
+    void run(uint16_t port, size_t depth, size_t total) {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::socket sock(ioc);
+        sock.connect({boost::asio::ip::make_address("127.0.0.1"), port});
+        sock.set_option(boost::asio::ip::tcp::no_delay(true));
+
+        std::string batch;
+        for (size_t i = 0; i < depth; ++i) {
+            batch += "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        }
+
+        size_t rounds = (total + depth - 1) / depth;
+        size_t sends_before = server_sends.load();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; ++i) {
+            boost::asio::write(sock, boost::asio::buffer(batch));
+            read_responses(sock, depth);
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t responses = rounds * depth;
+        size_t sends = server_sends.load() - sends_before;
+
+        std::printf("  depth %-4zu %12.0f req/s   %6.3f server sendmsg/response\n",
+                    depth, responses / elapsed, static_cast<double>(sends) / responses);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t total = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    http::server server;
+    server.get("/", [](http::response& res) {
+        res.send(std::string(body));
+    });
+
+    if (!server.listen("127.0.0.1", 0)) {
+        std::fprintf(stderr, "cannot listen\n");
+        return 1;
+    }
+
+    std::thread server_thread([&server] {
+        count_sends = true;
+        server.wait();
+    });
+
+    std::printf("%zu requests per depth\n", total);
+    for (size_t depth : {1, 4, 16, 64, 256}) {
+        run(server.local_port(), depth, total);
+    }
+
+    server.stop();
+    server_thread.join();
+    return 0;
+}
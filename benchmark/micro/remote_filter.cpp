@@ -0,0 +1,76 @@
+// Microbenchmark: remote address filtering on accept.
+//
+// Compares the compiled remote_filter (prefix trie over the binary address) with the
+// previous check, which formatted the address and looked it up in std::set<std::string>
+// allow and deny lists, for deny lists of 0 to 10k entries. The string lists hold single
+// addresses, while the trie holds /24 ranges, i.e., 256 times more addresses.
+
+#include <thinger/asio/remote_filter.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace thinger;
+
+namespace {
+
+    // previous socket_server_base::is_remote_allowed, after formatting the address
+    bool legacy_is_allowed(const std::set<std::string>& allowed, const std::set<std::string>& forbidden,
+                           const boost::asio::ip::address& remote) {
+        auto remote_ip = remote.to_string();
+        if (forbidden.contains(remote_ip)) return false;
+        if (!allowed.empty() && !allowed.contains(remote_ip)) return false;
+        return true;
+    }
+
+    template<typename Check>
+    double time_lookups(const std::vector<boost::asio::ip::address>& remotes, size_t iterations, Check&& check) {
+        size_t allowed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            allowed += check(remotes[i % remotes.size()]);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        // keep the result alive
+        if (allowed == iterations + 1) std::printf("unexpected\n");
+        return elapsed / iterations;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    std::mt19937 random(42);
+    std::vector<boost::asio::ip::address> remotes;
+    for (int i = 0; i < 4096; ++i) {
+        remotes.emplace_back(boost::asio::ip::address_v4(static_cast<uint32_t>(random())));
+    }
+
+    std::printf("%zu lookups per run\n", iterations);
+    for (size_t entries : {size_t{0}, size_t{100}, size_t{1000}, size_t{10000}}) {
+        std::set<std::string> forbidden_addresses;
+        std::set<std::string> forbidden_ranges;
+        for (size_t i = 0; i < entries; ++i) {
+            boost::asio::ip::address_v4 address(static_cast<uint32_t>(random()));
+            forbidden_addresses.insert(address.to_string());
+            forbidden_ranges.insert(boost::asio::ip::address_v4(address.to_uint() & 0xffffff00u).to_string() + "/24");
+        }
+        asio::remote_filter filter({}, forbidden_ranges);
+        std::set<std::string> allowed;
+
+        double legacy = time_lookups(remotes, iterations, [&](const auto& remote) {
+            return legacy_is_allowed(allowed, forbidden_addresses, remote);
+        });
+        double trie = time_lookups(remotes, iterations, [&](const auto& remote) {
+            return filter.empty() || filter.is_allowed(remote);
+        });
+        std::printf("  %-6zu forbidden   string set %7.1f ns   prefix trie %7.1f ns\n", entries, legacy, trie);
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Microbenchmark: heap allocations and throughput of keep-alive requests.
+//
+// Sends sequential "Hello World" requests over keep-alive connections to an in-process
+// http::server and reports requests/s together with the heap allocations made by the
+// server thread per request. Most of them are Boost.Asio coroutine frames and handler
+// memory, so this shows how much of the request path is served by the per-thread frame
+// recycling instead of the heap.
+//
+// The global operator new below counts the allocations of the server thread only.
+
+#include <thinger/http/server/server_standalone.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace thinger;
+
+namespace {
+
+    thread_local bool count_allocations = false;
+    std::atomic<size_t> allocations{0};
+
+}
+
+void* operator new(std::size_t size) {
+    if (count_allocations) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+    constexpr std::string_view body = "Hello World!";
+
+    // one request at a time on a keep-alive connection
+    void send_requests(uint16_t port, size_t requests) {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::socket sock(ioc);
+        sock.connect({boost::asio::ip::make_address("127.0.0.1"), port});
+        sock.set_option(boost::asio::ip::tcp::no_delay(true));
+
+        const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        boost::asio::streambuf buffer;
+        for (size_t i = 0; i < requests; ++i) {
+            boost::asio::write(sock, boost::asio::buffer(request));
+            boost::asio::read_until(sock, buffer, body);
+            buffer.consume(buffer.size());
+        }
+    }
+
+    void run(uint16_t port, size_t clients, size_t total) {
+        size_t per_client = total / clients;
+        size_t before = allocations.load();
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < clients; ++i) {
+            threads.emplace_back(send_requests, port, per_client);
+        }
+        for (auto& thread : threads) thread.join();
+
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t requests = per_client * clients;
+        size_t allocated = allocations.load() - before;
+
+        std::printf("  %-3zu connections %12.0f req/s   %6.2f server allocations/request\n",
+                    clients, requests / elapsed, static_cast<double>(allocated) / requests);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t total = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    http::server server;
+    server.get("/", [](http::request& req, http::response& res) {
+        res.send(std::string(body));
+    });
+
+    if (!server.listen("127.0.0.1", 0)) {
+        std::fprintf(stderr, "cannot listen\n");
+        return 1;
+    }
+
+    std::thread server_thread([&server] {
+        count_allocations = true;
+        server.wait();
+    });
+
+    // warm up the server thread caches and pools
+    send_requests(server.local_port(), 1000);
+
+    std::printf("%zu requests per run\n", total);
+    for (size_t clients : {1, 4, 16}) {
+        run(server.local_port(), clients, total);
+    }
+
+    server.stop();
+    server_thread.join();
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Microbenchmark: route lookup and registration.
+//
+// Registers about 400 REST-style routes (static segments, :param and :param(regex)) for one
+// method and compares the route tree used by route_handler::find_route with the previous
+// linear scan, which tried the anchored regex of every route in registration order.
+// Registration compares compiling every route regex with inserting the routes in the tree.
+
+#include <thinger/http/server/routing/route_builder.hpp>
+#include <thinger/http/server/routing/route_tree.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace thinger::http;
+
+namespace {
+
+    std::vector<std::string> api_patterns() {
+        std::vector<std::string> patterns;
+        for (int resource = 0; resource < 40; ++resource) {
+            auto base = "/api/v1/resource" + std::to_string(resource);
+            patterns.push_back(base);
+            patterns.push_back(base + "/stats");
+            patterns.push_back(base + "/:id");
+            patterns.push_back(base + "/:id([0-9]+)/history");
+            patterns.push_back(base + "/:id/items");
+            patterns.push_back(base + "/:id/items/:item");
+            patterns.push_back(base + "/:id/items/:item/properties/:property");
+            patterns.push_back(base + "/:id/items/:item([a-zA-Z0-9_-]{1,32})/data");
+            patterns.push_back("/users/:user/resource" + std::to_string(resource) + "/:id");
+            patterns.push_back("/users/:user/resource" + std::to_string(resource) + "/:id/callback");
+        }
+        return patterns;
+    }
+
+    const std::vector<std::string> paths = {
+        "/api/v1/resource0",
+        "/api/v1/resource20/stats",
+        "/api/v1/resource39/dev1/items/temp",
+        "/api/v1/resource39/dev1/items/temp/properties/value",
+        "/api/v1/resource25/1234/history",
+        "/users/alice/resource30/dev1/callback",
+        "/api/v1/unknown/path",
+    };
+
+    // previous route_handler::find_route
+    size_t linear_find(const std::vector<route>& routes, const std::string& path) {
+        for (size_t i = 0; i < routes.size(); ++i) {
+            std::smatch matches;
+            if (routes[i].matches(path, matches)) return i;
+        }
+        return route_tree::npos;
+    }
+
+    template<typename Find>
+    double time_lookups(const std::string& path, size_t iterations, Find&& find) {
+        size_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            found += find(path);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        // keep the result alive
+        if (found == 1) std::printf("unexpected\n");
+        return elapsed / iterations;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    auto patterns = api_patterns();
+
+    // registration
+    auto start = std::chrono::steady_clock::now();
+    std::vector<route> compiled;
+    for (const auto& pattern : patterns) {
+        compiled.emplace_back(pattern);
+        compiled.back().get_regex();
+    }
+    auto regex_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    std::vector<route> routes;
+    route_tree tree;
+    route_builder builder(method::GET, routes, tree);
+    for (const auto& pattern : patterns) builder[pattern];
+    auto tree_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%zu routes: registration with regex %.1f ms, with route tree %.1f ms\n",
+                patterns.size(), regex_ms, tree_ms);
+
+    std::printf("%zu lookups per path\n", iterations);
+    for (const auto& path : paths) {
+        double linear = time_lookups(path, iterations, [&](const std::string& p) {
+            return linear_find(compiled, p);
+        });
+        route_tree::match match;
+        double radix = time_lookups(path, iterations, [&](const std::string& p) {
+            return tree.find(routes, p, match) ? match.index : route_tree::npos;
+        });
+        std::printf("  %-55s linear regex %9.0f ns   route tree %6.0f ns\n", path.c_str(), linear, radix);
+    }
+    return 0;
+}
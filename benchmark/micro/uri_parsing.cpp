@@ -0,0 +1,132 @@
+// Microbenchmark: request target / URL parsing in http_request.
+//
+// Compares the current hand-written splitter (http_request::set_uri / set_url) with
+// the std::regex based implementation it replaced, reproduced below verbatim.
+
+#include <thinger/http/common/http_request.hpp>
+#include <thinger/http/util/url.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace thinger;
+
+namespace legacy {
+
+    struct parsed_uri {
+        std::string resource;
+        std::multimap<std::string, std::string> params;
+    };
+
+    // previous http_request::set_uri
+    void set_uri(const std::string& uri, parsed_uri& out) {
+        std::smatch what;
+        std::string::const_iterator start = uri.begin();
+        std::string::const_iterator end = uri.end();
+
+        static const std::regex resource_regex("(\\/[^\\?#]*)");
+        if (std::regex_search(start, end, what, resource_regex)) {
+            out.resource = http::util::url::url_decode(std::string(what[0].first, what[1].second));
+            start = what[0].second;
+        }
+
+        if (start != uri.end() && *start == '?') {
+            ++start;
+            http::util::url::parse_url_encoded_data(start, end, out.params);
+        }
+    }
+
+    // previous http_request::set_url (component extraction only)
+    bool set_url(const std::string& url, parsed_uri& out) {
+        static const std::regex uri_regex(R"((wss?|https?):\/\/(?:(.*):(.*)@)?([a-zA-Z\.\-0-9_]+)(?::(\d+))*(.*))");
+        std::match_results<std::string::const_iterator> results;
+        if (std::regex_match(url, results, uri_regex)) {
+            std::string uri = results[6];
+            set_uri(uri.empty() ? "/" : uri, out);
+            return true;
+        }
+        return false;
+    }
+}
+
+template<typename Fn>
+static void run(const char* name, size_t iterations, Fn&& fn) {
+    // warm up
+    for (size_t i = 0; i < iterations / 10; ++i) fn(i);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) fn(i);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+    std::printf("%-40s %10.1f ns/op\n", name, ns);
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 200000;
+
+    const std::vector<std::string> targets = {
+        "/",
+        "/api/v1/users/1234",
+        "/api/v1/devices/thermostat-01/resources/temperature",
+        "/search?q=hello+world&page=2&limit=50",
+        "/files/my%20document%20final.pdf",
+    };
+
+    const std::vector<std::string> urls = {
+        "http://localhost:8080/api/v1/users/1234",
+        "https://api.example.com/v2/search?q=hello+world&page=2",
+        "wss://example.com/ws",
+    };
+
+    // accumulated results, printed at the end so the work cannot be optimized away
+    size_t sink = 0;
+
+    for (const auto& target : targets) {
+        std::printf("\ntarget: %s\n", target.c_str());
+
+        run("legacy regex set_uri + eager query", iterations, [&](size_t) {
+            legacy::parsed_uri parsed;
+            legacy::set_uri(target, parsed);
+            sink += parsed.resource.size() + parsed.params.size();
+        });
+
+        run("set_uri (query not accessed)", iterations, [&](size_t) {
+            http::http_request request;
+            request.set_uri(target);
+            sink += request.get_resource().size();
+        });
+
+        run("set_uri + query access", iterations, [&](size_t) {
+            http::http_request request;
+            request.set_uri(target);
+            sink += request.get_resource().size() + request.get_uri_parameters().size();
+        });
+    }
+
+    for (const auto& url : urls) {
+        std::printf("\nurl: %s\n", url.c_str());
+
+        run("legacy regex set_url", iterations, [&](size_t) {
+            legacy::parsed_uri parsed;
+            sink += legacy::set_url(url, parsed);
+        });
+
+        run("split_uri", iterations, [&](size_t) {
+            http::util::url::uri_parts parts;
+            sink += http::util::url::split_uri(url, parts);
+        });
+
+        run("set_url", iterations, [&](size_t) {
+            http::http_request request;
+            sink += request.set_url(url);
+        });
+    }
+
+    std::printf("\n(checksum %zu)\n", sink);
+    return 0;
+}
@@ -1,11 +1,17 @@
 #include <thinger/http.hpp>
 #include <iostream>
+#include <string_view>
 
 using namespace thinger;
 
-int main() {
+int main(int argc, char* argv[]) {
     http::pool_server srv;
 
+    // --reuse-port: one SO_REUSEPORT listener per worker thread
+    if (argc > 1 && std::string_view(argv[1]) == "--reuse-port") {
+        srv.enable_reuse_port(true, true);
+    }
+
     srv.get("/", [](http::request& req, http::response& res) {
         res.send("Hello World!");
     });
@@ -14,4 +20,4 @@ int main() {
     srv.start("0.0.0.0", 9080);
 
     return 0;
-}
\ No newline at end of file
+}
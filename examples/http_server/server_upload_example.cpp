@@ -144,7 +144,7 @@ function uploadFile(file) {
         const auto& body = http_req->get_body();
         const auto& filename = req["filename"];
         auto content_type = http_req->has_header("Content-Type")
-            ? http_req->get_header("Content-Type")
+            ? std::string(http_req->get_header("Content-Type"))
             : std::string("unknown");
 
         // Compute a simple checksum (XOR of all bytes)
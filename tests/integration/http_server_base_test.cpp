@@ -6,6 +6,7 @@
 #include <thinger/util/types.hpp>
 #include <nlohmann/json.hpp>
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <chrono>
 #include <thread>
 #include <future>
@@ -1085,6 +1086,17 @@ TEST_CASE("Server HTTP pipelining - two GET requests in one TCP send", "[server]
         res.json({{"pong", true}, {"count", call_count.load()}});
     });
 
+    server.get("/seq/:id", [](http::request& req, http::response& res) {
+        res.send("seq-" + req["id"]);
+    });
+
+    server.get("/seq-chunked/:id", [](http::request& req, http::response& res) {
+        res.start_chunked("text/plain");
+        res.write_chunk("chunked-");
+        res.write_chunk(req["id"]);
+        res.end_chunked();
+    });
+
     fixture.start_server();
 
     SECTION("Two pipelined GET requests both receive responses") {
@@ -1126,6 +1138,215 @@ TEST_CASE("Server HTTP pipelining - two GET requests in one TCP send", "[server]
         std::this_thread::sleep_for(100ms);
         REQUIRE(call_count >= 2);
     }
+
+    SECTION("Many pipelined requests are answered in order") {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::socket sock(ioc);
+        boost::asio::ip::tcp::resolver resolver(ioc);
+        boost::asio::connect(sock, resolver.resolve("127.0.0.1", std::to_string(fixture.port)));
+
+        // mix plain and chunked responses, so frames of several streams are written together
+        constexpr int requests = 100;
+        std::string pipelined;
+        for (int i = 0; i < requests; ++i) {
+            pipelined += (i % 3 == 0 ? "GET /seq-chunked/" : "GET /seq/") + std::to_string(i) +
+                         " HTTP/1.1\r\nHost: localhost\r\n" +
+                         (i == requests - 1 ? "Connection: close\r\n" : "") + "\r\n";
+        }
+        boost::asio::write(sock, boost::asio::buffer(pipelined));
+
+        boost::system::error_code ec;
+        boost::asio::streambuf response_buf;
+        boost::asio::read(sock, response_buf, ec);
+        std::string response_str(
+            boost::asio::buffers_begin(response_buf.data()),
+            boost::asio::buffers_end(response_buf.data()));
+
+        // every body appears once, after the previous one
+        size_t pos = 0;
+        for (int i = 0; i < requests; ++i) {
+            std::string id = std::to_string(i);
+            std::string body = i % 3 == 0 ?
+                "8\r\nchunked-\r\n" + std::to_string(id.size()) + "\r\n" + id + "\r\n0\r\n\r\n" :
+                "\r\n\r\nseq-" + id;
+            auto next = response_str.find(body, pos);
+            INFO("response " << i);
+            REQUIRE(next != std::string::npos);
+            pos = next + body.size();
+        }
+        REQUIRE(pos == response_str.size());
+    }
+}
+
+TEST_CASE("Server coalesced response writes", "[server][pipelining][integration]") {
+    ServerBaseTestFixture fixture;
+    auto& server = fixture.server;
+
+    // bodies of different sizes, so batches mix copied and referenced buffers
+    auto body = [](int i) {
+        size_t size = i % 4 == 0 ? 20000 : i % 4 == 1 ? 3000 : 12;
+        return std::string(size, static_cast<char>('a' + i % 26));
+    };
+
+    server.get("/body/:id", [&](http::request& req, http::response& res) {
+        res.send(body(std::stoi(req["id"])));
+    });
+
+    auto exchange = [&](int requests) {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::socket sock(ioc);
+        boost::asio::ip::tcp::resolver resolver(ioc);
+        boost::asio::connect(sock, resolver.resolve("127.0.0.1", std::to_string(fixture.port)));
+
+        std::string pipelined;
+        for (int i = 0; i < requests; ++i) {
+            pipelined += "GET /body/" + std::to_string(i) + " HTTP/1.1\r\nHost: localhost\r\n" +
+                         (i == requests - 1 ? "Connection: close\r\n" : "") + "\r\n";
+        }
+        boost::asio::write(sock, boost::asio::buffer(pipelined));
+
+        boost::system::error_code ec;
+        boost::asio::streambuf response_buf;
+        boost::asio::read(sock, response_buf, ec);
+        return std::string(boost::asio::buffers_begin(response_buf.data()),
+                           boost::asio::buffers_end(response_buf.data()));
+    };
+
+    auto require_bodies = [&](const std::string& response, int requests) {
+        size_t pos = 0;
+        for (int i = 0; i < requests; ++i) {
+            auto expected = "\r\n\r\n" + body(i);
+            auto next = response.find(expected, pos);
+            INFO("response " << i);
+            REQUIRE(next != std::string::npos);
+            pos = next + expected.size();
+        }
+        REQUIRE(pos == response.size());
+    };
+
+    SECTION("Small and large bodies are written intact") {
+        fixture.start_server();
+        require_bodies(exchange(40), 40);
+    }
+
+    SECTION("Coalescing everything that fits the output buffer") {
+        server.set_max_coalesced_size(64 * 1024);
+        fixture.start_server();
+        require_bodies(exchange(40), 40);
+    }
+
+    SECTION("Scatter/gather only") {
+        server.set_max_coalesced_size(0);
+        fixture.start_server();
+        require_bodies(exchange(40), 40);
+    }
+}
+
+TEST_CASE("Server concurrent pipelined requests", "[server][pipelining][integration]") {
+    ServerBaseTestFixture fixture;
+    auto& server = fixture.server;
+
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+
+    // awaitable handler that completes after the given delay
+    server.get("/delay/:ms", [&](http::request& req, http::response& res) -> thinger::awaitable<void> {
+        int now = ++running;
+        int seen = max_running.load();
+        while (now > seen && !max_running.compare_exchange_weak(seen, now)) {}
+
+        boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+        timer.expires_after(std::chrono::milliseconds(std::stoi(req["ms"])));
+        co_await timer.async_wait(boost::asio::use_awaitable);
+
+        --running;
+        res.send("delay-" + req["ms"]);
+    });
+
+    server.post("/echo", [](http::request& req, http::response& res) {
+        res.send("echo-" + req.body());
+    });
+
+    // earlier requests take longer, so responses are produced out of order
+    const std::vector<int> delays = {400, 300, 200, 100};
+    auto pipelined = [&](const std::string& middle) {
+        std::string requests;
+        for (size_t i = 0; i < delays.size(); ++i) {
+            if (i == 2) requests += middle;
+            requests += "GET /delay/" + std::to_string(delays[i]) + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        }
+        // closing requests are handled once the previous ones are done
+        return requests + "GET /delay/0 HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+    };
+
+    auto exchange = [&](const std::string& requests) {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::socket sock(ioc);
+        boost::asio::ip::tcp::resolver resolver(ioc);
+        boost::asio::connect(sock, resolver.resolve("127.0.0.1", std::to_string(fixture.port)));
+        boost::asio::write(sock, boost::asio::buffer(requests));
+
+        boost::system::error_code ec;
+        boost::asio::streambuf response_buf;
+        boost::asio::read(sock, response_buf, ec);
+        return std::string(boost::asio::buffers_begin(response_buf.data()),
+                           boost::asio::buffers_end(response_buf.data()));
+    };
+
+    auto require_order = [](const std::string& response, const std::vector<std::string>& bodies) {
+        size_t pos = 0;
+        for (const auto& body : bodies) {
+            auto next = response.find(body, pos);
+            INFO("body " << body);
+            REQUIRE(next != std::string::npos);
+            pos = next + body.size();
+        }
+    };
+
+    SECTION("Handlers run concurrently and responses keep the request order") {
+        server.set_max_pipelined_requests(8);
+        fixture.start_server();
+
+        auto start = std::chrono::steady_clock::now();
+        auto response = exchange(pipelined(""));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        require_order(response, {"delay-400", "delay-300", "delay-200", "delay-100", "delay-0"});
+        REQUIRE(max_running == 4);
+        REQUIRE(elapsed < 800ms);
+    }
+
+    SECTION("Requests with a body wait for the pipelined ones") {
+        server.set_max_pipelined_requests(8);
+        fixture.start_server();
+
+        auto response = exchange(pipelined("POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nhello"));
+
+        require_order(response, {"delay-400", "delay-300", "echo-hello", "delay-200", "delay-100", "delay-0"});
+        REQUIRE(max_running == 2);
+    }
+
+    SECTION("The limit bounds the requests in flight") {
+        server.set_max_pipelined_requests(2);
+        fixture.start_server();
+
+        auto response = exchange(pipelined(""));
+
+        require_order(response, {"delay-400", "delay-300", "delay-200", "delay-100", "delay-0"});
+        REQUIRE(max_running == 2);
+    }
+
+    SECTION("Requests are handled one at a time by default") {
+        fixture.start_server();
+
+        auto start = std::chrono::steady_clock::now();
+        auto response = exchange(pipelined(""));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        require_order(response, {"delay-400", "delay-300", "delay-200", "delay-100", "delay-0"});
+        REQUIRE(max_running == 1);
+        REQUIRE(elapsed >= 1000ms);
+    }
 }
 
 // ============================================================================
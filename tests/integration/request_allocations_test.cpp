@@ -0,0 +1,88 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/server/server_standalone.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+#include <boost/asio.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <string>
+#include <thread>
+
+using namespace thinger;
+
+// Counting allocator: global operator new counts the allocations made from threads
+// that enabled counting (the server thread), so the client side is not measured.
+namespace {
+    // upper bound for the heap allocations of a keep-alive "Hello World" request
+    constexpr size_t MAX_ALLOCATIONS_PER_REQUEST = 32;
+
+    thread_local bool count_allocations = false;
+    std::atomic<size_t> allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    if (count_allocations) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+    // send requests one at a time on a keep-alive connection, reading each response
+    void send_requests(boost::asio::ip::tcp::socket& sock, size_t count) {
+        const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        boost::asio::streambuf buffer;
+        for (size_t i = 0; i < count; ++i) {
+            boost::asio::write(sock, boost::asio::buffer(request));
+            boost::asio::read_until(sock, buffer, "Hello World!");
+            buffer.consume(buffer.size());
+        }
+    }
+
+}
+
+TEST_CASE("Heap allocations per request are bounded", "[server][allocations][integration]") {
+    // same route as the thinger-http benchmark server
+    http::server server;
+    server.get("/", [](http::request& req, http::response& res) {
+        res.send("Hello World!");
+    });
+
+    REQUIRE(server.listen("127.0.0.1", 0));
+    std::promise<void> ready;
+    std::thread server_thread([&] {
+        count_allocations = true;
+        ready.set_value();
+        server.wait();
+    });
+    ready.get_future().wait();
+
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::socket sock(ioc);
+    sock.connect({boost::asio::ip::make_address("127.0.0.1"), server.local_port()});
+
+    // warm up: connection setup, thread local caches and pools
+    send_requests(sock, 100);
+
+    constexpr size_t requests = 1000;
+    size_t before = allocations.load();
+    send_requests(sock, requests);
+    size_t per_request = (allocations.load() - before + requests - 1) / requests;
+
+    sock.close();
+    server.stop();
+    server_thread.join();
+
+    INFO("heap allocations per request: " << per_request);
+    REQUIRE(per_request <= MAX_ALLOCATIONS_PER_REQUEST);
+}
@@ -7,6 +7,9 @@
 
 #include <boost/asio/steady_timer.hpp>
 
+#include <atomic>
+#include <vector>
+#include <memory>
 #include <thread>
 #include <chrono>
 #include <filesystem>
@@ -344,6 +347,176 @@ TEST_CASE_METHOD(TcpEchoFixture, "TCP: enable and disable tcp_no_delay",
     });
 }
 
+// TCP: one SO_REUSEPORT listener per io_context
+TEST_CASE("TCP: reuse port listeners keep connections on the accepting thread",
+          "[tcp][socket][io][integration]") {
+    constexpr size_t threads = 2;
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+    std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> works;
+    for (size_t i = 0; i < threads; ++i) {
+        contexts.emplace_back(std::make_unique<boost::asio::io_context>());
+        works.emplace_back(contexts.back()->get_executor());
+    }
+
+    tcp_socket_server server("127.0.0.1", "0",
+                             [&]() -> boost::asio::io_context& { return *contexts[0]; },
+                             [&]() -> boost::asio::io_context& { return *contexts[0]; });
+    server.set_max_listening_attempts(1);
+    server.enable_reuse_port(true, true);
+    server.set_listener_contexts_provider([&]() {
+        std::vector<std::reference_wrapper<boost::asio::io_context>> listeners;
+        for (auto& context : contexts) listeners.emplace_back(*context);
+        return listeners;
+    });
+
+    // echo, from the thread that runs the io_context of the accepted socket
+    std::atomic<size_t> on_own_thread{0};
+    std::atomic<size_t> accepted{0};
+    server.set_handler([&](std::shared_ptr<asio::socket> sock) {
+        ++accepted;
+        if (sock->get_io_context().get_executor().running_in_this_thread()) ++on_own_thread;
+        co_spawn(sock->get_io_context(), [sock]() -> awaitable<void> {
+            uint8_t buf[64];
+            auto [ec, n] = co_await sock->read_some(buf, sizeof(buf));
+            if (!ec) co_await sock->write(buf, n);
+        }, detached);
+    });
+    REQUIRE(server.start());
+    REQUIRE(server.local_port() != 0);
+
+    std::vector<std::thread> io_threads;
+    for (auto& context : contexts) {
+        io_threads.emplace_back([&context]() { context->run(); });
+    }
+
+    constexpr size_t connections = 16;
+    run_client([&](boost::asio::io_context& ctx) -> awaitable<void> {
+        for (size_t i = 0; i < connections; ++i) {
+            tcp_socket client("test", ctx);
+            auto ec = co_await client.connect("127.0.0.1", std::to_string(server.local_port()), 5s);
+            REQUIRE_FALSE(ec);
+            auto [w_ec, written] = co_await client.write("ping"sv);
+            REQUIRE_FALSE(w_ec);
+            uint8_t buf[8];
+            auto [r_ec, n] = co_await client.read(buf, 4);
+            REQUIRE_FALSE(r_ec);
+            REQUIRE(std::string_view(reinterpret_cast<char*>(buf), n) == "ping");
+        }
+    });
+
+    REQUIRE(accepted == connections);
+    REQUIRE(on_own_thread == connections);
+
+    server.stop();
+    works.clear();
+    for (auto& context : contexts) context->stop();
+    for (auto& thread : io_threads) thread.join();
+}
+
+// TCP: connections accepted in batches and filtered by address
+TEST_CASE("TCP: batched accept and remote filtering", "[tcp][socket][io][integration]") {
+    boost::asio::io_context io_ctx;
+    auto work = boost::asio::make_work_guard(io_ctx);
+    tcp_socket_server server("127.0.0.1", "0",
+                             [&]() -> boost::asio::io_context& { return io_ctx; },
+                             [&]() -> boost::asio::io_context& { return io_ctx; });
+    server.set_max_listening_attempts(1);
+
+    std::atomic<size_t> accepted{0};
+    server.set_handler([&](std::shared_ptr<asio::socket> sock) {
+        ++accepted;
+        co_spawn(io_ctx, [sock]() -> awaitable<void> {
+            uint8_t buf[64];
+            auto [ec, n] = co_await sock->read_some(buf, sizeof(buf));
+            if (!ec) co_await sock->write(buf, n);
+        }, detached);
+    });
+
+    // connect and wait for the echo, or for the server to close the connection
+    auto echoes = [&](size_t connections) {
+        size_t echoed = 0;
+        run_client([&](boost::asio::io_context& ctx) -> awaitable<void> {
+            std::vector<std::unique_ptr<tcp_socket>> clients;
+            for (size_t i = 0; i < connections; ++i) {
+                auto client = std::make_unique<tcp_socket>("test", ctx);
+                auto ec = co_await client->connect("127.0.0.1", std::to_string(server.local_port()), 5s);
+                REQUIRE_FALSE(ec);
+                clients.emplace_back(std::move(client));
+            }
+            for (auto& client : clients) {
+                co_await client->write("ping"sv);
+                uint8_t buf[8];
+                auto [ec, n] = co_await client->read(buf, 4);
+                if (!ec && n == 4) ++echoed;
+            }
+        });
+        return echoed;
+    };
+
+    SECTION("All pending connections are accepted with a small budget") {
+        server.set_accept_budget(4);
+        REQUIRE(server.start());
+        std::thread io_thread([&]() { io_ctx.run(); });
+
+        // opened back to back, so several connections are pending at each wakeup
+        REQUIRE(echoes(50) == 50);
+        REQUIRE(accepted == 50);
+
+        server.stop();
+        work.reset();
+        io_ctx.stop();
+        io_thread.join();
+    }
+
+    SECTION("Forbidden remotes are rejected") {
+        server.set_forbidden_remotes({"127.0.0.1"});
+        REQUIRE(server.start());
+        std::thread io_thread([&]() { io_ctx.run(); });
+
+        REQUIRE(echoes(3) == 0);
+        REQUIRE(accepted == 0);
+
+        server.stop();
+        work.reset();
+        io_ctx.stop();
+        io_thread.join();
+    }
+
+    SECTION("Only allowed remotes are accepted") {
+        server.set_allowed_remotes({"10.0.0.1"});
+        REQUIRE(server.start());
+        std::thread io_thread([&]() { io_ctx.run(); });
+
+        REQUIRE(echoes(2) == 0);
+        server.set_allowed_remotes({"10.0.0.1", "127.0.0.1"});
+        REQUIRE(echoes(2) == 2);
+        REQUIRE(accepted == 2);
+
+        server.stop();
+        work.reset();
+        io_ctx.stop();
+        io_thread.join();
+    }
+
+    SECTION("CIDR ranges can be swapped while running") {
+        server.set_remotes({"10.0.0.0/8"}, {});
+        REQUIRE(server.start());
+        std::thread io_thread([&]() { io_ctx.run(); });
+
+        REQUIRE(echoes(2) == 0);
+        server.set_remotes({"10.0.0.0/8", "127.0.0.0/8"}, {});
+        REQUIRE(echoes(2) == 2);
+        server.set_remotes({}, {"127.0.0.0/24"});
+        REQUIRE(echoes(2) == 0);
+        REQUIRE(accepted == 2);
+
+        server.stop();
+        work.reset();
+        io_ctx.stop();
+        io_thread.join();
+    }
+}
+
 // ============================================================================
 // Unix Socket Tests (#11 - #16)
 // ============================================================================
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/asio/offload.hpp>
+#include <boost/asio/io_context.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace thinger;
+
+namespace {
+
+    // run a coroutine to completion on its own io_context
+    template<typename F>
+    void run_coroutine(F&& f) {
+        boost::asio::io_context io;
+        std::exception_ptr error;
+        co_spawn(io, std::forward<F>(f), [&](std::exception_ptr e) { error = e; });
+        io.run();
+        if (error) std::rethrow_exception(error);
+    }
+
+}
+
+TEST_CASE("Offload pool", "[asio][offload][unit]") {
+
+    SECTION("Jobs run on the pool and resume on the caller thread") {
+        asio::offload_pool pool(2, 16);
+        std::thread::id caller, job, resumed;
+
+        run_coroutine([&]() -> awaitable<void> {
+            caller = std::this_thread::get_id();
+            int result = co_await offload(pool, [&] {
+                job = std::this_thread::get_id();
+                return 42;
+            });
+            resumed = std::this_thread::get_id();
+            REQUIRE(result == 42);
+        });
+
+        REQUIRE(job != caller);
+        REQUIRE(resumed == caller);
+        REQUIRE(pool.pending() == 0);
+    }
+
+    SECTION("Void jobs") {
+        asio::offload_pool pool(1, 16);
+        bool ran = false;
+
+        run_coroutine([&]() -> awaitable<void> {
+            co_await offload(pool, [&] { ran = true; });
+        });
+
+        REQUIRE(ran);
+    }
+
+    SECTION("Exceptions are rethrown to the caller") {
+        asio::offload_pool pool(1, 16);
+        bool caught = false;
+
+        run_coroutine([&]() -> awaitable<void> {
+            try {
+                co_await offload(pool, []() -> int { throw std::runtime_error("failed"); });
+            } catch (const std::runtime_error& e) {
+                caught = std::string(e.what()) == "failed";
+            }
+        });
+
+        REQUIRE(caught);
+        REQUIRE(pool.pending() == 0);
+    }
+
+    SECTION("A saturated pool rejects jobs") {
+        asio::offload_pool pool(1, 2);
+        std::vector<asio::offload_pool::slot> slots;
+        slots.push_back(pool.try_acquire());
+        slots.push_back(pool.try_acquire());
+        REQUIRE(slots[0]);
+        REQUIRE(slots[1]);
+        REQUIRE_FALSE(pool.try_acquire());
+
+        bool rejected = false;
+        run_coroutine([&]() -> awaitable<void> {
+            try {
+                co_await offload(pool, [] { return 1; });
+            } catch (const asio::offload_rejected&) {
+                rejected = true;
+            }
+        });
+        REQUIRE(rejected);
+        REQUIRE(pool.rejected() == 2);
+
+        // room again once a job finishes
+        slots.pop_back();
+        int result = 0;
+        run_coroutine([&]() -> awaitable<void> {
+            result = co_await offload(pool, [] { return 7; });
+        });
+        REQUIRE(result == 7);
+    }
+
+    SECTION("Concurrent jobs from several coroutines") {
+        asio::offload_pool pool(4, 1024);
+        boost::asio::io_context io;
+        int completed = 0;
+        for (int i = 0; i < 100; ++i) {
+            co_spawn(io, [&, i]() -> awaitable<void> {
+                auto square = co_await offload(pool, [i] { return i * i; });
+                if (square == i * i) ++completed;
+            }, detached);
+        }
+        io.run();
+        REQUIRE(completed == 100);
+    }
+}
@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/asio/remote_filter.hpp>
+#include <string>
+
+using namespace thinger::asio;
+
+namespace {
+
+    boost::asio::ip::address address(const std::string& value) {
+        return boost::asio::ip::make_address(value);
+    }
+
+}
+
+TEST_CASE("Prefix set", "[remote_filter][unit]") {
+
+    SECTION("Empty set contains nothing") {
+        prefix_set set;
+        REQUIRE(set.empty());
+        REQUIRE_FALSE(set.contains(address("10.0.0.1")));
+        REQUIRE_FALSE(set.contains(address("::1")));
+    }
+
+    SECTION("Single addresses") {
+        prefix_set set;
+        REQUIRE(set.add("192.168.1.10"));
+        REQUIRE(set.add("::1"));
+        REQUIRE(set.size() == 2);
+
+        REQUIRE(set.contains(address("192.168.1.10")));
+        REQUIRE_FALSE(set.contains(address("192.168.1.11")));
+        REQUIRE(set.contains(address("::1")));
+        REQUIRE_FALSE(set.contains(address("::2")));
+    }
+
+    SECTION("IPv4 ranges") {
+        prefix_set set;
+        REQUIRE(set.add("10.0.0.0/8"));
+        REQUIRE(set.add("192.168.4.0/22"));
+
+        REQUIRE(set.contains(address("10.0.0.0")));
+        REQUIRE(set.contains(address("10.255.255.255")));
+        REQUIRE_FALSE(set.contains(address("11.0.0.0")));
+        REQUIRE(set.contains(address("192.168.4.1")));
+        REQUIRE(set.contains(address("192.168.7.255")));
+        REQUIRE_FALSE(set.contains(address("192.168.8.0")));
+        REQUIRE_FALSE(set.contains(address("192.168.3.255")));
+    }
+
+    SECTION("IPv6 ranges") {
+        prefix_set set;
+        REQUIRE(set.add("2001:db8::/32"));
+
+        REQUIRE(set.contains(address("2001:db8::1")));
+        REQUIRE(set.contains(address("2001:db8:ffff::1")));
+        REQUIRE_FALSE(set.contains(address("2001:db9::1")));
+    }
+
+    SECTION("IPv4 entries match IPv4-mapped IPv6 addresses") {
+        prefix_set set;
+        REQUIRE(set.add("127.0.0.0/8"));
+
+        REQUIRE(set.contains(address("::ffff:127.0.0.1")));
+        REQUIRE_FALSE(set.contains(address("::127.0.0.1")));
+    }
+
+    SECTION("Zero length prefixes match every address of their family") {
+        prefix_set v4;
+        REQUIRE(v4.add("0.0.0.0/0"));
+        REQUIRE(v4.contains(address("8.8.8.8")));
+        REQUIRE_FALSE(v4.contains(address("2001:db8::1")));
+
+        prefix_set any;
+        REQUIRE(any.add("::/0"));
+        REQUIRE(any.contains(address("8.8.8.8")));
+        REQUIRE(any.contains(address("2001:db8::1")));
+    }
+
+    SECTION("Nested ranges") {
+        prefix_set set;
+        REQUIRE(set.add("10.1.2.3"));
+        REQUIRE(set.add("10.0.0.0/8"));
+        REQUIRE(set.add("10.1.0.0/16"));
+
+        REQUIRE(set.contains(address("10.1.2.3")));
+        REQUIRE(set.contains(address("10.2.0.0")));
+        REQUIRE(set.contains(address("10.1.9.9")));
+    }
+
+    SECTION("Invalid ranges are refused") {
+        prefix_set set;
+        REQUIRE_FALSE(set.add("not an address"));
+        REQUIRE_FALSE(set.add("10.0.0.0/33"));
+        REQUIRE_FALSE(set.add("::/129"));
+        REQUIRE_FALSE(set.add("10.0.0.0/"));
+        REQUIRE_FALSE(set.add("10.0.0.0/8a"));
+        REQUIRE(set.empty());
+    }
+
+    SECTION("Thousands of ranges") {
+        prefix_set set;
+        for (int i = 0; i < 4096; ++i) {
+            REQUIRE(set.add("10." + std::to_string(i / 16) + "." + std::to_string((i % 16) * 16) + ".0/20"));
+        }
+        REQUIRE(set.size() == 4096);
+        REQUIRE(set.contains(address("10.200.32.7")));
+        REQUIRE_FALSE(set.contains(address("11.0.0.1")));
+    }
+}
+
+TEST_CASE("Remote filter", "[remote_filter][unit]") {
+
+    SECTION("Without lists everything is allowed") {
+        remote_filter filter;
+        REQUIRE(filter.empty());
+        REQUIRE(filter.is_allowed(address("8.8.8.8")));
+        REQUIRE(filter.is_allowed(address("::1")));
+    }
+
+    SECTION("Forbidden ranges") {
+        remote_filter filter({}, {"10.0.0.0/8"});
+        REQUIRE_FALSE(filter.empty());
+        REQUIRE_FALSE(filter.is_allowed(address("10.1.1.1")));
+        REQUIRE(filter.is_allowed(address("192.168.1.1")));
+    }
+
+    SECTION("Allowed ranges") {
+        remote_filter filter({"192.168.0.0/16", "fd00::/8"}, {});
+        REQUIRE(filter.is_allowed(address("192.168.10.1")));
+        REQUIRE(filter.is_allowed(address("fd12::1")));
+        REQUIRE_FALSE(filter.is_allowed(address("10.0.0.1")));
+    }
+
+    SECTION("Forbidden ranges take precedence") {
+        remote_filter filter({"10.0.0.0/8"}, {"10.0.0.13"});
+        REQUIRE(filter.is_allowed(address("10.0.0.12")));
+        REQUIRE_FALSE(filter.is_allowed(address("10.0.0.13")));
+    }
+
+    SECTION("An allow list without valid entries allows nothing") {
+        remote_filter filter({"invalid"}, {});
+        REQUIRE_FALSE(filter.empty());
+        REQUIRE_FALSE(filter.is_allowed(address("127.0.0.1")));
+    }
+}
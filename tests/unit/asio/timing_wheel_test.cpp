@@ -0,0 +1,238 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/asio/timing_wheel.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace thinger::asio;
+using namespace std::chrono_literals;
+
+namespace {
+
+    // run the io_context until it has no more work or the deadline is reached
+    void run_for(boost::asio::io_context& io, std::chrono::milliseconds duration) {
+        io.restart();
+        io.run_for(duration);
+    }
+
+}
+
+TEST_CASE("Timing wheel fires idle timers", "[asio][timing_wheel]") {
+    boost::asio::io_context io;
+
+    SECTION("Expires after the timeout, not before") {
+        wheel_timer timer(io);
+        bool fired = false;
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration elapsed{};
+        timer.start(500ms, [&] {
+            fired = true;
+            elapsed = std::chrono::steady_clock::now() - start;
+        });
+        REQUIRE(timer.is_armed());
+
+        run_for(io, 2s);
+        REQUIRE(fired);
+        REQUIRE_FALSE(timer.is_armed());
+        REQUIRE(elapsed >= 500ms);
+        REQUIRE(elapsed < 500ms + 2 * timing_wheel::TICK);
+    }
+
+    SECTION("Activity postpones the expiration") {
+        wheel_timer timer(io);
+        bool fired = false;
+        timer.start(500ms, [&] { fired = true; });
+
+        // touch every 200ms for a second: longer than the timeout
+        boost::asio::steady_timer activity(io);
+        int touches = 0;
+        std::function<void()> schedule = [&] {
+            activity.expires_after(200ms);
+            activity.async_wait([&](const boost::system::error_code& ec) {
+                if (ec || ++touches == 5) return;
+                timer.touch();
+                schedule();
+            });
+        };
+        schedule();
+
+        run_for(io, 1000ms);
+        REQUIRE_FALSE(fired);
+
+        run_for(io, 2s);
+        REQUIRE(fired);
+    }
+
+    SECTION("Cancelled timers never fire") {
+        wheel_timer timer(io);
+        bool fired = false;
+        timer.start(250ms, [&] { fired = true; });
+        timer.cancel();
+        REQUIRE_FALSE(timer.is_armed());
+        REQUIRE(timing_wheel::get(io).size() == 0);
+
+        run_for(io, 1s);
+        REQUIRE_FALSE(fired);
+    }
+
+    SECTION("Destroyed timers are unlinked") {
+        bool fired = false;
+        {
+            wheel_timer timer(io);
+            timer.start(250ms, [&] { fired = true; });
+            REQUIRE(timing_wheel::get(io).size() == 1);
+        }
+        REQUIRE(timing_wheel::get(io).size() == 0);
+        run_for(io, 1s);
+        REQUIRE_FALSE(fired);
+    }
+
+    SECTION("Handlers may re-arm their timer or destroy other timers") {
+        wheel_timer rearmed(io);
+        auto victim = std::make_unique<wheel_timer>(io);
+        int count = 0;
+        bool victim_fired = false;
+
+        // both share a deadline, so the first handler runs while the other one is pending
+        std::function<void()> handler = [&] {
+            victim.reset();
+            if (++count < 3) rearmed.start(250ms, handler);
+        };
+        rearmed.start(250ms, handler);
+        victim->start(250ms, [&] { victim_fired = true; });
+
+        run_for(io, 3s);
+        REQUIRE(count == 3);
+        REQUIRE_FALSE(victim_fired);
+        REQUIRE(timing_wheel::get(io).size() == 0);
+    }
+
+    SECTION("Timeouts longer than a lap of the wheel") {
+        wheel_timer timer(io);
+        timer.start(timing_wheel::TICK * (timing_wheel::SLOTS + 10), [] {});
+        // the timer is kept across laps: it only leaves the wheel when it expires
+        run_for(io, 500ms);
+        REQUIRE(timer.is_armed());
+        REQUIRE(timing_wheel::get(io).size() == 1);
+    }
+
+    SECTION("The wheel stops ticking once empty") {
+        {
+            wheel_timer timer(io);
+            timer.start(250ms, [] {});
+            run_for(io, 2s);
+        }
+        // no pending work: run() returns straight away
+        auto start = std::chrono::steady_clock::now();
+        io.restart();
+        io.run();
+        REQUIRE(std::chrono::steady_clock::now() - start < timing_wheel::TICK * 2);
+    }
+}
+
+TEST_CASE("Timing wheel is shared per io_context", "[asio][timing_wheel]") {
+    boost::asio::io_context io1;
+    boost::asio::io_context io2;
+
+    REQUIRE(&timing_wheel::get(io1) == &timing_wheel::get(io1));
+    REQUIRE(&timing_wheel::get(io1) != &timing_wheel::get(io2));
+
+    std::vector<std::unique_ptr<wheel_timer>> timers;
+    for (int i = 0; i < 100; ++i) {
+        timers.push_back(std::make_unique<wheel_timer>(io1));
+        timers.back()->start(10s, [] {});
+    }
+    REQUIRE(timing_wheel::get(io1).size() == 100);
+    REQUIRE(timing_wheel::get(io2).size() == 0);
+}
+
+TEST_CASE("Timing wheel outlived by its timers", "[asio][timing_wheel]") {
+    auto timer = [] {
+        auto io = std::make_unique<boost::asio::io_context>();
+        auto timer = std::make_unique<wheel_timer>(*io);
+        timer->start(10s, [] {});
+        return timer;   // io_context destroyed here, detaching the timer
+    }();
+    REQUIRE_FALSE(timer->is_armed());
+}
+
+TEST_CASE("Timing wheel releases the handlers of detached timers", "[asio][timing_wheel]") {
+    // like a connection keeping itself alive from its own idle timeout
+    struct owner : std::enable_shared_from_this<owner> {
+        explicit owner(boost::asio::io_context& io) : idle(io), other(io) {}
+        wheel_timer idle;
+        wheel_timer other;
+    };
+
+    std::vector<std::weak_ptr<owner>> owners;
+    {
+        boost::asio::io_context io;
+        for (int i = 0; i < 10; ++i) {
+            auto o = std::make_shared<owner>(io);
+            o->idle.start(10s, [self = o->shared_from_this()] {});
+            o->other.start(20s, [self = o->shared_from_this()] {});
+            owners.push_back(o);
+        }
+        REQUIRE(timing_wheel::get(io).size() == 20);
+    }
+
+    for (const auto& o : owners) {
+        REQUIRE(o.expired());
+    }
+}
+
+TEST_CASE("Timing wheel timers can be destroyed from other threads", "[asio][timing_wheel]") {
+    boost::asio::io_context io;
+    auto work = boost::asio::make_work_guard(io);
+    std::thread runner([&] { io.run(); });
+
+    // the io_context thread keeps linking and unlinking timers in the same slots
+    std::vector<std::unique_ptr<wheel_timer>> local;
+    for (int i = 0; i < 100; ++i) {
+        local.push_back(std::make_unique<wheel_timer>(io));
+    }
+    std::atomic<bool> stop{false};
+    std::promise<size_t> armed_at_stop;
+    std::function<void()> churn = [&] {
+        if (stop) {
+            armed_at_stop.set_value(timing_wheel::get(io).size());
+            for (auto& timer : local) timer->cancel();
+            return;
+        }
+        for (auto& timer : local) timer->start(10s, [] {});
+        boost::asio::post(io, churn);
+    };
+    boost::asio::post(io, churn);
+
+    for (int round = 0; round < 20; ++round) {
+        // armed on the io_context thread, as connections do
+        std::vector<std::unique_ptr<wheel_timer>> foreign;
+        for (int i = 0; i < 2000; ++i) {
+            foreign.push_back(std::make_unique<wheel_timer>(io));
+        }
+        std::promise<void> armed;
+        boost::asio::post(io, [&] {
+            for (auto& timer : foreign) timer->start(10s, [] {});
+            armed.set_value();
+        });
+        armed.get_future().wait();
+
+        // like the last reference to a connection released by another thread
+        foreign.clear();
+    }
+
+    stop = true;
+    auto armed = armed_at_stop.get_future().get();
+    work.reset();
+    runner.join();
+
+    REQUIRE(armed == local.size());
+    REQUIRE(timing_wheel::get(io).size() == 0);
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <thinger/asio/workers.hpp>
+#include <thinger/asio/sockets/tcp_socket.hpp>
+#include <future>
+#include <map>
 #include <thread>
 #include <chrono>
 
@@ -43,4 +46,155 @@ TEST_CASE("Workers initialization", "[asio][workers]") {
         
         test_workers.stop();
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Workers io_context selection", "[asio][workers]") {
+    SECTION("Least connections selects the io_context with fewer sockets") {
+        thinger::asio::workers test_workers;
+        test_workers.set_io_context_selection(thinger::asio::io_context_selection::least_connections);
+        test_workers.start(2);
+
+        auto contexts = test_workers.get_io_contexts();
+        REQUIRE(contexts.size() == 2);
+
+        // load the first io_context with open sockets
+        std::vector<std::unique_ptr<thinger::asio::tcp_socket>> sockets;
+        for (int i = 0; i < 3; ++i) {
+            sockets.emplace_back(std::make_unique<thinger::asio::tcp_socket>("test", contexts[0].get()));
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(&test_workers.get_next_io_context() == &contexts[1].get());
+        }
+
+        // with the same load, they are used in turns
+        sockets.emplace_back(std::make_unique<thinger::asio::tcp_socket>("test", contexts[1].get()));
+        sockets.emplace_back(std::make_unique<thinger::asio::tcp_socket>("test", contexts[1].get()));
+        sockets.emplace_back(std::make_unique<thinger::asio::tcp_socket>("test", contexts[1].get()));
+        auto& first = test_workers.get_next_io_context();
+        auto& second = test_workers.get_next_io_context();
+        REQUIRE(&first != &second);
+
+        sockets.clear();
+        test_workers.stop();
+    }
+
+    SECTION("Round robin is safe from several threads") {
+        thinger::asio::workers test_workers;
+        test_workers.start(4);
+
+        auto contexts = test_workers.get_io_contexts();
+        std::vector<std::map<boost::asio::io_context*, size_t>> counts(4);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < counts.size(); ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 1000; ++i) ++counts[t][&test_workers.get_next_io_context()];
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        std::map<boost::asio::io_context*, size_t> total;
+        for (auto& count : counts) {
+            for (auto& [context, n] : count) total[context] += n;
+        }
+        REQUIRE(total.size() == 4);
+        for (auto& context : contexts) {
+            REQUIRE(total[&context.get()] == 1000);
+        }
+
+        test_workers.stop();
+    }
+
+#ifdef __linux__
+    SECTION("Worker threads can be pinned to cpus") {
+        thinger::asio::workers test_workers;
+        test_workers.set_cpu_affinity(true, {0});
+        test_workers.start(2);
+
+        std::promise<int> cpu;
+        boost::asio::post(test_workers.get_next_io_context(), [&cpu] { cpu.set_value(sched_getcpu()); });
+        REQUIRE(cpu.get_future().get() == 0);
+
+        test_workers.stop();
+    }
+#endif
+}
+
+TEST_CASE("Workers loop monitor", "[asio][workers]") {
+    std::mutex mutex;
+    std::vector<thinger::asio::blocked_handler> reports;
+
+    thinger::asio::workers test_workers;
+    test_workers.enable_loop_monitor(std::chrono::milliseconds(10), std::chrono::milliseconds(50),
+        [&](const thinger::asio::blocked_handler& blocked) {
+            std::scoped_lock lock(mutex);
+            reports.push_back(blocked);
+        });
+    REQUIRE(test_workers.start(1));
+    auto& io_context = test_workers.get_next_io_context();
+
+    auto run_and_wait = [&](std::function<void()> handler) {
+        std::promise<void> done;
+        boost::asio::post(io_context, [&] { handler(); done.set_value(); });
+        done.get_future().wait();
+    };
+
+    SECTION("Marked handlers blocking the loop are reported") {
+        run_and_wait([] {
+            thinger::asio::handler_scope scope("/slow/:id");
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::scoped_lock lock(mutex);
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].marker == "/slow/:id");
+        REQUIRE(reports[0].thread == "worker thread 1");
+        REQUIRE(reports[0].blocked >= std::chrono::milliseconds(50));
+    }
+
+    SECTION("Unmarked handlers blocking the loop are reported without marker") {
+        run_and_wait([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::scoped_lock lock(mutex);
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].marker.empty());
+    }
+
+    SECTION("Short handlers are not reported") {
+        for (int i = 0; i < 10; ++i) {
+            run_and_wait([] {
+                thinger::asio::handler_scope scope("/fast");
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::scoped_lock lock(mutex);
+        REQUIRE(reports.empty());
+    }
+
+    SECTION("Lag and queue depth are measured") {
+        run_and_wait([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        });
+        // bursts of queued handlers while probes are pending
+        for (int round = 0; round < 10; ++round) {
+            run_and_wait([&] {
+                for (int i = 0; i < 200; ++i) boost::asio::post(io_context, [] {});
+                std::this_thread::sleep_for(std::chrono::milliseconds(15));
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        auto stats = test_workers.get_loop_stats();
+        REQUIRE(stats.size() == 1);
+        REQUIRE(stats[0].max_lag >= std::chrono::milliseconds(50));
+        REQUIRE(stats[0].max_queue_depth > 0);
+        REQUIRE(stats[0].handlers > 2000);
+    }
+
+    test_workers.stop();
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/client/response_factory.hpp>
+#include <thinger/http/common/http_response.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace thinger::http;
+
+namespace {
+
+    // feed raw in pieces of at most step bytes, as successive socket reads would
+    boost::tribool parse_in_steps(response_factory& parser, const std::string& raw, size_t step) {
+        auto* it = reinterpret_cast<const uint8_t*>(raw.data());
+        auto* end = it + raw.size();
+        boost::tribool result = boost::indeterminate;
+        while (boost::indeterminate(result) && it != end) {
+            auto* chunk_end = std::min(it + step, end);
+            result = parser.parse(it, chunk_end);
+            it = chunk_end;
+        }
+        return result;
+    }
+
+    std::string make_body(size_t size) {
+        std::string body(size, '\0');
+        for (size_t i = 0; i < size; ++i) body[i] = static_cast<char>('a' + i % 26);
+        return body;
+    }
+
+    std::string chunked(const std::string& body, size_t chunk_size) {
+        static const char* hex = "0123456789abcdef";
+        std::string out;
+        for (size_t pos = 0; pos < body.size(); pos += chunk_size) {
+            size_t n = std::min(chunk_size, body.size() - pos);
+            std::string size;
+            for (size_t v = n; v > 0; v >>= 4) size.insert(size.begin(), hex[v & 0xF]);
+            out += size + "\r\n" + body.substr(pos, n) + "\r\n";
+        }
+        return out + "0\r\n\r\n";
+    }
+}
+
+TEST_CASE("Response factory reads length delimited bodies", "[response_factory][unit]") {
+    auto body = make_body(200000);
+    std::string raw =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "\r\n" + body;
+
+    for (size_t step : {size_t{1}, size_t{7}, size_t{4096}, raw.size()}) {
+        DYNAMIC_SECTION("Read size " << step) {
+            response_factory parser;
+            REQUIRE(bool(parse_in_steps(parser, raw, step)) == true);
+            auto response = parser.consume_response();
+            REQUIRE(response->get_status_code() == 200);
+            REQUIRE(response->get_content() == body);
+            REQUIRE(response->get_content().capacity() >= body.size());
+        }
+    }
+}
+
+TEST_CASE("Response factory reads chunked bodies", "[response_factory][unit]") {
+    auto body = make_body(50000);
+    std::string raw =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n" + chunked(body, 3000);
+
+    for (size_t step : {size_t{1}, size_t{13}, size_t{4096}, raw.size()}) {
+        DYNAMIC_SECTION("Read size " << step) {
+            response_factory parser;
+            REQUIRE(bool(parse_in_steps(parser, raw, step)) == true);
+            REQUIRE(parser.consume_response()->get_content() == body);
+        }
+    }
+}
+
+TEST_CASE("Response factory rejects malformed chunk framing", "[response_factory][unit]") {
+    response_factory parser;
+    std::string raw =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nhelloX\r\n0\r\n\r\n";
+    REQUIRE(bool(!parse_in_steps(parser, raw, raw.size())));
+}
+
+TEST_CASE("Response factory streams bodies without buffering", "[response_factory][unit]") {
+    auto body = make_body(30000);
+
+    SECTION("Length delimited") {
+        std::string raw =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n" + body;
+
+        response_factory parser;
+        std::string received;
+        size_t last_total = 0;
+        parser.setOnStreaming([&](const std::string_view& data, size_t downloaded, size_t total) {
+            received.append(data);
+            REQUIRE(downloaded == received.size());
+            last_total = total;
+            return true;
+        });
+        REQUIRE(bool(parse_in_steps(parser, raw, 1000)) == true);
+        REQUIRE(received == body);
+        REQUIRE(last_total == body.size());
+        REQUIRE(parser.consume_response()->get_content().empty());
+    }
+
+    SECTION("Chunked") {
+        std::string raw =
+            "HTTP/1.1 200 OK\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n" + chunked(body, 4000);
+
+        response_factory parser;
+        std::vector<size_t> pieces;
+        std::string received;
+        parser.setOnStreaming([&](const std::string_view& data, size_t, size_t total) {
+            REQUIRE(total == 0);
+            pieces.push_back(data.size());
+            received.append(data);
+            return true;
+        });
+        REQUIRE(bool(parse_in_steps(parser, raw, 1000)) == true);
+        REQUIRE(received == body);
+        // handed over once per chunk
+        REQUIRE(pieces.size() == (body.size() + 3999) / 4000);
+    }
+
+    SECTION("Abort") {
+        std::string raw =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n" + body;
+
+        response_factory parser;
+        parser.setOnStreaming([](const std::string_view&, size_t, size_t) { return false; });
+        REQUIRE(bool(!parse_in_steps(parser, raw, 1000)));
+    }
+}
+
+TEST_CASE("Response factory enforces the maximum content size", "[response_factory][unit]") {
+    response_factory parser;
+    parser.set_max_content_size(1024);
+    std::string raw =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 4096\r\n"
+        "\r\n";
+    REQUIRE(bool(!parse_in_steps(parser, raw, raw.size())));
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <thinger/http.hpp>
 #include <sstream>
+#include <algorithm>
 
 TEST_CASE("HTTP Headers operations", "[http][headers]") {
     // Use http_request as a concrete implementation of http_headers
@@ -331,4 +332,192 @@ TEST_CASE("Headers log does not crash", "[http][headers]") {
     h.add_header("Host", "example.com");
     h.add_proxy("X-Forwarded-For", "10.0.0.1");
     REQUIRE_NOTHROW(h.log("test", 0));
-}
\ No newline at end of file
+}
+// ============================================================================
+// storage
+// ============================================================================
+
+TEST_CASE("Headers keep their own copy of application values", "[http][headers]") {
+    thinger::http::http_request h;
+
+    std::string value(300, 'v');
+    h.add_header("X-Large", value);
+    for (int i = 0; i < 50; ++i) {
+        h.add_header("X-Header-" + std::to_string(i), "value-" + std::to_string(i));
+    }
+    value.assign(300, 'x');
+
+    REQUIRE(h.get_header("X-Large") == std::string(300, 'v'));
+    REQUIRE(h.get_header("X-Header-49") == "value-49");
+}
+
+TEST_CASE("Headers reference a pinned buffer until unpinned", "[http][headers]") {
+    auto buffer = std::make_shared<std::string>("X-Token: abcdef");
+    std::string_view data(*buffer);
+
+    thinger::http::http_request h;
+    h.pin_buffer(buffer, data);
+    REQUIRE(h.is_pinned());
+
+    h.process_header(data.substr(0, 7), data.substr(9));
+    REQUIRE(h.get_header("X-Token") == "abcdef");
+    REQUIRE(h.get_header("X-Token").data() == buffer->data() + 9);
+    REQUIRE(buffer.use_count() == 2);
+
+    SECTION("Values outside the pinned buffer are copied") {
+        std::string other = "external";
+        h.process_header("X-Other", other);
+        REQUIRE(h.get_header("X-Other").data() != other.data());
+    }
+
+    SECTION("Unpin copies the referenced values and releases the buffer") {
+        h.unpin_buffer();
+        REQUIRE_FALSE(h.is_pinned());
+        REQUIRE(buffer.use_count() == 1);
+        buffer->assign(buffer->size(), '?');
+        REQUIRE(h.get_header("X-Token") == "abcdef");
+    }
+
+    SECTION("Copies own their values and do not pin the buffer") {
+        h.add_header("X-Set", "value");
+        thinger::http::http_request copy(h);
+        REQUIRE_FALSE(copy.is_pinned());
+        REQUIRE(buffer.use_count() == 2);
+
+        h.unpin_buffer();
+        buffer->assign(buffer->size(), '?');
+        h.set_header("X-Set", "changed");
+
+        REQUIRE(copy.get_header("X-Token") == "abcdef");
+        REQUIRE(copy.get_header("X-Set") == "value");
+    }
+}
+
+TEST_CASE("Headers can be copied", "[http][headers]") {
+    thinger::http::http_response original;
+    original.set_status(thinger::http::http_response::status::created);
+    original.add_header("Content-Type", "application/json");
+    original.add_header("X-Custom", "custom");
+    original.set_keep_alive(false);
+
+    SECTION("Copy construction") {
+        auto copy = original;
+        original.set_header("Content-Type", "text/plain");
+        original.remove_header("X-Custom");
+
+        REQUIRE(copy.get_status() == thinger::http::http_response::status::created);
+        REQUIRE(copy.get_header(thinger::http::header_id::content_type) == "application/json");
+        REQUIRE(copy.get_header("X-Custom") == "custom");
+        REQUIRE_FALSE(copy.keep_alive());
+        REQUIRE(copy.get_headers().size() == 3);
+    }
+
+    SECTION("Copy assignment replaces every header") {
+        thinger::http::http_response other;
+        other.add_header("X-Other", "other");
+        other = original;
+        original.set_header("X-Custom", "changed");
+
+        REQUIRE_FALSE(other.has_header("X-Other"));
+        REQUIRE(other.get_header("X-Custom") == "custom");
+        REQUIRE(other.get_header("Content-Type") == "application/json");
+
+        const auto& same = other;
+        other = same;
+        REQUIRE(other.get_header("X-Custom") == "custom");
+    }
+}
+
+TEST_CASE("Headers replaced with a view of their own value", "[http][headers]") {
+    thinger::http::http_request h;
+    h.add_header("X-Value", "a value longer than the small string buffer");
+
+    h.set_header("X-Value", h.get_header("X-Value"));
+    REQUIRE(h.get_header("X-Value") == "a value longer than the small string buffer");
+
+    h.set_header("X-Value", h.get_header("X-Value").substr(2, 5));
+    REQUIRE(h.get_header("X-Value") == "value");
+
+    for (int i = 0; i < 1000; ++i) {
+        h.set_header("X-Value", std::to_string(i));
+    }
+    REQUIRE(h.get_header("X-Value") == "999");
+    REQUIRE(h.get_headers().size() == 1);
+}
+
+// ============================================================================
+// well-known header ids
+// ============================================================================
+
+TEST_CASE("Header id lookup", "[http][headers]") {
+    using thinger::http::header_id;
+    namespace ids = thinger::http::header_ids;
+
+    SECTION("Every well-known name maps to its id in any case") {
+        for (size_t i = 0; i < ids::count; ++i) {
+            auto id = static_cast<header_id>(i);
+            std::string name(ids::name(id));
+            REQUIRE(ids::lookup(name) == id);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            REQUIRE(ids::lookup(name) == id);
+            std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+            REQUIRE(ids::lookup(name) == id);
+        }
+    }
+
+    SECTION("Unknown names") {
+        REQUIRE(ids::lookup("") == header_id::unknown);
+        REQUIRE(ids::lookup("X-Custom") == header_id::unknown);
+        REQUIRE(ids::lookup("Content-Lengths") == header_id::unknown);
+        REQUIRE(ids::lookup("Hostt") == header_id::unknown);
+    }
+}
+
+TEST_CASE("Headers indexed by id", "[http][headers]") {
+    using thinger::http::header_id;
+    thinger::http::http_request h;
+
+    h.add_header("X-Custom", "custom");
+    h.add_header("content-type", "application/json");
+    h.add_header("Accept", "text/html");
+    h.add_header("Accept", "application/json");
+
+    SECTION("Typed and string lookups agree") {
+        REQUIRE(h.has_header(header_id::content_type));
+        REQUIRE(h.get_header(header_id::content_type) == "application/json");
+        REQUIRE(h.get_header("Content-Type") == "application/json");
+        REQUIRE(h.get_header("X-Custom") == "custom");
+        REQUIRE_FALSE(h.has_header(header_id::authorization));
+        REQUIRE(h.get_header(header_id::authorization).empty());
+    }
+
+    SECTION("First value wins for repeated headers") {
+        REQUIRE(h.get_header(header_id::accept) == "text/html");
+        REQUIRE(h.get_headers_with_key("accept").size() == 2);
+    }
+
+    SECTION("set_header replaces the indexed value") {
+        h.set_header("CONTENT-TYPE", "text/plain");
+        REQUIRE(h.get_header(header_id::content_type) == "text/plain");
+        REQUIRE(h.get_headers().size() == 4);
+    }
+
+    SECTION("remove_header keeps the index consistent") {
+        REQUIRE(h.remove_header("X-Custom"));
+        REQUIRE(h.get_header(header_id::content_type) == "application/json");
+        REQUIRE(h.remove_header("Accept"));
+        REQUIRE(h.get_header(header_id::accept) == "application/json");
+        REQUIRE(h.remove_header("Accept"));
+        REQUIRE_FALSE(h.has_header(header_id::accept));
+        REQUIRE(h.get_headers().size() == 1);
+    }
+
+    SECTION("Received headers update the parsed state") {
+        h.process_header("CONNECTION", "keep-alive, Upgrade");
+        h.process_header("content-length", "42");
+        REQUIRE(h.keep_alive());
+        REQUIRE(h.upgrade());
+        REQUIRE(h.get_content_length() == 42);
+        REQUIRE(h.get_header(header_id::connection) == "keep-alive, Upgrade");
+    }
+}
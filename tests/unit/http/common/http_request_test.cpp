@@ -335,4 +335,83 @@ TEST_CASE("HTTP Request URL building", "[http][request][unit]") {
         REQUIRE(has_query);
         REQUIRE(url.find("page=2") != std::string::npos);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("HTTP Request query parameters are parsed lazily", "[http][request][unit]") {
+    http_request req;
+
+    SECTION("Parameters are available on first access") {
+        req.set_uri("/search?q=hello+world&tag=a&tag=b");
+        REQUIRE(req.get_resource() == "/search");
+        REQUIRE(req.has_uri_parameter("q"));
+        REQUIRE(req.get_uri_parameter("q") == "hello world");
+        REQUIRE(req.get_uri_parameters().count("tag") == 2);
+    }
+
+    SECTION("A new uri replaces previous parameters") {
+        req.set_uri("/a?x=1");
+        REQUIRE(req.has_uri_parameter("x"));
+        req.set_uri("/b?y=2");
+        REQUIRE_FALSE(req.has_uri_parameter("x"));
+        REQUIRE(req.get_uri_parameter("y") == "2");
+    }
+
+    SECTION("Adding a parameter keeps the pending ones") {
+        req.set_uri("/items?page=1");
+        req.add_uri_parameter("limit", "10");
+        REQUIRE(req.get_uri_parameter("page") == "1");
+        REQUIRE(req.get_uri_parameter("limit") == "10");
+        REQUIRE(req.get_uri().find("page=1") != std::string::npos);
+    }
+
+    SECTION("Decoded resource and fragment") {
+        req.set_uri("/files/my%20file.txt#section");
+        REQUIRE(req.get_resource() == "/files/my file.txt");
+        REQUIRE_FALSE(req.has_query_parameters());
+    }
+}
+
+TEST_CASE("HTTP Request targets", "[http][request][unit]") {
+    http_request req;
+
+    SECTION("Paths starting with a double slash are not an authority") {
+        REQUIRE(req.set_uri("//evil/admin/x?a=1"));
+        REQUIRE(req.get_resource() == "//evil/admin/x");
+        REQUIRE(req.get_uri() == "//evil/admin/x?a=1");
+        REQUIRE(req.get_uri_parameter("a") == "1");
+        REQUIRE(req.get_host().empty());
+    }
+
+    SECTION("Absolute targets use their path") {
+        REQUIRE(req.set_uri("http://localhost:8080/api/items?page=2"));
+        REQUIRE(req.get_resource() == "/api/items");
+        REQUIRE(req.get_uri_parameter("page") == "2");
+    }
+
+    SECTION("Malformed targets leave no resource nor query") {
+        REQUIRE(req.set_uri("/previous?x=1"));
+        REQUIRE_FALSE(req.set_uri("http://localhost:port/api?y=2"));
+        REQUIRE(req.get_resource().empty());
+        REQUIRE_FALSE(req.has_query_parameters());
+        REQUIRE_FALSE(req.has_uri_parameter("x"));
+    }
+}
+
+TEST_CASE("HTTP Request set_url validation", "[http][request][unit]") {
+    http_request req;
+
+    REQUIRE(req.set_url("HTTP://Example.com"));
+    REQUIRE(req.get_host() == "example.com");
+    REQUIRE(req.get_uri() == "/");
+
+    REQUIRE(req.set_url("wss://example.com/ws#ignored"));
+    REQUIRE(req.is_ssl());
+    REQUIRE(req.get_uri() == "/ws");
+
+    REQUIRE(req.set_url("http://example.com?x=1"));
+    REQUIRE(req.get_uri() == "/?x=1");
+
+    REQUIRE_FALSE(req.set_url("ftp://example.com/file"));
+    REQUIRE_FALSE(req.set_url("/relative/path"));
+    REQUIRE_FALSE(req.set_url("http://exa mple.com/"));
+    REQUIRE_FALSE(req.set_url("http://example.com:port/"));
+}
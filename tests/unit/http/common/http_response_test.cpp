@@ -179,6 +179,29 @@ TEST_CASE("HTTP Response serialization", "[http][response][unit]") {
         // Check body
         REQUIRE(serialized.find("\r\n\r\nHello") != std::string::npos);
     }
+
+    SECTION("Finalized buffer generation") {
+        std::vector<boost::asio::const_buffer> gathered;
+        res.to_buffer(gathered);
+
+        res.finalize();
+        std::vector<boost::asio::const_buffer> buffers;
+        res.to_buffer(buffers);
+
+        // Status line and headers in a single block, followed by the body
+        REQUIRE(buffers.size() == 2);
+
+        std::string expected;
+        for (const auto& buffer : gathered) {
+            expected.append(static_cast<const char*>(buffer.data()), buffer.size());
+        }
+        std::string serialized;
+        for (const auto& buffer : buffers) {
+            serialized.append(static_cast<const char*>(buffer.data()), buffer.size());
+        }
+        REQUIRE(serialized == expected);
+        REQUIRE(std::string(static_cast<const char*>(buffers[1].data()), buffers[1].size()) == "Hello");
+    }
     
     SECTION("Size calculation") {
         // get_size() returns the size of the content/payload
@@ -382,4 +405,105 @@ TEST_CASE("HTTP Response log", "[http][response][unit]") {
         res.add_proxy("X-Forwarded-For", "10.0.0.1");
         REQUIRE_NOTHROW(res.log("test", 0));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("HTTP Response preamble", "[http][response][unit]") {
+
+    auto serialize = [](const http_response& res) {
+        std::vector<boost::asio::const_buffer> buffers;
+        res.to_buffer(buffers);
+        std::string serialized;
+        for (const auto& buffer : buffers) {
+            serialized.append(static_cast<const char*>(buffer.data()), buffer.size());
+        }
+        return serialized;
+    };
+
+    SECTION("Keep-alive preamble") {
+        http_response res;
+        res.set_content("Hello", "text/plain");
+        res.use_preamble(true, false);
+        auto serialized = serialize(res);
+        REQUIRE(serialized.find("HTTP/1.1 200 OK\r\nConnection: Keep-Alive\r\n") == 0);
+        REQUIRE(serialized.find("Content-Type: text/plain\r\n") != std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Origin") == std::string::npos);
+        REQUIRE(serialized.substr(serialized.size() - 9) == "\r\n\r\nHello");
+    }
+
+    SECTION("Close preamble") {
+        http_response res;
+        res.set_status(http_response::status::not_found);
+        res.use_preamble(false, false);
+        REQUIRE(serialize(res).find("HTTP/1.1 404 Not Found\r\nConnection: Close\r\n") == 0);
+    }
+
+    SECTION("CORS preamble") {
+        http_response res;
+        res.use_preamble(true, true);
+        auto serialized = serialize(res);
+        REQUIRE(serialized.find("Access-Control-Allow-Origin: *\r\n") != std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Methods: ") != std::string::npos);
+    }
+
+    SECTION("Headers in the response replace the preamble ones") {
+        http_response res;
+        res.set_header("Connection", "upgrade");
+        res.set_header("Access-Control-Allow-Origin", "https://example.com");
+        res.use_preamble(true, true);
+        auto serialized = serialize(res);
+        REQUIRE(serialized.find("Keep-Alive") == std::string::npos);
+        REQUIRE(serialized.find("Connection: upgrade\r\n") != std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Origin: *") == std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Origin: https://example.com\r\n") != std::string::npos);
+        // the other CORS headers still come from the preamble
+        REQUIRE(serialized.find("Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS, HEAD, PATCH\r\n") != std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n") != std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Credentials: true\r\n") != std::string::npos);
+    }
+
+    SECTION("Every CORS header set in the response replaces the preamble one") {
+        http_response res;
+        res.set_header("Access-Control-Allow-Origin", "https://example.com");
+        res.set_header("Access-Control-Allow-Methods", "GET");
+        res.set_header("Access-Control-Allow-Headers", "X-Token");
+        res.set_header("Access-Control-Allow-Credentials", "false");
+        res.use_preamble(true, true);
+        auto serialized = serialize(res);
+        REQUIRE(serialized.find("Access-Control-Allow-Origin: *") == std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Methods: GET\r\n") != std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Methods: GET,") == std::string::npos);
+        REQUIRE(serialized.find("Access-Control-Allow-Credentials: true") == std::string::npos);
+    }
+
+    SECTION("Finalized responses serialize the same, as often as needed") {
+        http_response res;
+        res.set_header("Access-Control-Allow-Origin", "https://example.com");
+        res.set_content("Hello", "text/plain");
+        res.use_preamble(true, true);
+        auto expected = serialize(res);
+
+        res.finalize();
+        std::vector<boost::asio::const_buffer> first;
+        res.to_buffer(first);
+        std::vector<boost::asio::const_buffer> second;
+        res.to_buffer(second);
+
+        REQUIRE(first.size() == 2);
+        REQUIRE(first[0].data() == second[0].data());
+        REQUIRE(serialize(res) == expected);
+    }
+
+    SECTION("Matches the output without preamble") {
+        http_response with_preamble;
+        with_preamble.set_status(http_response::status::created);
+        with_preamble.set_content("{}", "application/json");
+        with_preamble.use_preamble(false, false);
+
+        http_response without_preamble;
+        without_preamble.set_status(http_response::status::created);
+        without_preamble.set_header("Connection", "Close");
+        without_preamble.set_content("{}", "application/json");
+
+        REQUIRE(serialize(with_preamble) == serialize(without_preamble));
+    }
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/server/middleware.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+using namespace thinger::http;
+
+namespace {
+
+    std::shared_ptr<request> make_request(const std::string& uri) {
+        auto http_req = std::make_shared<http_request>();
+        http_req->set_method(method::GET);
+        http_req->set_uri(uri);
+        return std::make_shared<request>(nullptr, nullptr, http_req);
+    }
+
+    // Run the chains in a coroutine, returning whether the request went through them
+    bool run_async(const middleware_chain& server, const middleware_chain* route, request& req, response& res) {
+        boost::asio::io_context io;
+        bool passed = false;
+        boost::asio::co_spawn(io, [&]() -> thinger::awaitable<void> {
+            passed = co_await middleware_chain::run_async(server, route, req, res);
+        }, boost::asio::detached);
+        io.run();
+        return passed;
+    }
+
+}
+
+TEST_CASE("Middleware chain", "[middleware][unit]") {
+    auto req = make_request("/api/users");
+    response res(nullptr, nullptr, req->get_http_request());
+    std::vector<std::string> calls;
+
+    SECTION("Synchronous middlewares run in order") {
+        middleware_chain chain;
+        chain.add([&](request&, response&, std::function<void()> next) { calls.push_back("first"); next(); });
+        chain.add([&](request&, response&, std::function<void()> next) { calls.push_back("second"); next(); });
+
+        REQUIRE_FALSE(chain.is_awaitable());
+        REQUIRE(middleware_chain::run(chain, nullptr, *req, res));
+        REQUIRE(calls == std::vector<std::string>{"first", "second"});
+    }
+
+    SECTION("A middleware not calling next stops the chain") {
+        middleware_chain chain;
+        chain.add([&](request&, response& res, std::function<void()>) {
+            calls.push_back("blocker");
+            res.error(http_response::status::forbidden, "Forbidden");
+        });
+        chain.add([&](request&, response&, std::function<void()> next) { calls.push_back("never"); next(); });
+
+        REQUIRE_FALSE(middleware_chain::run(chain, nullptr, *req, res));
+        REQUIRE(calls == std::vector<std::string>{"blocker"});
+        REQUIRE(res.has_responded());
+    }
+
+    SECTION("Prefixed middlewares only run for matching requests") {
+        middleware_chain chain;
+        chain.add([&](request&, response&, std::function<void()> next) { calls.push_back("api"); next(); }, "/api");
+        chain.add([&](request&, response&, std::function<void()>) { calls.push_back("admin"); }, "/admin");
+
+        REQUIRE(middleware_chain::run(chain, nullptr, *req, res));
+        REQUIRE(calls == std::vector<std::string>{"api"});
+    }
+
+    SECTION("Route middlewares run after the server ones") {
+        middleware_chain server;
+        middleware_chain route;
+        server.add([&](request&, response&, std::function<void()> next) { calls.push_back("server"); next(); });
+        route.add([&](request&, response&, std::function<void()> next) { calls.push_back("route"); next(); });
+
+        REQUIRE(middleware_chain::run(server, &route, *req, res));
+        REQUIRE(calls == std::vector<std::string>{"server", "route"});
+    }
+
+    SECTION("Awaitable middlewares resume after the rest of the chain") {
+        middleware_chain server;
+        middleware_chain route;
+        server.add([&](request&, response&, std::function<void()> next) { calls.push_back("sync"); next(); });
+        server.add(middleware_awaitable([&](request&, response&, middleware_next next) -> thinger::awaitable<void> {
+            calls.push_back("before");
+            boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            co_await next();
+            calls.push_back("after");
+        }));
+        route.add([&](request&, response&, std::function<void()> next) { calls.push_back("route"); next(); });
+
+        REQUIRE(server.is_awaitable());
+        REQUIRE(run_async(server, &route, *req, res));
+        REQUIRE(calls == std::vector<std::string>{"sync", "before", "route", "after"});
+    }
+
+    SECTION("Awaitable middlewares can stop the chain") {
+        middleware_chain chain;
+        chain.add(middleware_awaitable([&](request&, response& res, middleware_next) -> thinger::awaitable<void> {
+            calls.push_back("blocker");
+            res.error(http_response::status::unauthorized);
+            co_return;
+        }));
+        chain.add([&](request&, response&, std::function<void()> next) { calls.push_back("never"); next(); });
+
+        REQUIRE_FALSE(run_async(chain, nullptr, *req, res));
+        REQUIRE(calls == std::vector<std::string>{"blocker"});
+    }
+}
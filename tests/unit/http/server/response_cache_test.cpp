@@ -0,0 +1,259 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/server/response_cache.hpp>
+#include <boost/asio/io_context.hpp>
+#include <thread>
+
+using namespace thinger::http;
+using namespace std::chrono_literals;
+
+namespace {
+
+    std::shared_ptr<http_request> make_request(const std::string& uri, const std::string& accept_encoding = "") {
+        auto request = std::make_shared<http_request>();
+        request->set_method(method::GET);
+        request->set_uri(uri);
+        if (!accept_encoding.empty()) request->add_header("Accept-Encoding", accept_encoding);
+        return request;
+    }
+
+    std::shared_ptr<http_response> make_response(const std::string& content,
+                                                 http_response::status status = http_response::status::ok) {
+        auto response = std::make_shared<http_response>();
+        response->set_status(status);
+        response->set_content(content, "application/json");
+        response->add_header("Date", "Thu, 01 Jan 1970 00:00:00 GMT");
+        return response;
+    }
+
+    std::string serialize(const cached_response& frame) {
+        std::vector<boost::asio::const_buffer> buffers;
+        frame.to_buffer(buffers);
+        std::string data;
+        for (const auto& buffer : buffers) {
+            data.append(static_cast<const char*>(buffer.data()), buffer.size());
+        }
+        return data;
+    }
+
+}
+
+TEST_CASE("Response cache keys", "[cache][unit]") {
+    auto plain = response_cache::make_key(*make_request("/config?id=1"), {});
+
+    SECTION("Keys depend on the uri and the accepted encoding") {
+        REQUIRE(plain == response_cache::make_key(*make_request("/config?id=1"), {}));
+        REQUIRE(plain != response_cache::make_key(*make_request("/config?id=2"), {}));
+        REQUIRE(plain != response_cache::make_key(*make_request("/config?id=1", "gzip, br"), {}));
+        REQUIRE(response_cache::make_key(*make_request("/config?id=1", "gzip"), {}) ==
+                response_cache::make_key(*make_request("/config?id=1", "br, gzip"), {}));
+    }
+
+    SECTION("Keys depend on the host") {
+        auto first = make_request("/config?id=1");
+        first->add_header("Host", "a.example.com");
+        auto second = make_request("/config?id=1");
+        second->add_header("Host", "b.example.com");
+
+        REQUIRE(response_cache::make_key(*first, {}) != response_cache::make_key(*second, {}));
+        REQUIRE(response_cache::make_key(*first, {}) != plain);
+    }
+
+    SECTION("Keys depend on the vary headers") {
+        auto with_user = make_request("/config?id=1");
+        with_user->add_header("Authorization", "Bearer a");
+        auto with_other = make_request("/config?id=1");
+        with_other->add_header("Authorization", "Bearer b");
+
+        REQUIRE(response_cache::make_key(*with_user, {"Authorization"}) !=
+                response_cache::make_key(*with_other, {"Authorization"}));
+        REQUIRE(response_cache::make_key(*with_user, {}) == response_cache::make_key(*with_other, {}));
+    }
+}
+
+TEST_CASE("Response cache", "[cache][unit]") {
+    response_cache cache;
+
+    SECTION("The first miss leads and the others wait for it") {
+        auto first = cache.acquire("/a");
+        REQUIRE(first.leader);
+        REQUIRE_FALSE(first.hit);
+
+        auto second = cache.acquire("/a");
+        REQUIRE_FALSE(second.leader);
+        REQUIRE(second.miss == first.miss);
+
+        auto response = make_response("{\"value\":1}");
+        cache.complete(first.miss, response.get(), 1min);
+
+        auto third = cache.acquire("/a");
+        REQUIRE(third.hit);
+        REQUIRE(third.hit->content == "{\"value\":1}");
+        REQUIRE(cache.entries() == 1);
+    }
+
+    SECTION("Waiters are resumed with the response of the leader") {
+        boost::asio::io_context io;
+        auto leader = cache.acquire("/a");
+        auto follower = cache.acquire("/a");
+
+        std::shared_ptr<const response_cache::entry> result;
+        bool resumed = false;
+        thinger::co_spawn(io, [&]() -> thinger::awaitable<void> {
+            result = co_await cache.wait(follower.miss);
+            resumed = true;
+        }, thinger::detached);
+        io.poll();
+        REQUIRE_FALSE(resumed);
+
+        // completed from another thread, as a leader running on another worker
+        std::thread([&] {
+            auto response = make_response("shared");
+            cache.complete(leader.miss, response.get(), 1min);
+        }).join();
+        io.run();
+
+        REQUIRE(resumed);
+        REQUIRE(result);
+        REQUIRE(result->content == "shared");
+    }
+
+    SECTION("Only successful responses without cookies are cached") {
+        auto error = make_response("error", http_response::status::internal_server_error);
+        cache.complete(cache.acquire("/error").miss, error.get(), 1min);
+        REQUIRE(cache.acquire("/error").leader);
+
+        auto cookie = make_response("private");
+        cookie->add_header("Set-Cookie", "session=1");
+        cache.complete(cache.acquire("/cookie").miss, cookie.get(), 1min);
+        REQUIRE(cache.acquire("/cookie").leader);
+
+        REQUIRE(cache.entries() == 0);
+    }
+
+    SECTION("A leader without response releases its flight") {
+        auto leader = cache.acquire("/a");
+        REQUIRE_FALSE(cache.acquire("/a").leader);
+        {
+            // as the last copy of a response that was never sent
+            response_capture capture(cache, leader.miss, 1min);
+        }
+        REQUIRE(cache.acquire("/a").leader);
+    }
+
+    SECTION("Waiters stop waiting for a leader that takes too long") {
+        boost::asio::io_context io;
+        cache.set_wait_timeout(20ms);
+        auto leader = cache.acquire("/slow");
+        auto follower = cache.acquire("/slow");
+
+        std::shared_ptr<const response_cache::entry> result;
+        bool resumed = false;
+        thinger::co_spawn(io, [&]() -> thinger::awaitable<void> {
+            result = co_await cache.wait(follower.miss);
+            resumed = true;
+        }, thinger::detached);
+        io.run_for(2s);
+
+        REQUIRE(resumed);
+        REQUIRE_FALSE(result);
+        // the flight was abandoned: the next request leads, and the late leader is not cached
+        REQUIRE(cache.acquire("/slow").leader);
+        auto response = make_response("late");
+        cache.complete(leader.miss, response.get(), 1min);
+        REQUIRE_FALSE(cache.acquire("/slow").hit);
+    }
+
+    SECTION("Headers set before the handler are not cached") {
+        auto leader = cache.acquire("/a");
+        auto response = make_response("{}");
+        response->add_header("X-User", "alice");
+        response->add_header("Cache-Control", "no-store");
+        {
+            response_capture capture(cache, leader.miss, 1min);
+            capture.exclude(*response);
+            // set by the handler
+            response->set_header("Cache-Control", "max-age=5");
+            response->add_header("ETag", "\"1\"");
+            capture.store(*response);
+        }
+
+        auto hit = cache.acquire("/a").hit;
+        REQUIRE(hit);
+        REQUIRE(hit->headers.find("X-User") == std::string::npos);
+        REQUIRE(hit->headers.find("Cache-Control: max-age=5\r\n") != std::string::npos);
+        REQUIRE(hit->headers.find("ETag: \"1\"\r\n") != std::string::npos);
+    }
+
+    SECTION("Entries expire") {
+        auto response = make_response("short");
+        cache.complete(cache.acquire("/a").miss, response.get(), 1ms);
+        std::this_thread::sleep_for(5ms);
+
+        REQUIRE(cache.acquire("/a").leader);
+        REQUIRE(cache.entries() == 0);
+    }
+
+    SECTION("The least recently used entries are evicted") {
+        // every key lands on a shard holding a sixteenth of the size
+        cache.set_max_size(response_cache::SHARDS * 4096);
+        std::string content(1500, 'x');
+        for (int i = 0; i < 64; ++i) {
+            auto response = make_response(content);
+            auto key = "/item/" + std::to_string(i);
+            cache.complete(cache.acquire(key).miss, response.get(), 1min);
+            REQUIRE(cache.acquire(key).hit);
+        }
+
+        REQUIRE(cache.entries() < 64);
+        REQUIRE(cache.size() <= cache.get_max_size());
+        REQUIRE(cache.acquire("/item/63").hit);
+    }
+
+    SECTION("Responses larger than a shard are not cached") {
+        cache.set_max_size(response_cache::SHARDS * 1024);
+        auto response = make_response(std::string(2048, 'x'));
+        cache.complete(cache.acquire("/large").miss, response.get(), 1min);
+        REQUIRE(cache.entries() == 0);
+    }
+}
+
+TEST_CASE("Cached response frames", "[cache][unit]") {
+    response_cache cache;
+    auto response = make_response("{\"value\":1}");
+    response->add_header("Connection", "close");
+    cache.complete(cache.acquire("/a").miss, response.get(), 1min);
+    auto entry = cache.acquire("/a").hit;
+    REQUIRE(entry);
+
+    SECTION("Connection and Date headers are set for each request") {
+        auto data = serialize(cached_response(entry, true, false));
+        REQUIRE(data.starts_with("HTTP/1.1 200 OK\r\nConnection: Keep-Alive\r\n"));
+        REQUIRE(data.find("Date: Thu, 01 Jan 1970") == std::string::npos);
+        REQUIRE(data.find("Date: ") != std::string::npos);
+        REQUIRE(data.find("Connection: close") == std::string::npos);
+        REQUIRE(data.find("Content-Length: 11\r\n") != std::string::npos);
+        REQUIRE(data.ends_with("\r\n\r\n{\"value\":1}"));
+
+        auto closing = serialize(cached_response(entry, false, true));
+        REQUIRE(closing.find("Connection: Close\r\n") != std::string::npos);
+        REQUIRE(closing.find("Access-Control-Allow-Origin: *") != std::string::npos);
+    }
+
+    SECTION("Headers set for the request by middlewares are added") {
+        http_response request_headers;
+        request_headers.add_header("Date", "Thu, 01 Jan 1970 00:00:00 GMT");
+        request_headers.add_header("X-User", "bob");
+        request_headers.add_header("Content-Type", "text/plain");
+        request_headers.add_header("Access-Control-Allow-Origin", "https://example.com");
+
+        auto data = serialize(cached_response(entry, true, true, &request_headers));
+        REQUIRE(data.find("X-User: bob\r\n") != std::string::npos);
+        REQUIRE(data.find("Date: Thu, 01 Jan 1970") == std::string::npos);
+        // the cached response sets its own content type
+        REQUIRE(data.find("Content-Type: text/plain") == std::string::npos);
+        REQUIRE(data.find("Content-Type: application/json\r\n") != std::string::npos);
+        REQUIRE(data.find("Access-Control-Allow-Origin: https://example.com\r\n") != std::string::npos);
+        REQUIRE(data.find("Access-Control-Allow-Origin: *") == std::string::npos);
+        REQUIRE(data.find("Access-Control-Allow-Methods: ") != std::string::npos);
+    }
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/server/routing/route_handler.hpp>
+#include <thinger/http/server/request.hpp>
+#include <thinger/http/server/response.hpp>
+
+using namespace thinger::http;
+
+TEST_CASE("Route parameters", "[route][unit]") {
+
+    SECTION("Views are kept in order and looked up by name") {
+        std::string path = "/users/alice/devices/d1";
+        route_params params;
+        params.add_view("user", std::string_view(path).substr(7, 5));
+        params.add_view("device", std::string_view(path).substr(21, 2));
+
+        REQUIRE(params.size() == 2);
+        REQUIRE(params.begin()->name == "user");
+        REQUIRE(*params.find("user") == "alice");
+        REQUIRE(*params.find("device") == "d1");
+        REQUIRE(params.find("missing") == nullptr);
+        REQUIRE(params.find("user")->data() == path.data() + 7);
+    }
+
+    SECTION("Values are converted to std::string once") {
+        std::string path = "/users/alice";
+        route_params params;
+        params.add_view("user", std::string_view(path).substr(7));
+
+        auto value = params.find_string("user");
+        REQUIRE(value != nullptr);
+        REQUIRE(*value == "alice");
+        REQUIRE(params.find_string("user") == value);
+        REQUIRE(params.find_string("missing") == nullptr);
+    }
+
+    SECTION("Added parameters are copied") {
+        route_params params;
+        {
+            std::string name = "extra";
+            std::string value = "value1";
+            params.add(name, value);
+            params.add(name, "value2");
+        }
+        REQUIRE(params.count("extra") == 2);
+        REQUIRE(*params.find_string("extra") == "value1");
+
+        REQUIRE(params.erase("extra") == 2);
+        REQUIRE(params.empty());
+        REQUIRE(params.erase("extra") == 0);
+    }
+
+    SECTION("Views into a buffer can be copied before it changes") {
+        std::string path = "/users/alice";
+        std::string other = "bob";
+        route_params params;
+        params.add_view("user", std::string_view(path).substr(7));
+        params.add_view("other", other);
+
+        params.copy_values(path);
+        path.assign(path.size(), '?');
+
+        REQUIRE(*params.find("user") == "alice");
+        REQUIRE(*params.find_string("user") == "alice");
+        REQUIRE(params.find("other")->data() == other.data());
+    }
+}
+
+TEST_CASE("Request route parameters", "[route][unit]") {
+    route_handler handler;
+    handler[method::GET]["/users/:user/devices/:device"] = [](request&, response&) {};
+
+    auto http_req = std::make_shared<http_request>();
+    http_req->set_method(method::GET);
+    http_req->set_uri("/users/alice/devices/d1?verbose=1");
+    auto req = std::make_shared<request>(nullptr, nullptr, http_req);
+
+    REQUIRE(handler.find_route(req) != nullptr);
+
+    SECTION("Matched parameters point into the request uri") {
+        const auto& uri = http_req->get_uri();
+        auto& params = req->get_uri_parameters();
+        REQUIRE(params.size() == 2);
+        REQUIRE(params.find("user")->data() == uri.data() + 7);
+        REQUIRE(params.find("device")->data() == uri.data() + 21);
+
+        REQUIRE((*req)["user"] == "alice");
+        REQUIRE((*req)["device"] == "d1");
+        REQUIRE(req->has("device"));
+        REQUIRE_FALSE(req->has("verbose"));
+        REQUIRE((*req)["missing"].empty());
+    }
+
+    SECTION("Parameters can be replaced, added and erased") {
+        req->set_uri_parameter("user", "bob");
+        REQUIRE((*req)["user"] == "bob");
+        REQUIRE(req->get_uri_parameters().count("user") == 1);
+
+        req->add_uri_parameter("extra", "value1");
+        req->add_uri_parameter("extra", "value2");
+        REQUIRE(req->get_uri_parameters().count("extra") == 2);
+        REQUIRE(req->erase("extra"));
+        REQUIRE_FALSE(req->has("extra"));
+        REQUIRE_FALSE(req->erase("extra"));
+
+        REQUIRE(req->debug_parameters() == "(device:d1) (user:bob) ");
+    }
+
+    SECTION("Parameters survive a uri rewrite") {
+        // i.e., a middleware rewriting the path after the route was matched
+        http_req->set_uri("/rewritten/with/a/path/long/enough/to/reallocate/the/uri?and=query");
+        REQUIRE((*req)["user"] == "alice");
+        REQUIRE((*req)["device"] == "d1");
+        REQUIRE(req->debug_parameters() == "(user:alice) (device:d1) ");
+
+        http_req->set_uri("/again");
+        REQUIRE((*req)["user"] == "alice");
+    }
+
+    SECTION("The http request can change its uri after the request is gone") {
+        req.reset();
+        http_req->set_uri("/other");
+        REQUIRE(http_req->get_uri() == "/other");
+    }
+}
@@ -0,0 +1,203 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/server/routing/route_builder.hpp>
+#include <thinger/http/server/routing/route_tree.hpp>
+#include <optional>
+#include <random>
+
+using namespace thinger::http;
+
+namespace {
+
+    struct route_result {
+        size_t index = route_tree::npos;
+        std::vector<std::optional<std::string>> captures;
+
+        bool operator==(const route_result&) const = default;
+    };
+
+    // previous route_handler::find_route: the first route whose regex matches
+    route_result linear_find(const std::vector<route>& routes, const std::string& path) {
+        route_result result;
+        for (size_t i = 0; i < routes.size(); ++i) {
+            std::smatch matches;
+            if (!routes[i].matches(path, matches)) continue;
+            result.index = i;
+            for (size_t group = 1; group < matches.size(); ++group) {
+                if (matches[group].matched) result.captures.emplace_back(matches[group].str());
+                else result.captures.emplace_back();
+            }
+            break;
+        }
+        return result;
+    }
+
+    route_result tree_find(const route_tree& tree, const std::vector<route>& routes, const std::string& path) {
+        route_result result;
+        route_tree::match match;
+        if (tree.find(routes, path, match)) {
+            result.index = match.index;
+            for (auto capture : match.captures) {
+                if (capture.data()) result.captures.emplace_back(std::string(capture));
+                else result.captures.emplace_back();
+            }
+        }
+        return result;
+    }
+
+    struct router {
+        std::vector<route> routes;
+        route_tree tree;
+
+        explicit router(const std::vector<std::string>& patterns) {
+            route_builder builder(method::GET, routes, tree);
+            for (const auto& pattern : patterns) builder[pattern];
+        }
+
+        void require_same(const std::string& path) const {
+            INFO("path: " << path);
+            auto expected = linear_find(routes, path);
+            auto found = tree_find(tree, routes, path);
+            INFO("expected: " << (expected.index != route_tree::npos ? routes[expected.index].get_pattern() : "-"));
+            INFO("found: " << (found.index != route_tree::npos ? routes[found.index].get_pattern() : "-"));
+            REQUIRE(found.index == expected.index);
+            REQUIRE(found.captures == expected.captures);
+        }
+    };
+
+}
+
+TEST_CASE("Route tree matches like the linear regex scan", "[route][unit]") {
+
+    router r({
+        "/api/v1/users",
+        "/api/v1/users/me",
+        "/api/v1/users/:user",
+        "/api/v1/users/:user/devices",
+        "/api/v1/users/:user([a-zA-Z0-9_-]{1,32})/devices/:device",
+        "/api/v1/users/:user/devices/:device/resources/:resource",
+        "/api/v1/users/:user/devices/:device/resources/:resource/:field",
+        "/api/:version([0-9]+)/:resource([a-z]+)",
+        "/users/:id([0-9]+)",
+        "/users/:name",
+        "/users/:name/profile",
+        "/files/:path(.+)/meta",
+        "/files/:path(.+)",
+        "/f/:name.json",
+        "/f/:name-:ext",
+        "/a/:id([0-9]+)/:name",
+        "/x/:a/:b([0-9]+)",
+        "/opt/:x([a-z]*)/end",
+        "/dup/:a/:a",
+        "/uuid/:id(" UUID_PATTERN ")",
+        "/email/:address(" EMAIL_PATTERN ")",
+        "/slug/:slug(" SLUG_PATTERN ")",
+        "/lazy/:x(.+?)/:y(.+)",
+        "/alt/:x(foo|bar)",
+        "/adjacent/:a:b",
+        "/group/(x)",
+        "/static/file.txt",
+        "/static/:file",
+        "/static/file.txt",
+        ".*",
+        "/",
+        "",
+    });
+
+    // patterns the tree cannot reproduce are matched with their regex
+    REQUIRE(r.tree.regex_routes() == 9);
+
+    for (const std::string path : {
+        "", "/", "/api", "/api/v1/users", "/api/v1/users/", "/api/v1/users/me", "/api/v1/users/alice",
+        "/api/v1/users/alice/devices", "/api/v1/users/alice/devices/d1", "/api/v1/users/a.b/devices/d1",
+        "/api/v1/users/alice/devices/d1/resources/temp", "/api/v1/users/alice/devices/d1/resources/temp/value",
+        "/api/2/users", "/api/v2/users", "/api/2/Users", "/users/123", "/users/12abc", "/users/bob",
+        "/users/123/profile", "/users//profile", "/files/a", "/files/a/b/c.txt", "/files/a/b/meta", "/files/meta",
+        "/files/", "/f/data.json", "/f/data.json.json", "/f/data.xml", "/f/a-b-c", "/f/-b", "/a/12/bob",
+        "/a/x/bob", "/x/a/12", "/x/a/b", "/opt//end", "/opt/abc/end", "/opt/ABC/end", "/dup/1/2",
+        "/uuid/123e4567-e89b-12d3-a456-426614174000", "/uuid/123e4567", "/email/user@example.com",
+        "/email/user@", "/slug/hello-world", "/slug/hello", "/lazy/a/b/c", "/alt/foo", "/alt/baz",
+        "/adjacent/xy", "/adjacent/x", "/group/x", "/group/(x)", "/static/file.txt", "/static/other",
+        "/static/filextxt", ".*", "/.*", "/unknown",
+    }) {
+        r.require_same(path);
+    }
+}
+
+TEST_CASE("Route tree keeps the registration priority", "[route][unit]") {
+
+    SECTION("A parameter registered first wins over static text") {
+        router r({"/items/:id", "/items/new"});
+        route_tree::match match;
+        std::string path = "/items/new";
+        REQUIRE(r.tree.find(r.routes, path, match));
+        REQUIRE(match.index == 0);
+        REQUIRE(match.captures.size() == 1);
+        REQUIRE(match.captures[0] == "new");
+    }
+
+    SECTION("Static text registered first wins over a parameter") {
+        router r({"/items/new", "/items/:id"});
+        route_tree::match match;
+        REQUIRE(r.tree.find(r.routes, std::string("/items/new"), match));
+        REQUIRE(match.index == 0);
+        REQUIRE(match.captures.empty());
+        REQUIRE(r.tree.find(r.routes, std::string("/items/42"), match));
+        REQUIRE(match.index == 1);
+    }
+
+    SECTION("Regex routes are ordered with the tree routes") {
+        router r({"/a/:x(foo|bar)", "/a/:y", "/b/:y", "/b/:x(foo|bar)"});
+        route_tree::match match;
+        REQUIRE(r.tree.find(r.routes, std::string("/a/foo"), match));
+        REQUIRE(match.index == 0);
+        REQUIRE(r.tree.find(r.routes, std::string("/b/foo"), match));
+        REQUIRE(match.index == 2);
+    }
+
+    SECTION("Invalid parameter regex is not registered") {
+        router r({"/a"});
+        route_builder builder(method::GET, r.routes, r.tree);
+        REQUIRE_THROWS_AS(builder["/b/:x([0-9)"], std::regex_error);
+        REQUIRE(r.routes.size() == 1);
+        builder["/c"];
+        route_tree::match match;
+        REQUIRE(r.tree.find(r.routes, std::string("/c"), match));
+        REQUIRE(match.index == 1);
+    }
+}
+
+TEST_CASE("Route tree matches like the linear regex scan for random routes", "[route][unit]") {
+    std::mt19937 random(1234);
+
+    const std::vector<std::string> pattern_parts = {
+        "a", "b", "ab", "abc", "1", "x.json", ":p", ":q", ":n([0-9]+)", ":w([a-z]*)", ":r(.+)",
+        ":h([0-9a-f]{2,4})", ":p.json", ":p-:q", "v:n([0-9]+)",
+    };
+    const std::vector<std::string> path_parts = {
+        "a", "b", "ab", "abc", "abd", "1", "12", "123", "x.json", "y.json", "", "ff", "v1", "v12",
+        "a-b", "1-2", "A", "a.b",
+    };
+    auto pick = [&](const std::vector<std::string>& parts) {
+        return parts[random() % parts.size()];
+    };
+
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::string> patterns;
+        for (int i = 0; i < 40; ++i) {
+            std::string pattern;
+            for (int segment = 0, segments = 1 + random() % 4; segment < segments; ++segment) {
+                pattern += "/" + pick(pattern_parts);
+            }
+            patterns.push_back(pattern);
+        }
+        router r(patterns);
+
+        for (int i = 0; i < 200; ++i) {
+            std::string path;
+            for (int segment = 0, segments = 1 + random() % 5; segment < segments; ++segment) {
+                path += "/" + pick(path_parts);
+            }
+            r.require_same(path);
+        }
+    }
+}
@@ -4,7 +4,9 @@
 #include <thinger/http/server/pool_server.hpp>
 #include <thinger/http/server/http_server_base.hpp>
 #include <thinger/asio/workers.hpp>
+#include <atomic>
 #include <thread>
+#include <vector>
 #include <chrono>
 
 #include "thinger/http/server/response.hpp"
@@ -228,6 +230,78 @@ TEST_CASE("Pool Server specific features", "[http][server][pool][unit]") {
     }
 }
 
+TEST_CASE("Pool Server with reuse port listeners", "[http][server][pool][unit]") {
+    http::pool_server server;
+    server.enable_reuse_port(true, true);
+    server.get("/", [](http::response& res) {
+        res.send("Hello World!");
+    });
+    REQUIRE(server.listen("127.0.0.1", 0));
+    REQUIRE(server.local_port() != 0);
+
+    // requests on several connections, accepted by any of the listeners
+    for (int i = 0; i < 8; ++i) {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::socket sock(ioc);
+        sock.connect({boost::asio::ip::make_address("127.0.0.1"), server.local_port()});
+        std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+        boost::asio::write(sock, boost::asio::buffer(request));
+
+        boost::system::error_code ec;
+        boost::asio::streambuf response;
+        boost::asio::read(sock, response, ec);
+        std::string text(boost::asio::buffers_begin(response.data()), boost::asio::buffers_end(response.data()));
+        REQUIRE(text.find("HTTP/1.1 200") == 0);
+        REQUIRE(text.find("Hello World!") != std::string::npos);
+    }
+
+    server.stop();
+}
+
+TEST_CASE("Offloaded routes", "[http][server][offload][unit]") {
+    http::server server;
+    std::atomic<std::thread::id> handler_thread;
+    server.get("/hash", [&](http::response& res) {
+        handler_thread = std::this_thread::get_id();
+        res.send("done");
+    }).offload();
+    REQUIRE(server.listen("127.0.0.1", 0));
+    std::thread server_thread([&server] { server.wait(); });
+
+    auto get = [&](const std::string& path) {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::socket sock(ioc);
+        sock.connect({boost::asio::ip::make_address("127.0.0.1"), server.local_port()});
+        std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+        boost::asio::write(sock, boost::asio::buffer(request));
+        boost::system::error_code ec;
+        boost::asio::streambuf response;
+        boost::asio::read(sock, response, ec);
+        return std::string(boost::asio::buffers_begin(response.data()), boost::asio::buffers_end(response.data()));
+    };
+
+    SECTION("Synchronous handlers run on the offload pool") {
+        auto text = get("/hash");
+        REQUIRE(text.find("HTTP/1.1 200") == 0);
+        REQUIRE(text.find("done") != std::string::npos);
+        REQUIRE(handler_thread.load() != server_thread.get_id());
+    }
+
+    SECTION("A saturated pool answers 503") {
+        auto& pool = asio::get_workers().get_offload_pool();
+        std::vector<asio::offload_pool::slot> slots;
+        while (auto slot = pool.try_acquire()) slots.push_back(std::move(slot));
+
+        REQUIRE(get("/hash").find("HTTP/1.1 503") == 0);
+
+        slots.clear();
+        REQUIRE(get("/hash").find("HTTP/1.1 200") == 0);
+    }
+
+    server.stop();
+    server_thread.join();
+}
+
 // Tests specific to standalone server
 TEST_CASE("Standalone Server specific features", "[http][server][standalone][unit]") {
     
@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/util/char_scan.hpp>
+#include <random>
+#include <string>
+#include <cstring>
+
+using namespace thinger::http::util;
+
+namespace {
+
+    const char* naive_find(const char* begin, const char* end, unsigned char lowest) {
+        for (; begin != end; ++begin) {
+            auto c = static_cast<unsigned char>(*begin);
+            if (c < lowest || c == 0x7F) return begin;
+        }
+        return end;
+    }
+
+    const char* naive_token_end(const char* begin, const char* end) {
+        static constexpr const char* separators = "()<>@,;:\\\"/[]?={}";
+        for (; begin != end; ++begin) {
+            auto c = static_cast<unsigned char>(*begin);
+            if (c <= 0x20 || c >= 0x7F || std::strchr(separators, c)) return begin;
+        }
+        return end;
+    }
+
+}
+
+TEST_CASE("char_scan selects a backend", "[char_scan][unit]") {
+    std::string name = scan::backend();
+    REQUIRE((name == "avx2" || name == "sse4.2" || name == "swar"));
+}
+
+TEST_CASE("char_scan find_value_end", "[char_scan][unit]") {
+
+    SECTION("Empty range returns end") {
+        const char* p = "";
+        REQUIRE(scan::find_value_end(p, p) == p);
+    }
+
+    SECTION("Stops at CR after a long run") {
+        std::string value(100, 'v');
+        value += "\r\n";
+        REQUIRE(scan::find_value_end(value.data(), value.data() + value.size()) == value.data() + 100);
+    }
+
+    SECTION("Space, HTAB and high bytes") {
+        std::string value = "a b\xC3\xA9";
+        REQUIRE(scan::find_value_end(value.data(), value.data() + value.size()) == value.data() + value.size());
+        value = "abc\tdef";
+        REQUIRE(scan::find_value_end(value.data(), value.data() + value.size()) == value.data() + 3);
+    }
+}
+
+TEST_CASE("char_scan find_uri_end", "[char_scan][unit]") {
+    std::string uri = "/path/to/resource?with=query&and=more HTTP/1.1";
+    REQUIRE(scan::find_uri_end(uri.data(), uri.data() + uri.size()) == uri.data() + uri.find(' '));
+}
+
+TEST_CASE("char_scan find_token_end", "[char_scan][unit]") {
+    std::string line = "Content-Type: text/plain";
+    REQUIRE(scan::find_token_end(line.data(), line.data() + line.size()) == line.data() + 12);
+    line = "POST /";
+    REQUIRE(scan::find_token_end(line.data(), line.data() + line.size()) == line.data() + 4);
+}
+
+TEST_CASE("char_scan matches a bytewise reference on random input", "[char_scan][unit]") {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> length(0, 96);
+    std::uniform_int_distribution<int> printable(0x21, 0x7E);
+    std::uniform_int_distribution<int> any(0, 255);
+    std::uniform_int_distribution<int> pick(0, 15);
+
+    for (int round = 0; round < 20000; ++round) {
+        std::string data(length(rng), '\0');
+        for (auto& c : data) {
+            // mostly printable, with the occasional arbitrary byte
+            c = static_cast<char>(pick(rng) == 0 ? any(rng) : printable(rng));
+        }
+        const char* begin = data.data();
+        const char* end = begin + data.size();
+        REQUIRE(scan::find_value_end(begin, end) == naive_find(begin, end, 0x20));
+        REQUIRE(scan::find_uri_end(begin, end) == naive_find(begin, end, 0x21));
+        REQUIRE(scan::find_token_end(begin, end) == naive_token_end(begin, end));
+    }
+}
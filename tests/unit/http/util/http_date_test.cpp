@@ -0,0 +1,43 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/util/http_date.hpp>
+#include <ctime>
+#include <string>
+
+using namespace thinger::http::util;
+
+TEST_CASE("HTTP date formatting", "[http][util][date]") {
+
+    SECTION("IMF-fixdate format") {
+        char out[HTTP_DATE_SIZE];
+        format_http_date(784111777, out);
+        REQUIRE(std::string(out, HTTP_DATE_SIZE) == "Sun, 06 Nov 1994 08:49:37 GMT");
+
+        format_http_date(0, out);
+        REQUIRE(std::string(out, HTTP_DATE_SIZE) == "Thu, 01 Jan 1970 00:00:00 GMT");
+
+        format_http_date(951782400, out);
+        REQUIRE(std::string(out, HTTP_DATE_SIZE) == "Tue, 29 Feb 2000 00:00:00 GMT");
+    }
+
+    SECTION("Cached date matches the current time") {
+        std::time_t before = std::time(nullptr);
+        std::string cached(http_date());
+        std::time_t after = std::time(nullptr);
+
+        char expected[HTTP_DATE_SIZE];
+        format_http_date(before, expected);
+        bool matches = cached == std::string(expected, HTTP_DATE_SIZE);
+        if (!matches) {
+            format_http_date(after, expected);
+            matches = cached == std::string(expected, HTTP_DATE_SIZE);
+        }
+        REQUIRE(cached.size() == HTTP_DATE_SIZE);
+        REQUIRE(matches);
+    }
+
+    SECTION("Repeated calls within a second return the same value") {
+        auto first = http_date();
+        auto second = http_date();
+        REQUIRE(first.data() == second.data());
+    }
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/http/util/json_writer.hpp>
+#include <limits>
+#include <string>
+
+using namespace thinger::http::util;
+using thinger::util::output_buffer;
+
+namespace {
+
+    std::string str(const output_buffer& out) {
+        std::string result;
+        out.append_to(result);
+        return result;
+    }
+
+    std::string write_all(const nlohmann::json& document) {
+        json_writer writer(document);
+        output_buffer out;
+        REQUIRE(writer.write(out, std::numeric_limits<size_t>::max()));
+        return str(out);
+    }
+
+    nlohmann::json large_document() {
+        nlohmann::json items = nlohmann::json::array();
+        for (int i = 0; i < 2000; ++i) {
+            items.push_back({
+                {"id", i},
+                {"name", "device-" + std::to_string(i)},
+                {"value", i * 0.5},
+                {"enabled", i % 2 == 0},
+                {"tags", {"a", "b", nullptr}},
+                {"nested", {{"empty_array", nlohmann::json::array()}, {"empty_object", nlohmann::json::object()}}}
+            });
+        }
+        return {{"items", items}, {"count", 2000}};
+    }
+
+}
+
+TEST_CASE("Output buffer", "[util][json]") {
+    output_buffer out;
+    std::string expected;
+    for (int i = 0; i < 5000; ++i) {
+        auto piece = std::to_string(i) + ",";
+        out.append(piece.data(), piece.size());
+        out.push_back(' ');
+        expected += piece + " ";
+    }
+
+    REQUIRE(out.size() == expected.size());
+    REQUIRE(out.size() > output_buffer::BLOCK_SIZE);
+    REQUIRE(str(out) == expected);
+
+    std::vector<boost::asio::const_buffer> buffers;
+    out.to_buffer(buffers);
+    REQUIRE(buffers.size() == (expected.size() + output_buffer::BLOCK_SIZE - 1) / output_buffer::BLOCK_SIZE);
+
+    output_buffer moved(std::move(out));
+    REQUIRE(out.empty());
+    REQUIRE(str(moved) == expected);
+    moved.clear();
+    REQUIRE(moved.empty());
+}
+
+TEST_CASE("JSON writer", "[util][json]") {
+
+    SECTION("Documents are written as dump() does") {
+        std::vector<nlohmann::json> documents = {
+            nullptr,
+            42,
+            "text with \"quotes\", \\ and \n",
+            nlohmann::json::array(),
+            nlohmann::json::object(),
+            {{"a", 1}, {"b", {1, 2.5, "x"}}, {"c", {{"d", false}}}},
+            {{"ke\"y", "value"}, {"ñandú", "ü"}, {"tab\tkey", 1}},
+            large_document()
+        };
+
+        for (const auto& document : documents) {
+            REQUIRE(write_all(document) == document.dump());
+        }
+    }
+
+    SECTION("Documents can be written in parts") {
+        auto document = large_document();
+        auto expected = document.dump();
+
+        json_writer writer(document);
+        std::string written;
+        size_t parts = 0;
+        bool done = false;
+        while (!done) {
+            output_buffer out;
+            done = writer.write(out, 4096);
+            if (!done) REQUIRE(out.size() >= 4096);
+            // parts stop between values, a little after the limit
+            REQUIRE(out.size() < 4096 + 512);
+            written += str(out);
+            ++parts;
+        }
+
+        REQUIRE(written == expected);
+        REQUIRE(parts >= expected.size() / (4096 + 512));
+        REQUIRE(writer.done());
+    }
+
+    SECTION("Invalid UTF-8 is rejected as dump() does") {
+        nlohmann::json document = {{"value", std::string("\xff\xfe")}};
+        json_writer writer(document);
+        output_buffer out;
+        REQUIRE_THROWS_AS(writer.write(out, std::numeric_limits<size_t>::max()), nlohmann::json::type_error);
+    }
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/util/arena.hpp>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+
+using thinger::util::arena;
+using thinger::util::arena_allocator;
+
+namespace {
+
+    // empty the calling thread's block pool, so each section starts from a known state
+    void drain() {
+        while (arena::block_pool::available() > 0) arena::block_pool::acquire();
+    }
+
+    struct object {
+        explicit object(int v) : value(v) {}
+        int value;
+        char payload[64]{};
+    };
+
+    template<typename T, typename... Args>
+    std::shared_ptr<T> make(const std::shared_ptr<arena>& source, Args&&... args) {
+        return std::allocate_shared<T>(arena_allocator<T>(source), std::forward<Args>(args)...);
+    }
+
+}
+
+TEST_CASE("Arena reuses its memory between requests", "[util][arena]") {
+    drain();
+    auto memory = std::make_shared<arena>();
+
+    SECTION("Memory is reused once every allocation is released") {
+        auto first = make<object>(memory, 1);
+        auto* address = first.get();
+        REQUIRE(memory->allocations() == 1);
+
+        first.reset();
+        REQUIRE(memory->allocations() == 0);
+
+        auto second = make<object>(memory, 2);
+        REQUIRE(second.get() == address);
+        REQUIRE(second->value == 2);
+    }
+
+    SECTION("Memory is not reused while an allocation is alive") {
+        auto first = make<object>(memory, 1);
+        auto second = make<object>(memory, 2);
+        auto* address = second.get();
+
+        second.reset();
+        auto third = make<object>(memory, 3);
+        REQUIRE(third.get() != address);
+        REQUIRE(first->value == 1);
+    }
+
+    SECTION("Trim gives the block back only when unused") {
+        auto first = make<object>(memory, 1);
+        memory->trim();
+        REQUIRE(memory->holds_memory());
+
+        first.reset();
+        memory->trim();
+        REQUIRE_FALSE(memory->holds_memory());
+        REQUIRE(arena::block_pool::available() == 1);
+
+        auto second = make<object>(memory, 2);
+        REQUIRE(memory->holds_memory());
+        REQUIRE(arena::block_pool::available() == 0);
+    }
+
+    SECTION("Allocations larger than the block are served") {
+        auto large = make<std::array<char, arena::BLOCK_SIZE * 2>>(memory);
+        large->fill('x');
+        auto small = make<object>(memory, 1);
+        REQUIRE((*large)[arena::BLOCK_SIZE * 2 - 1] == 'x');
+        REQUIRE(small->value == 1);
+        REQUIRE(memory->heap_bytes() >= arena::BLOCK_SIZE * 2);
+
+        large.reset();
+        REQUIRE(memory->heap_bytes() == 0);
+    }
+
+    SECTION("Overlapping allocations never grow the arena past its block") {
+        // as pipelined requests: the previous object is always alive when the next is created
+        auto previous = make<object>(memory, 0);
+        size_t peak = 0;
+        for (int i = 1; i < 10000; ++i) {
+            auto next = make<object>(memory, i);
+            previous = std::move(next);
+            REQUIRE(memory->used() <= arena::BLOCK_SIZE);
+            peak = std::max(peak, memory->heap_bytes());
+        }
+        REQUIRE(previous->value == 9999);
+        REQUIRE(peak <= 2 * sizeof(object) + 256);
+
+        previous.reset();
+        REQUIRE(memory->allocations() == 0);
+        REQUIRE(memory->heap_bytes() == 0);
+    }
+
+    SECTION("Objects keep the arena alive") {
+        auto survivor = make<object>(memory, 7);
+        memory.reset();
+        REQUIRE(survivor->value == 7);
+    }
+
+    SECTION("Containers can use the arena as memory resource") {
+        std::pmr::string text("a string long enough to not fit the small string buffer", memory.get());
+        REQUIRE(memory->allocations() == 1);
+        text.clear();
+        text.shrink_to_fit();
+        REQUIRE(memory->allocations() == 0);
+    }
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thinger/util/buffer_pool.hpp>
+#include <thread>
+#include <vector>
+
+using pool = thinger::util::buffer_pool<4096>;
+using other_pool = thinger::util::buffer_pool<1024>;
+
+namespace {
+
+    // empty the calling thread's pool, so each section starts from a known state
+    void drain() {
+        while (pool::available() > 0) pool::acquire();
+        while (other_pool::available() > 0) other_pool::acquire();
+    }
+
+}
+
+TEST_CASE("Buffer pool reuses released buffers", "[util][buffer_pool]") {
+    drain();
+
+    SECTION("Released buffers are handed out again") {
+        auto buffer = pool::acquire();
+        REQUIRE(buffer);
+        auto* data = buffer.get();
+
+        pool::release(buffer);
+        REQUIRE_FALSE(buffer);
+        REQUIRE(pool::available() == 1);
+
+        auto again = pool::acquire();
+        REQUIRE(again.get() == data);
+        REQUIRE(pool::available() == 0);
+    }
+
+    SECTION("Shared buffers are not recycled") {
+        auto buffer = pool::acquire();
+        auto pinned = buffer;
+
+        pool::release(buffer);
+        REQUIRE_FALSE(buffer);
+        REQUIRE(pool::available() == 0);
+        REQUIRE(pinned.use_count() == 1);
+    }
+
+    SECTION("The number of free buffers is bounded") {
+        std::vector<pool::buffer> buffers;
+        for (size_t i = 0; i < pool::MAX_FREE_BUFFERS + 10; ++i) {
+            buffers.push_back(pool::acquire());
+        }
+        for (auto& buffer : buffers) {
+            pool::release(buffer);
+        }
+        REQUIRE(pool::available() == pool::MAX_FREE_BUFFERS);
+    }
+
+    SECTION("Leases return their buffer on scope exit") {
+        uint8_t* data = nullptr;
+        {
+            pool::lease lease;
+            data = lease.data();
+            REQUIRE(lease.size() == 4096);
+            REQUIRE(pool::available() == 0);
+        }
+        REQUIRE(pool::available() == 1);
+        REQUIRE(pool::acquire().get() == data);
+    }
+
+    SECTION("Pools are per buffer size") {
+        auto buffer = pool::acquire();
+        pool::release(buffer);
+        REQUIRE(pool::available() == 1);
+        REQUIRE(other_pool::available() == 0);
+    }
+}
+
+TEST_CASE("Buffer pool is per thread", "[util][buffer_pool]") {
+    drain();
+
+    auto buffer = pool::acquire();
+    pool::release(buffer);
+    REQUIRE(pool::available() == 1);
+
+    size_t available_in_thread = 0;
+    std::thread([&] {
+        available_in_thread = pool::available();
+        auto other = pool::acquire();
+        pool::release(other);
+    }).join();
+
+    REQUIRE(available_in_thread == 0);
+    REQUIRE(pool::available() == 1);
+}
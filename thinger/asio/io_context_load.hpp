@@ -0,0 +1,36 @@
+#ifndef THINGER_ASIO_IO_CONTEXT_LOAD_HPP
+#define THINGER_ASIO_IO_CONTEXT_LOAD_HPP
+
+#include <atomic>
+#include <boost/asio/io_context.hpp>
+
+namespace thinger::asio {
+
+    // Number of open sockets running on an io_context. Kept as an io_context service, so
+    // sockets update it without knowing which worker thread runs their io_context.
+    class io_context_load : public boost::asio::execution_context::service {
+    public:
+        using key_type = io_context_load;
+        static inline boost::asio::execution_context::id id;
+
+        explicit io_context_load(boost::asio::execution_context& context) :
+            boost::asio::execution_context::service(context) {}
+
+        // counter of the given io_context, created on first use
+        static std::atomic<size_t>& of(boost::asio::io_context& io_context) {
+            return boost::asio::use_service<io_context_load>(io_context).sockets_;
+        }
+
+        static size_t sockets(boost::asio::io_context& io_context) {
+            return of(io_context).load(std::memory_order_relaxed);
+        }
+
+    private:
+        void shutdown() override {}
+
+        std::atomic<size_t> sockets_{0};
+    };
+
+}
+
+#endif
@@ -0,0 +1,36 @@
+#include "io_uring.hpp"
+
+#ifdef THINGER_HTTP_IO_URING_ENABLED
+#include <liburing.h>
+#endif
+
+namespace thinger::asio{
+
+    bool io_uring_supported(){
+#ifdef THINGER_HTTP_IO_URING_ENABLED
+        // kernels without io_uring (or with it disabled by seccomp or sysctl) fail the setup
+        static const bool supported = []{
+            io_uring ring{};
+            if(io_uring_queue_init(2, &ring, 0) < 0) return false;
+            io_uring_queue_exit(&ring);
+            return true;
+        }();
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    bool io_uring_sockets(){
+#if defined(THINGER_HTTP_IO_URING_ENABLED) && defined(BOOST_ASIO_DISABLE_EPOLL)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const char* io_backend(){
+        return io_uring_sockets() ? "io_uring" : "epoll";
+    }
+
+}
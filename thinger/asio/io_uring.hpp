@@ -0,0 +1,19 @@
+#ifndef THINGER_ASIO_IO_URING_HPP
+#define THINGER_ASIO_IO_URING_HPP
+
+namespace thinger::asio{
+
+    // Whether the library was built with THINGER_HTTP_ENABLE_IO_URING and the running kernel
+    // supports io_uring. Probed once; file I/O falls back to blocking reads when false.
+    bool io_uring_supported();
+
+    // Whether socket and timer operations run on io_uring instead of epoll
+    // (THINGER_HTTP_IO_URING_SOCKETS). Decided at build time by Boost.Asio.
+    bool io_uring_sockets();
+
+    // Name of the event loop backend, for logging
+    const char* io_backend();
+
+}
+
+#endif
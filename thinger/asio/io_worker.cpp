@@ -11,7 +11,14 @@ namespace thinger::asio{
     io_worker::~io_worker() = default;
 
     void io_worker::start() {
-        io_.run();
+        if(!count_handlers_){
+            io_.run();
+            return;
+        }
+        // only this thread writes the counter
+        while(io_.run_one()){
+            handlers_.store(handlers_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
     }
 
     void io_worker::stop(){
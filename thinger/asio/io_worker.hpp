@@ -1,6 +1,8 @@
 #ifndef THINGER_ASIO_IO_WORKER_HPP
 #define THINGER_ASIO_IO_WORKER_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <boost/asio/io_context.hpp>
 
 namespace thinger::asio{
@@ -14,8 +16,14 @@ namespace thinger::asio{
         void stop();
         boost::asio::io_context& get_io_context();
 
+        /// count the handlers run by start(), at a small cost per handler
+        void count_handlers(bool enabled) { count_handlers_ = enabled; }
+        uint64_t handlers() const { return handlers_.load(std::memory_order_relaxed); }
+
     private:
         boost::asio::io_context io_;
+        bool count_handlers_ = false;
+        std::atomic<uint64_t> handlers_{0};
         boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
     };
 
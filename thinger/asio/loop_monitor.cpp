@@ -0,0 +1,141 @@
+#include "loop_monitor.hpp"
+#include "io_worker.hpp"
+#include <algorithm>
+#include <boost/asio/post.hpp>
+
+namespace thinger::asio{
+
+    namespace {
+        thread_local loop_monitor* this_thread_monitor = nullptr;
+
+        void update_max(std::atomic<int64_t>& max, int64_t value) {
+            if(value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+        }
+
+        void update_max(std::atomic<size_t>& max, size_t value) {
+            if(value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    loop_monitor::loop_monitor(io_worker& worker, std::string name) :
+        worker_(worker),
+        name_(std::move(name)),
+        timer_(worker.get_io_context())
+    {
+    }
+
+    int64_t loop_monitor::now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void loop_monitor::start(std::chrono::milliseconds interval) {
+        if(interval.count() <= 0 || enabled()) return;
+        interval_ = interval;
+        worker_.count_handlers(true);
+        schedule();
+    }
+
+    void loop_monitor::schedule() {
+        timer_.expires_after(interval_);
+        deadline_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            timer_.expiry().time_since_epoch()).count(), std::memory_order_relaxed);
+        timer_.async_wait([this](const boost::system::error_code& ec){ on_probe(ec); });
+    }
+
+    void loop_monitor::on_probe(const boost::system::error_code& ec) {
+        if(ec) return;
+
+        // lag: how late the timer fired
+        auto lag = std::max<int64_t>(0, now() - deadline_.load(std::memory_order_relaxed));
+        lag_.store(lag, std::memory_order_relaxed);
+        update_max(max_lag_, lag);
+
+        // queue depth: handlers run between posting a probe and running it (this one is
+        // still running, so it is not counted yet)
+        auto handlers = worker_.handlers();
+        deadline_.store(now(), std::memory_order_relaxed);
+        boost::asio::post(worker_.get_io_context(), [this, handlers]{
+            size_t depth = worker_.handlers() - handlers - 1;
+            queue_depth_.store(depth, std::memory_order_relaxed);
+            update_max(max_queue_depth_, depth);
+            schedule();
+        });
+    }
+
+    loop_stats loop_monitor::get_stats() const {
+        loop_stats stats;
+        stats.lag = std::chrono::microseconds(lag_.load(std::memory_order_relaxed) / 1000);
+        stats.max_lag = std::chrono::microseconds(max_lag_.load(std::memory_order_relaxed) / 1000);
+        stats.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+        stats.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+        stats.handlers = worker_.handlers();
+        return stats;
+    }
+
+    std::optional<blocked_handler> loop_monitor::check(std::chrono::milliseconds threshold) {
+        auto current = now();
+        auto limit = std::chrono::duration_cast<std::chrono::nanoseconds>(threshold).count();
+
+        // a marked handler, read consistently
+        auto sequence = sequence_.load(std::memory_order_acquire);
+        if(sequence % 2 == 0 && sequence != reported_sequence_){
+            auto started = started_.load(std::memory_order_relaxed);
+            auto marker = marker_.load(std::memory_order_relaxed);
+            if(started != 0 && current - started > limit){
+                // copy the marker while its handler is still running
+                std::string text = marker ? marker : "";
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(sequence_.load(std::memory_order_relaxed) == sequence){
+                    reported_sequence_ = sequence;
+                    reported_deadline_ = deadline_.load(std::memory_order_relaxed);
+                    return blocked_handler{name_, std::move(text),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(current - started))};
+                }
+            }
+        }
+
+        // the probe timer is overdue, but no marked handler is running
+        auto deadline = deadline_.load(std::memory_order_relaxed);
+        if(deadline != 0 && deadline != reported_deadline_ && current - deadline > limit){
+            reported_deadline_ = deadline;
+            return blocked_handler{name_, "",
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(current - deadline))};
+        }
+        return std::nullopt;
+    }
+
+    void loop_monitor::attach() {
+        this_thread_monitor = this;
+    }
+
+    loop_monitor* loop_monitor::current() {
+        return this_thread_monitor;
+    }
+
+    void loop_monitor::mark(const char* marker, int64_t started) {
+        // single writer: the monitored thread
+        auto sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        marker_.store(marker, std::memory_order_relaxed);
+        started_.store(started, std::memory_order_relaxed);
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    handler_scope::handler_scope(const char* marker) :
+        monitor_(this_thread_monitor)
+    {
+        if(!monitor_) return;
+        previous_marker_ = monitor_->marker_.load(std::memory_order_relaxed);
+        previous_started_ = monitor_->started_.load(std::memory_order_relaxed);
+        monitor_->mark(marker, loop_monitor::now());
+    }
+
+    handler_scope::~handler_scope() {
+        if(!monitor_) return;
+        // back to the enclosing handler, if any
+        monitor_->mark(previous_marker_, previous_started_);
+    }
+
+}
@@ -0,0 +1,117 @@
+#ifndef THINGER_ASIO_LOOP_MONITOR_HPP
+#define THINGER_ASIO_LOOP_MONITOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+namespace thinger::asio{
+
+    class io_worker;
+
+    /// event loop statistics of a worker thread
+    struct loop_stats {
+        /// how late the last probe timer fired
+        std::chrono::microseconds lag{0};
+        std::chrono::microseconds max_lag{0};
+        /// handlers queued ahead of the last probe
+        size_t queue_depth = 0;
+        size_t max_queue_depth = 0;
+        /// handlers run so far
+        uint64_t handlers = 0;
+    };
+
+    /// a handler that kept an event loop busy longer than the watchdog threshold
+    struct blocked_handler {
+        std::string thread;
+        /// marker of the handler (i.e., the route pattern), or empty if it was not marked
+        std::string marker;
+        std::chrono::milliseconds blocked{0};
+    };
+
+    /**
+     * Monitors the event loop of an io_worker: a periodic probe timer measures how late it
+     * fires (lag) and how many handlers were queued ahead of it (queue depth), and handlers
+     * marked with handler_scope are recorded so a watchdog thread can tell which one is
+     * blocking the loop.
+     */
+    class loop_monitor {
+    public:
+        loop_monitor(io_worker& worker, std::string name);
+
+        /// start probing every interval; call before the io_worker runs
+        void start(std::chrono::milliseconds interval);
+        bool enabled() const { return interval_.count() > 0; }
+
+        /// statistics so far (thread safe)
+        loop_stats get_stats() const;
+
+        /// called from the watchdog thread: the handler blocking the loop for longer than
+        /// threshold, reported once per handler run
+        std::optional<blocked_handler> check(std::chrono::milliseconds threshold);
+
+        /// make this the monitor of the calling thread, for handler_scope
+        void attach();
+
+        /// monitor of the calling thread, if any
+        static loop_monitor* current();
+
+    private:
+        friend class handler_scope;
+
+        static int64_t now();
+        void schedule();
+        void on_probe(const boost::system::error_code& ec);
+
+        // mark the handler running on the monitored thread (0 started = idle)
+        void mark(const char* marker, int64_t started);
+
+        io_worker& worker_;
+        std::string name_;
+        std::chrono::milliseconds interval_{0};
+        boost::asio::steady_timer timer_;
+
+        // statistics, written by the monitored thread
+        std::atomic<int64_t> lag_{0};
+        std::atomic<int64_t> max_lag_{0};
+        std::atomic<size_t> queue_depth_{0};
+        std::atomic<size_t> max_queue_depth_{0};
+        // expiry of the pending probe, for loops blocked by unmarked handlers
+        std::atomic<int64_t> deadline_{0};
+
+        // running handler, as a seqlock: odd while being updated
+        std::atomic<uint64_t> sequence_{0};
+        std::atomic<const char*> marker_{nullptr};
+        std::atomic<int64_t> started_{0};
+
+        // last reports of the watchdog, to report each block once
+        uint64_t reported_sequence_ = 0;
+        int64_t reported_deadline_ = 0;
+    };
+
+    /**
+     * Marks the handler running on the calling thread for the watchdog, for instance with
+     * the route pattern. Does nothing on threads without a loop_monitor. The marker must
+     * outlive the scope.
+     */
+    class handler_scope {
+    public:
+        explicit handler_scope(const char* marker);
+        ~handler_scope();
+
+        handler_scope(const handler_scope&) = delete;
+        handler_scope& operator=(const handler_scope&) = delete;
+
+    private:
+        loop_monitor* monitor_;
+        const char* previous_marker_ = nullptr;
+        int64_t previous_started_ = 0;
+    };
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef THINGER_ASIO_OFFLOAD_HPP
+#define THINGER_ASIO_OFFLOAD_HPP
+
+#include <type_traits>
+#include "workers.hpp"
+#include "offload_pool.hpp"
+#include "../util/types.hpp"
+
+namespace thinger{
+
+    namespace detail{
+        // rejection raised when awaited, like the errors of the job itself
+        template<typename T>
+        awaitable<T> offload_rejected() {
+            co_await boost::asio::this_coro::executor;
+            throw asio::offload_rejected();
+        }
+    }
+
+    /**
+     * Run a CPU-bound callable on an offload pool (the one of the workers by default) and
+     * resume the calling coroutine on its own executor with the result:
+     *
+     *     auto digest = co_await thinger::offload([&]{ return hash(body); });
+     *
+     * Exceptions thrown by the callable are rethrown to the caller. Throws
+     * asio::offload_rejected if the pool has no room for another job. Not a coroutine
+     * itself, so the job is handed to co_spawn without a wrapping coroutine frame.
+     */
+    template<typename F>
+    awaitable<std::invoke_result_t<F&>> offload(asio::offload_pool& pool, F f) {
+        using result_type = std::invoke_result_t<F&>;
+
+        auto slot = pool.try_acquire();
+        if(!slot) return detail::offload_rejected<result_type>();
+
+        return co_spawn(pool.get_executor(),
+            [f = std::move(f), slot = std::move(slot)]() mutable -> awaitable<result_type> {
+                // the place is given back when the job ends, also if it throws, before resuming the caller
+                auto job = std::move(slot);
+                co_return f();
+            }, use_awaitable);
+    }
+
+    template<typename F>
+    awaitable<std::invoke_result_t<F&>> offload(F f) {
+        return offload(asio::get_workers().get_offload_pool(), std::move(f));
+    }
+
+}
+
+#endif
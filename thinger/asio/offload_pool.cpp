@@ -0,0 +1,58 @@
+#include "offload_pool.hpp"
+#include "../util/logger.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace thinger::asio{
+
+    namespace {
+        size_t pool_threads(size_t threads) {
+            return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    offload_pool::slot& offload_pool::slot::operator=(slot&& other) noexcept {
+        if(this != &other){
+            reset();
+            pool_ = other.pool_;
+            other.pool_ = nullptr;
+        }
+        return *this;
+    }
+
+    void offload_pool::slot::reset() {
+        if(pool_){
+            pool_->pending_.fetch_sub(1, std::memory_order_release);
+            pool_ = nullptr;
+        }
+    }
+
+    offload_pool::offload_pool(size_t threads, size_t max_pending) :
+        threads_(pool_threads(threads)),
+        max_pending_(std::max<size_t>(1, max_pending)),
+        pool_(threads_)
+    {
+        LOG_INFO("starting {} offload threads (up to {} pending jobs)", threads_, max_pending_);
+    }
+
+    offload_pool::~offload_pool() {
+        stop();
+    }
+
+    offload_pool::slot offload_pool::try_acquire() {
+        auto pending = pending_.load(std::memory_order_relaxed);
+        do{
+            if(pending >= max_pending_){
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                return slot{};
+            }
+        }while(!pending_.compare_exchange_weak(pending, pending + 1, std::memory_order_acquire, std::memory_order_relaxed));
+        return slot{this};
+    }
+
+    void offload_pool::stop() {
+        pool_.stop();
+        pool_.join();
+    }
+
+}
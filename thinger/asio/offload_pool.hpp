@@ -0,0 +1,71 @@
+#ifndef THINGER_ASIO_OFFLOAD_POOL_HPP
+#define THINGER_ASIO_OFFLOAD_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <boost/asio/thread_pool.hpp>
+
+namespace thinger::asio{
+
+    /// thrown by offload() when the pool already has as many pending jobs as allowed
+    class offload_rejected : public std::runtime_error {
+    public:
+        offload_rejected() : std::runtime_error("offload pool saturated") {}
+    };
+
+    /**
+     * Thread pool for CPU-bound work that should not run on the I/O threads, with a limit on
+     * the jobs queued or running, so a saturated pool rejects work instead of queueing it
+     * without bound. Jobs are usually submitted with thinger::offload().
+     */
+    class offload_pool {
+    public:
+        static constexpr size_t DEFAULT_MAX_PENDING = 1024;
+
+        /// a pending job; releases its place in the pool when destroyed
+        class slot {
+        public:
+            slot() = default;
+            explicit slot(offload_pool* pool) : pool_(pool) {}
+            slot(slot&& other) noexcept : pool_(other.pool_) { other.pool_ = nullptr; }
+            slot& operator=(slot&& other) noexcept;
+            ~slot() { reset(); }
+
+            explicit operator bool() const { return pool_ != nullptr; }
+            void reset();
+
+        private:
+            offload_pool* pool_ = nullptr;
+        };
+
+        /// threads 0 means one per hardware thread
+        explicit offload_pool(size_t threads = 0, size_t max_pending = DEFAULT_MAX_PENDING);
+        ~offload_pool();
+
+        /// take a place for a new job, or an empty slot if the pool is saturated
+        slot try_acquire();
+
+        boost::asio::thread_pool::executor_type get_executor() { return pool_.get_executor(); }
+
+        /// stop running jobs and wait for the threads; jobs not started are discarded
+        void stop();
+
+        size_t threads() const { return threads_; }
+        size_t max_pending() const { return max_pending_; }
+        size_t pending() const { return pending_.load(std::memory_order_relaxed); }
+
+        /// jobs rejected so far because the pool was saturated
+        size_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+    private:
+        size_t threads_;
+        size_t max_pending_;
+        std::atomic<size_t> pending_{0};
+        std::atomic<size_t> rejected_{0};
+        boost::asio::thread_pool pool_;
+    };
+
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include "remote_filter.hpp"
+#include "../util/logger.hpp"
+#include <charconv>
+
+namespace thinger::asio {
+
+namespace {
+
+    unsigned nibble(const uint8_t* bytes, unsigned index) {
+        return index % 2 == 0 ? bytes[index / 2] >> 4 : bytes[index / 2] & 0x0f;
+    }
+
+    // whether the first prefix_length bits of an IPv6 range include the IPv4-mapped space
+    bool covers_v4_mapped(const boost::asio::ip::address_v6::bytes_type& bytes, unsigned prefix_length) {
+        static const auto mapped = boost::asio::ip::make_address_v6("::ffff:0:0").to_bytes();
+        for (unsigned i = 0; i < prefix_length; ++i) {
+            unsigned shift = 7 - i % 8;
+            if (((bytes[i / 8] ^ mapped[i / 8]) >> shift) & 1u) return false;
+        }
+        return true;
+    }
+
+}
+
+prefix_set::prefix_set() = default;
+
+bool prefix_set::add(std::string_view range) {
+    auto slash = range.find('/');
+    boost::system::error_code ec;
+    auto address = boost::asio::ip::make_address(std::string(range.substr(0, slash)), ec);
+    if (ec) return false;
+
+    unsigned max_length = address.is_v4() ? 32 : 128;
+    unsigned length = max_length;
+    if (slash != std::string_view::npos) {
+        auto digits = range.substr(slash + 1);
+        auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), length);
+        if (error != std::errc() || end != digits.data() + digits.size() || digits.empty() || length > max_length) {
+            return false;
+        }
+    }
+
+    if (address.is_v4()) {
+        v4_.add(address.to_v4().to_bytes().data(), length);
+    } else {
+        auto bytes = address.to_v6().to_bytes();
+        if (length >= 96 && address.to_v6().is_v4_mapped()) {
+            v4_.add(bytes.data() + 12, length - 96);
+        } else {
+            v6_.add(bytes.data(), length);
+            // a wider range also spans the IPv4 addresses
+            if (length < 96 && covers_v4_mapped(bytes, length)) v4_.add(bytes.data() + 12, 0);
+        }
+    }
+    ++ranges_;
+    return true;
+}
+
+bool prefix_set::contains(const boost::asio::ip::address& address) const {
+    if (ranges_ == 0) return false;
+    if (address.is_v4()) {
+        return v4_.contains(address.to_v4().to_bytes().data(), 32);
+    }
+    auto bytes = address.to_v6().to_bytes();
+    if (address.to_v6().is_v4_mapped()) {
+        return v4_.contains(bytes.data() + 12, 32);
+    }
+    return v6_.contains(bytes.data(), 128);
+}
+
+void prefix_set::trie::add(const uint8_t* bytes, unsigned prefix_length) {
+    if (prefix_length == 0) {
+        all = true;
+        return;
+    }
+    // nibbles fully within the prefix before the last one
+    unsigned levels = (prefix_length - 1) / STRIDE;
+    uint32_t current = 0;
+    for (unsigned i = 0; i < levels; ++i) {
+        unsigned slot = nibble(bytes, i);
+        // already within a shorter range
+        if (nodes[current].terminal & (1u << slot)) return;
+        if (nodes[current].child[slot] == 0) {
+            nodes[current].child[slot] = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        current = nodes[current].child[slot];
+    }
+    // the remaining 1 to 4 bits select one slot, or a run of sibling slots
+    unsigned remaining = prefix_length - levels * STRIDE;
+    unsigned free_bits = STRIDE - remaining;
+    unsigned first = (nibble(bytes, levels) >> free_bits) << free_bits;
+    for (unsigned slot = first; slot < first + (1u << free_bits); ++slot) {
+        nodes[current].terminal |= static_cast<uint16_t>(1u << slot);
+    }
+}
+
+bool prefix_set::trie::contains(const uint8_t* bytes, unsigned bits) const {
+    if (all) return true;
+    uint32_t current = 0;
+    for (unsigned i = 0; i < bits / STRIDE; ++i) {
+        const auto& n = nodes[current];
+        unsigned slot = nibble(bytes, i);
+        if (n.terminal & (1u << slot)) return true;
+        current = n.child[slot];
+        if (current == 0) return false;
+    }
+    return false;
+}
+
+remote_filter::remote_filter(const std::set<std::string>& allowed, const std::set<std::string>& forbidden)
+    : restricted_(!allowed.empty())
+{
+    for (const auto& range : allowed) {
+        if (!allowed_.add(range)) LOG_WARNING("ignoring invalid allowed remote: {}", range);
+    }
+    for (const auto& range : forbidden) {
+        if (!forbidden_.add(range)) LOG_WARNING("ignoring invalid forbidden remote: {}", range);
+    }
+}
+
+bool remote_filter::is_allowed(const boost::asio::ip::address& address) const {
+    if (forbidden_.contains(address)) return false;
+    return !restricted_ || allowed_.contains(address);
+}
+
+} // namespace thinger::asio
@@ -0,0 +1,77 @@
+#ifndef THINGER_ASIO_REMOTE_FILTER_HPP
+#define THINGER_ASIO_REMOTE_FILTER_HPP
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/asio/ip/address.hpp>
+
+namespace thinger::asio {
+
+// Set of address ranges ("10.0.0.0/8", "2001:db8::/32" or single addresses) stored as
+// prefix tries over the address bytes, one for IPv4 and one for IPv6, consuming four bits
+// per node. Prefixes not multiple of four are expanded into the sibling slots of their last
+// node, so a lookup visits at most 8 nodes for IPv4 and 32 for IPv6, whatever the number of
+// ranges. IPv4-mapped IPv6 addresses and ranges are handled as IPv4 ones.
+class prefix_set {
+public:
+    prefix_set();
+
+    // Add a range in CIDR notation or a single address; false if it is not valid
+    bool add(std::string_view range);
+
+    // Whether an address is within any of the ranges
+    bool contains(const boost::asio::ip::address& address) const;
+
+    size_t size() const { return ranges_; }
+    bool empty() const { return ranges_ == 0; }
+
+private:
+    static constexpr unsigned STRIDE = 4;
+
+    struct node {
+        uint32_t child[1u << STRIDE] = {};
+        // slots whose whole subtree is within a range
+        uint16_t terminal = 0;
+    };
+
+    struct trie {
+        std::vector<node> nodes{1};
+        // a zero length prefix
+        bool all = false;
+
+        void add(const uint8_t* bytes, unsigned prefix_length);
+        bool contains(const uint8_t* bytes, unsigned bits) const;
+    };
+
+    trie v4_;
+    trie v6_;
+    size_t ranges_ = 0;
+};
+
+// Compiled allow and deny lists of remote addresses. Immutable once built, so it can be
+// shared by the threads accepting connections while a new one replaces it.
+class remote_filter {
+public:
+    remote_filter() = default;
+
+    // Invalid entries are ignored with a warning; an allow list without valid entries allows nothing
+    remote_filter(const std::set<std::string>& allowed, const std::set<std::string>& forbidden);
+
+    // Whether a remote address is allowed: not forbidden, and allowed if there is an allow list
+    bool is_allowed(const boost::asio::ip::address& address) const;
+
+    // Whether there is nothing to check
+    bool empty() const { return !restricted_ && forbidden_.empty(); }
+
+private:
+    prefix_set allowed_;
+    prefix_set forbidden_;
+    bool restricted_ = false;
+};
+
+} // namespace thinger::asio
+
+#endif // THINGER_ASIO_REMOTE_FILTER_HPP
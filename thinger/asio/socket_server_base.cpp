@@ -12,6 +12,7 @@ socket_server_base::socket_server_base(io_context_provider acceptor_context_prov
     , acceptor_context_provider_(std::move(acceptor_context_provider))
     , connection_context_provider_(std::move(connection_context_provider))
 {
+    update_remote_filter();
 }
 
 void socket_server_base::set_max_listening_attempts(int attempts) {
@@ -23,21 +24,58 @@ void socket_server_base::set_handler(std::function<void(std::shared_ptr<socket>)
 }
 
 void socket_server_base::set_allowed_remotes(std::set<std::string> allowed) {
+    std::lock_guard<std::mutex> lock(remote_filter_mutex_);
     allowed_remotes_ = std::move(allowed);
+    update_remote_filter();
 }
 
 void socket_server_base::set_forbidden_remotes(std::set<std::string> forbidden) {
+    std::lock_guard<std::mutex> lock(remote_filter_mutex_);
     forbidden_remotes_ = std::move(forbidden);
+    update_remote_filter();
 }
 
-bool socket_server_base::is_remote_allowed(const std::string& remote_ip) const {
-    if (forbidden_remotes_.contains(remote_ip)) {
-        return false;
+void socket_server_base::set_remotes(std::set<std::string> allowed, std::set<std::string> forbidden) {
+    std::lock_guard<std::mutex> lock(remote_filter_mutex_);
+    allowed_remotes_ = std::move(allowed);
+    forbidden_remotes_ = std::move(forbidden);
+    update_remote_filter();
+}
+
+void socket_server_base::update_remote_filter() {
+    remote_filter_ = std::make_shared<const remote_filter>(allowed_remotes_, forbidden_remotes_);
+    // publish after the new filter is in place, so a cache never keeps an outdated one
+    remote_filter_version_.fetch_add(1, std::memory_order_release);
+}
+
+std::shared_ptr<const remote_filter> socket_server_base::get_remote_filter() const {
+    std::lock_guard<std::mutex> lock(remote_filter_mutex_);
+    return remote_filter_;
+}
+
+const remote_filter& socket_server_base::cached_remote_filter(remote_filter_cache& cache) const {
+    // lock free unless the lists changed since the last call
+    auto version = remote_filter_version_.load(std::memory_order_acquire);
+    if (cache.version != version) {
+        std::lock_guard<std::mutex> lock(remote_filter_mutex_);
+        cache.filter = remote_filter_;
+        cache.version = remote_filter_version_.load(std::memory_order_relaxed);
     }
-    if (!allowed_remotes_.empty() && !allowed_remotes_.contains(remote_ip)) {
-        return false;
+    return *cache.filter;
+}
+
+bool socket_server_base::is_remote_allowed(const std::string& remote_ip) const {
+    boost::system::error_code ec;
+    auto address = boost::asio::ip::make_address(remote_ip, ec);
+    if (ec) {
+        // not an address: only allowed if there is nothing to match it against
+        return get_remote_filter()->empty();
     }
-    return true;
+    return is_remote_allowed(address);
+}
+
+bool socket_server_base::is_remote_allowed(const boost::asio::ip::address& remote) const {
+    return get_remote_filter()->is_allowed(remote);
 }
 
 bool socket_server_base::start() {
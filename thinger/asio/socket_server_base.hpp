@@ -2,9 +2,12 @@
 #define THINGER_ASIO_SOCKET_SERVER_BASE_HPP
 
 #include "sockets/socket.hpp"
+#include "remote_filter.hpp"
 #include "../util/logger.hpp"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <functional>
 #include <boost/noncopyable.hpp>
@@ -32,6 +35,13 @@ public:
     void set_allowed_remotes(std::set<std::string> allowed);
     void set_forbidden_remotes(std::set<std::string> forbidden);
 
+    // Replace both lists at once. Entries are addresses or CIDR ranges ("10.0.0.0/8",
+    // "2001:db8::/32"); they can be changed while running, without blocking the accepts.
+    void set_remotes(std::set<std::string> allowed, std::set<std::string> forbidden);
+
+    // Compiled filter in use
+    std::shared_ptr<const remote_filter> get_remote_filter() const;
+
     // Control
     bool start();
     virtual bool stop();
@@ -47,6 +57,23 @@ protected:
     // Helper method for IP filtering
     bool is_remote_allowed(const std::string& remote_ip) const;
 
+    // IP filtering on the binary address, without formatting it (IPv4-mapped IPv6 addresses
+    // match their IPv4 entries)
+    bool is_remote_allowed(const boost::asio::ip::address& remote) const;
+
+    // Remote filter kept by an accepting thread, so it only takes the lock after a change
+    struct remote_filter_cache {
+        std::shared_ptr<const remote_filter> filter;
+        uint64_t version = 0;
+    };
+
+    // Current remote filter, refreshing the cache if the lists changed
+    const remote_filter& cached_remote_filter(remote_filter_cache& cache) const;
+
+private:
+    // compile the lists into a new filter (with remote_filter_mutex_ held)
+    void update_remote_filter();
+
 protected:
     std::function<void(std::shared_ptr<socket>)> handler_;
     std::set<std::string> allowed_remotes_;
@@ -57,6 +84,12 @@ protected:
     // io_context providers
     io_context_provider acceptor_context_provider_;
     io_context_provider connection_context_provider_;
+
+private:
+    // compiled lists, replaced as a whole on every change
+    mutable std::mutex remote_filter_mutex_;
+    std::shared_ptr<const remote_filter> remote_filter_;
+    std::atomic<uint64_t> remote_filter_version_{0};
 };
 
 } // namespace thinger::asio
@@ -1,19 +1,22 @@
 #include <iostream>
 #include "socket.hpp"
+#include "../io_context_load.hpp"
 
 namespace thinger::asio {
 
     std::atomic<unsigned long> socket::connections(0);
 
     socket::socket(const std::string& context, boost::asio::io_context& io_context)
-        : context_(context), io_context_(io_context) {
+        : context_(context), io_context_(io_context), io_context_load_(io_context_load::of(io_context)) {
         ++connections;
+        io_context_load_.fetch_add(1, std::memory_order_relaxed);
         std::lock_guard<std::mutex> lock(mutex_);
         context_count[context_]++;
     }
 
     socket::~socket() {
         --connections;
+        io_context_load_.fetch_sub(1, std::memory_order_relaxed);
         std::lock_guard<std::mutex> lock(mutex_);
         if (--context_count[context_] == 0) {
             context_count.erase(context_);
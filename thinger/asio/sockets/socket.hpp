@@ -2,9 +2,11 @@
 #ifndef THINGER_ASIO_SOCKET_HPP
 #define THINGER_ASIO_SOCKET_HPP
 
+#include <atomic>
 #include <mutex>
 #include <map>
 #include <string_view>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/asio/buffer.hpp>
@@ -57,8 +59,36 @@ public:
     boost::asio::io_context &get_io_context() const;
 
 protected:
+    // write a buffer sequence completely. async_write prepares at most 16 buffers per
+    // syscall, while async_write_some hands the whole sequence (up to 64 iovecs) to a
+    // single writev, so gathered writes are issued directly and resumed on partial writes
+    template<typename Stream>
+    static awaitable<io_result> write_gathered(Stream &stream, const std::vector<boost::asio::const_buffer> &buffers) {
+        const size_t total = boost::asio::buffer_size(buffers);
+        auto [ec, written] = co_await stream.async_write_some(buffers, use_nothrow_awaitable);
+        if (ec || written >= total) co_return io_result{ec, written};
+
+        // partial write: drop what was sent and continue with the remaining buffers
+        std::vector<boost::asio::const_buffer> pending(buffers);
+        size_t consumed = written;
+        while (!ec && written < total) {
+            auto it = pending.begin();
+            for (; it != pending.end() && consumed >= it->size(); ++it) consumed -= it->size();
+            pending.erase(pending.begin(), it);
+            pending.front() += consumed;
+
+            auto [write_ec, bytes] = co_await stream.async_write_some(pending, use_nothrow_awaitable);
+            ec = write_ec;
+            written += bytes;
+            consumed = bytes;
+        }
+        co_return io_result{ec, written};
+    }
+
     std::string context_;
     boost::asio::io_context &io_context_;
+    // open sockets of io_context_, for balancing new connections
+    std::atomic<size_t> &io_context_load_;
     static std::atomic<unsigned long> connections;
     static std::map<std::string, unsigned long> context_count;
     static std::mutex mutex_;
@@ -55,13 +55,13 @@ awaitable<boost::system::error_code> ssl_socket::handshake(const std::string& ho
 }
 
 awaitable<io_result> ssl_socket::read_some(uint8_t buffer[], size_t max_size) {
-    co_return co_await ssl_stream_.async_read_some(
+    return ssl_stream_.async_read_some(
         boost::asio::buffer(buffer, max_size),
         use_nothrow_awaitable);
 }
 
 awaitable<io_result> ssl_socket::read(uint8_t buffer[], size_t size) {
-    co_return co_await boost::asio::async_read(
+    return boost::asio::async_read(
         ssl_stream_,
         boost::asio::buffer(buffer, size),
         boost::asio::transfer_exactly(size),
@@ -69,7 +69,7 @@ awaitable<io_result> ssl_socket::read(uint8_t buffer[], size_t size) {
 }
 
 awaitable<io_result> ssl_socket::read(boost::asio::streambuf& buffer, size_t size) {
-    co_return co_await boost::asio::async_read(
+    return boost::asio::async_read(
         ssl_stream_,
         buffer,
         boost::asio::transfer_exactly(size),
@@ -77,7 +77,7 @@ awaitable<io_result> ssl_socket::read(boost::asio::streambuf& buffer, size_t siz
 }
 
 awaitable<io_result> ssl_socket::read_until(boost::asio::streambuf& buffer, std::string_view delim) {
-    co_return co_await boost::asio::async_read_until(
+    return boost::asio::async_read_until(
         ssl_stream_,
         buffer,
         std::string(delim),
@@ -85,21 +85,21 @@ awaitable<io_result> ssl_socket::read_until(boost::asio::streambuf& buffer, std:
 }
 
 awaitable<io_result> ssl_socket::write(const uint8_t buffer[], size_t size) {
-    co_return co_await boost::asio::async_write(
+    return boost::asio::async_write(
         ssl_stream_,
         boost::asio::buffer(buffer, size),
         use_nothrow_awaitable);
 }
 
 awaitable<io_result> ssl_socket::write(std::string_view str) {
-    co_return co_await boost::asio::async_write(
+    return boost::asio::async_write(
         ssl_stream_,
         boost::asio::buffer(str.data(), str.size()),
         use_nothrow_awaitable);
 }
 
 awaitable<io_result> ssl_socket::write(const std::vector<boost::asio::const_buffer>& buffers) {
-    co_return co_await boost::asio::async_write(
+    return boost::asio::async_write(
         ssl_stream_,
         buffers,
         use_nothrow_awaitable);
@@ -128,13 +128,13 @@ std::string tcp_socket::get_remote_port() const {
 }
 
 awaitable<io_result> tcp_socket::read_some(uint8_t* buffer, size_t max_size) {
-    co_return co_await socket_.async_read_some(
+    return socket_.async_read_some(
         boost::asio::buffer(buffer, max_size),
         use_nothrow_awaitable);
 }
 
 awaitable<io_result> tcp_socket::read(uint8_t* buffer, size_t size) {
-    co_return co_await boost::asio::async_read(
+    return boost::asio::async_read(
         socket_,
         boost::asio::buffer(buffer, size),
         boost::asio::transfer_exactly(size),
@@ -142,7 +142,7 @@ awaitable<io_result> tcp_socket::read(uint8_t* buffer, size_t size) {
 }
 
 awaitable<io_result> tcp_socket::read(boost::asio::streambuf& buffer, size_t size) {
-    co_return co_await boost::asio::async_read(
+    return boost::asio::async_read(
         socket_,
         buffer,
         boost::asio::transfer_exactly(size),
@@ -150,7 +150,7 @@ awaitable<io_result> tcp_socket::read(boost::asio::streambuf& buffer, size_t siz
 }
 
 awaitable<io_result> tcp_socket::read_until(boost::asio::streambuf& buffer, std::string_view delim) {
-    co_return co_await boost::asio::async_read_until(
+    return boost::asio::async_read_until(
         socket_,
         buffer,
         std::string(delim),
@@ -158,24 +158,21 @@ awaitable<io_result> tcp_socket::read_until(boost::asio::streambuf& buffer, std:
 }
 
 awaitable<io_result> tcp_socket::write(const uint8_t* buffer, size_t size) {
-    co_return co_await boost::asio::async_write(
+    return boost::asio::async_write(
         socket_,
         boost::asio::buffer(buffer, size),
         use_nothrow_awaitable);
 }
 
 awaitable<io_result> tcp_socket::write(std::string_view str) {
-    co_return co_await boost::asio::async_write(
+    return boost::asio::async_write(
         socket_,
         boost::asio::buffer(str.data(), str.size()),
         use_nothrow_awaitable);
 }
 
 awaitable<io_result> tcp_socket::write(const std::vector<boost::asio::const_buffer>& buffers) {
-    co_return co_await boost::asio::async_write(
-        socket_,
-        buffers,
-        use_nothrow_awaitable);
+    return write_gathered(socket_, buffers);
 }
 
 awaitable<boost::system::error_code> tcp_socket::wait(boost::asio::socket_base::wait_type type) {
@@ -14,6 +14,7 @@ websocket::websocket(std::shared_ptr<socket> sock, bool binary, bool server)
     : socket("websocket", sock->get_io_context())
     , socket_(sock)
     , timer_(sock->get_io_context())
+    , idle_timer_(sock->get_io_context())
     , binary_(binary)
     , server_role_(server) {
     ++connections;
@@ -34,30 +35,19 @@ void websocket::unmask(uint8_t buffer[], std::size_t size) {
 }
 
 void websocket::start_timeout() {
-    timer_.expires_after(CONNECTION_TIMEOUT_SECONDS);
-    timer_.async_wait([this](const boost::system::error_code& e) {
-        if (e) {
-            if (e != boost::asio::error::operation_aborted) {
-                LOG_ERROR("error on timeout: {}", e.message());
-            }
-            return;
-        }
-        if (data_received_) {
-            data_received_ = false;
-            return start_timeout();
+    // expires after CONNECTION_TIMEOUT_SECONDS without reading any frame
+    idle_timer_.start(CONNECTION_TIMEOUT_SECONDS, [this] {
+        if (!pending_ping_) {
+            pending_ping_ = true;
+            co_spawn(io_context_, [this]() -> awaitable<void> {
+                co_await send_ping();
+                if (socket_->is_open()) {
+                    start_timeout();
+                }
+            }, detached);
         } else {
-            if (!pending_ping_) {
-                pending_ping_ = true;
-                co_spawn(io_context_, [this]() -> awaitable<void> {
-                    co_await send_ping();
-                    if (socket_->is_open()) {
-                        start_timeout();
-                    }
-                }, detached);
-            } else {
-                LOG_DEBUG("websocket ping timeout... closing connection!");
-                close();
-            }
+            LOG_DEBUG("websocket ping timeout... closing connection!");
+            close();
         }
     });
 }
@@ -132,7 +122,7 @@ awaitable<size_t> websocket::read_frame(uint8_t buffer[], size_t max_size, boost
             co_return 0;
         }
     }
-    data_received_ = true;
+    idle_timer_.touch();
 
     uint8_t data_type = buffer_[0];
     uint8_t fin = data_type & 0b10000000;
@@ -257,7 +247,6 @@ awaitable<size_t> websocket::read_frame(uint8_t buffer[], size_t max_size, boost
             case 0xA: // pong
                 LOG_DEBUG("received pong frame");
                 pending_ping_ = false;
-                data_received_ = false;
                 co_return co_await read_frame(buffer, max_size, ec);
         }
     }
@@ -409,6 +398,7 @@ awaitable<boost::system::error_code> websocket::connect(
 
 void websocket::close() {
     timer_.cancel();
+    idle_timer_.cancel();
     socket_->close();
 }
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "socket.hpp"
+#include "../timing_wheel.hpp"
 #include <queue>
 #include <string_view>
 
@@ -72,6 +73,7 @@ private:
 
     std::shared_ptr<socket> socket_;
     boost::asio::steady_timer timer_;
+    wheel_timer idle_timer_;
     bool binary_;
     bool server_role_;
 
@@ -93,7 +95,6 @@ private:
     // Connection state
     bool close_received_ = false;
     bool close_sent_ = false;
-    bool data_received_ = true;
     bool pending_ping_ = false;
 
     // Write synchronization (for write ordering)
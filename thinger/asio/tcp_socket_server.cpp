@@ -3,6 +3,10 @@
 #include "../util/logger.hpp"
 #include "../util/types.hpp"
 #include <boost/asio/ssl.hpp>
+#include <algorithm>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
 
 namespace thinger::asio {
 
@@ -33,6 +37,7 @@ tcp_socket_server::tcp_socket_server(std::string host,
                        std::move(allowed_remotes), 
                        std::move(forbidden_remotes))
 {
+    listener_contexts_provider_ = []() { return get_workers().get_io_contexts(); };
 }
 
 tcp_socket_server::~tcp_socket_server() {
@@ -54,11 +59,14 @@ void tcp_socket_server::close_acceptor() {
     // destroy it (reset) here. The async_accept handler may still be in
     // flight on the io_context thread and needs the acceptor alive until
     // the handler completes. The unique_ptr will clean up on destruction.
-    if (acceptor_ && acceptor_->is_open()) {
-        boost::system::error_code ec;
-        acceptor_->close(ec);
-        if (ec) {
-            LOG_WARNING("Error closing TCP acceptor: {}", ec.message());
+    for (auto& listener : listeners_) {
+        auto& acceptor = listener->acceptor;
+        if (acceptor->is_open()) {
+            boost::system::error_code ec;
+            acceptor->close(ec);
+            if (ec) {
+                LOG_WARNING("Error closing TCP acceptor: {}", ec.message());
+            }
         }
     }
 }
@@ -67,6 +75,19 @@ void tcp_socket_server::set_tcp_no_delay(bool tcp_no_delay) {
     tcp_no_delay_ = tcp_no_delay;
 }
 
+void tcp_socket_server::enable_reuse_port(bool enabled, bool incoming_cpu) {
+    reuse_port_ = enabled;
+    incoming_cpu_ = incoming_cpu;
+}
+
+void tcp_socket_server::set_accept_budget(size_t connections) {
+    accept_budget_ = connections > 0 ? connections : 1;
+}
+
+void tcp_socket_server::set_listener_contexts_provider(io_contexts_provider provider) {
+    listener_contexts_provider_ = std::move(provider);
+}
+
 void tcp_socket_server::enable_ssl(bool ssl, bool client_certificate) {
     ssl_enabled_ = ssl;
     client_certificate_ = client_certificate;
@@ -87,7 +108,36 @@ std::string tcp_socket_server::get_service_name() const {
 }
 
 uint16_t tcp_socket_server::local_port() const {
-    return acceptor_ ? acceptor_->local_endpoint().port() : 0;
+    return listeners_.empty() ? 0 : listeners_.front()->acceptor->local_endpoint().port();
+}
+
+std::unique_ptr<boost::asio::ip::tcp::acceptor> tcp_socket_server::open_acceptor(
+    boost::asio::io_context& io_context, const boost::asio::ip::tcp::endpoint& endpoint, int incoming_cpu) {
+
+    auto acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(io_context);
+    acceptor->open(endpoint.protocol());
+    acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+    if (reuse_port_) {
+        acceptor->set_option(boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+    }
+#endif
+#ifdef SO_INCOMING_CPU
+    if (incoming_cpu >= 0) {
+        boost::system::error_code ec;
+        acceptor->set_option(boost::asio::detail::socket_option::integer<SOL_SOCKET, SO_INCOMING_CPU>(incoming_cpu), ec);
+        if (ec) {
+            LOG_WARNING("cannot set SO_INCOMING_CPU on {}:{}: {}", host_, port_, ec.message());
+        }
+    }
+#endif
+    LOG_DEBUG("binding and listening to endpoint: {}:{}", 
+             endpoint.address().to_string(), endpoint.port());
+    acceptor->bind(endpoint);
+    acceptor->listen();
+    // accepted in batches until the backlog is empty
+    acceptor->native_non_blocking(true);
+    return acceptor;
 }
 
 bool tcp_socket_server::create_acceptor() {
@@ -95,6 +145,19 @@ bool tcp_socket_server::create_acceptor() {
     
     // Get io_context from provider
     boost::asio::io_context& io_context = acceptor_context_provider_();
+
+    // Listeners run on the acceptor io_context, or on every listener io_context in reuse port mode
+    std::vector<std::reference_wrapper<boost::asio::io_context>> contexts;
+#ifdef SO_REUSEPORT
+    if (reuse_port_ && listener_contexts_provider_) {
+        contexts = listener_contexts_provider_();
+    }
+#else
+    if (reuse_port_) {
+        LOG_WARNING("SO_REUSEPORT is not supported: using a single listener");
+    }
+#endif
+    if (contexts.empty()) contexts.emplace_back(io_context);
     
     // Resolve endpoint
     boost::asio::ip::tcp::endpoint endpoint;
@@ -112,6 +175,8 @@ bool tcp_socket_server::create_acceptor() {
         LOG_ERROR("failed to resolve {}:{} - {}", host_, port_, e.code().message());
         return false;
     }
+
+    unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
     
     bool success = false;
     do {
@@ -120,21 +185,22 @@ bool tcp_socket_server::create_acceptor() {
             std::this_thread::sleep_for(std::chrono::seconds(5));
         }
         
-        acceptor_ = std::make_unique<boost::asio::ip::tcp::acceptor>(io_context);
-        acceptor_->open(endpoint.protocol());
-        acceptor_->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        
         try {
-            LOG_DEBUG("binding and listening to endpoint: {}:{}", 
-                     endpoint.address().to_string(), endpoint.port());
-            acceptor_->bind(endpoint);
-            acceptor_->listen();
+            listeners_.clear();
+            auto listen_endpoint = endpoint;
+            for (size_t i = 0; i < contexts.size(); ++i) {
+                int incoming_cpu = reuse_port_ && incoming_cpu_ ? static_cast<int>(i % cpus) : -1;
+                listeners_.emplace_back(std::make_unique<listener>());
+                listeners_.back()->acceptor = open_acceptor(contexts[i], listen_endpoint, incoming_cpu);
+                // with an ephemeral port, the other listeners join the port of the first one
+                listen_endpoint.port(listeners_.front()->acceptor->local_endpoint().port());
+            }
             success = true;
         } catch (boost::system::system_error& error) {
             LOG_ERROR("cannot start listening on {}:{}: {}", 
                      host_, port_, error.code().message());
-            // Reset acceptor if binding failed to avoid inconsistent state
-            acceptor_.reset();
+            // Reset acceptors if binding failed to avoid inconsistent state
+            listeners_.clear();
             if (max_listening_attempts_ >= 0 && num_attempts >= max_listening_attempts_) {
                 return false;
             }
@@ -143,91 +209,149 @@ bool tcp_socket_server::create_acceptor() {
     } while (!success && (max_listening_attempts_ < 0 || num_attempts < max_listening_attempts_));
 
     if (success) {
-        LOG_INFO("TCP server is now listening on {}:{}", host_, port_);
+        if (listeners_.size() > 1) {
+            LOG_INFO("TCP server is now listening on {}:{} ({} SO_REUSEPORT listeners)", host_, port_, listeners_.size());
+        } else {
+            LOG_INFO("TCP server is now listening on {}:{}", host_, port_);
+        }
     }
     
     return success;
 }
 
 void tcp_socket_server::accept_connection() {
-    // Get next io_context from provider
-    boost::asio::io_context& io_context = connection_context_provider_();
-    
-    // Create socket based on SSL configuration
-    std::shared_ptr<tcp_socket> sock;
-    if (ssl_enabled_) {
-        if (!ssl_context_) {
-            LOG_ERROR("SSL enabled but no SSL context configured");
-            return;
-        }
-        sock = std::make_shared<ssl_socket>("ssl_socket_server", io_context, ssl_context_);
-    } else {
-        sock = std::make_shared<tcp_socket>("tcp_socket_server", io_context);
+    for (auto& listener : listeners_) {
+        accept_connection(*listener);
     }
+}
 
-    auto& socket = sock->get_socket();
-    
-    // Start accepting a connection
-    acceptor_->async_accept(socket, [sock = std::move(sock), this](const boost::system::error_code& e) mutable {
+void tcp_socket_server::accept_connection(listener& listener) {
+    if (ssl_enabled_ && !ssl_context_) {
+        LOG_ERROR("SSL enabled but no SSL context configured");
+        return;
+    }
+
+    // Wait for pending connections, and accept them in a batch
+    listener.acceptor->async_wait(boost::asio::ip::tcp::acceptor::wait_read, [this, &listener](const boost::system::error_code& e) {
         if (!e) {
-            // Get remote socket ip
-            auto remote_ip = sock->get_remote_ip();
-
-            // Check if IP is allowed
-            if (!is_remote_allowed(remote_ip)) {
-                sock->close();
-                LOG_WARNING("rejecting connection from: ip: {}, port: {}, secure: {}", 
-                           remote_ip, sock->get_local_port(), sock->is_secure());
-                if (running_) accept_connection();
-                return;
-            }
+            accept_pending(listener);
+        } else if (e != boost::asio::error::operation_aborted) {
+            LOG_ERROR("cannot accept more connections: {}", e.message());
+            if (running_) retry_accept(listener);
+        } else {
+            LOG_INFO("stop accepting connections");
+        }
+    });
+}
 
-            LOG_INFO("received connection from: ip: {}, port: {}, secure: {}", 
-                    remote_ip, sock->get_local_port(), sock->is_secure());
+void tcp_socket_server::accept_pending(listener& listener) {
+    auto& acceptor = *listener.acceptor;
+    // filter lists in use for this batch, without locking unless they changed
+    const auto& filter = cached_remote_filter(listener.filter);
 
-            if (tcp_no_delay_) {
-                sock->enable_tcp_no_delay();
-            }
+    for (size_t accepted = 0; accepted < accept_budget_ && running_; ++accepted) {
+        boost::asio::ip::tcp::endpoint remote;
+        socklen_t size = static_cast<socklen_t>(remote.capacity());
+#ifdef __linux__
+        int fd = ::accept4(acceptor.native_handle(), remote.data(), &size, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        int fd = ::accept(acceptor.native_handle(), remote.data(), &size);
+#endif
+        if (fd < 0) {
+            boost::system::error_code ec(errno, boost::asio::error::get_system_category());
+            // nothing else pending: wait for the next readiness event
+            if (ec == boost::asio::error::would_block || ec == boost::asio::error::try_again) break;
+            // the peer gave up before being accepted
+            if (ec == boost::asio::error::connection_aborted || ec == boost::asio::error::interrupted) continue;
+            // out of descriptors or similar: retry later to avoid a tight loop
+            LOG_ERROR("cannot accept more connections: {}", ec.message());
+            retry_accept(listener);
+            return;
+        }
+        remote.resize(size);
 
-            if (sock->requires_handshake()) {
-                // Use co_spawn to run the coroutine-based handshake
-                co_spawn(sock->get_io_context(),
-                    [this, sock]() -> awaitable<void> {
-                        auto ec = co_await sock->handshake();
-                        if (ec) {
-                            LOG_ERROR("error while handling SSL handshake: {}, remote ip: {}",
-                                     ec.message(), sock->get_remote_ip());
-                            co_return;
-                        }
-                        if (handler_) handler_(sock);
-                    },
-                    detached);
-            } else {
-                if (handler_) handler_(std::move(sock));
-            }
+        // Check if IP is allowed, before creating any socket object
+        if (!filter.empty() && !filter.is_allowed(remote.address())) {
+            ::close(fd);
+            log_rejected(remote);
+            continue;
+        }
 
-            // Continue accepting connections
-            if (running_) accept_connection();
+        // Connections stay on the listener thread in reuse port mode, or take the next io_context
+        boost::asio::io_context& io_context = listeners_.size() > 1 ?
+            static_cast<boost::asio::io_context&>(acceptor.get_executor().context()) :
+            connection_context_provider_();
+
+        // Create socket based on SSL configuration
+        std::shared_ptr<tcp_socket> sock;
+        if (ssl_enabled_) {
+            sock = std::make_shared<ssl_socket>("ssl_socket_server", io_context, ssl_context_);
         } else {
-            if (e != boost::asio::error::operation_aborted) {
-                LOG_ERROR("cannot accept more connections: {}", e.message());
-                if (running_) {
-                    // Retry after a delay to avoid tight loop on persistent errors
-                    auto timer = std::make_shared<boost::asio::steady_timer>(
-                        acceptor_context_provider_(),
-                        std::chrono::seconds(1)
-                    );
-                    timer->async_wait([this, timer](const boost::system::error_code& e) {
-                        if (e != boost::asio::error::operation_aborted) {
-                            accept_connection();
-                        }
-                    });
-                }
-            } else {
-                LOG_INFO("stop accepting connections");
-            }
+            sock = std::make_shared<tcp_socket>("tcp_socket_server", io_context);
+        }
+
+        boost::system::error_code ec;
+        sock->get_socket().assign(remote.protocol(), fd, ec);
+        if (ec) {
+            LOG_ERROR("cannot assign accepted connection: {}", ec.message());
+            ::close(fd);
+            continue;
+        }
+
+        if (LOG_DEBUG_ENABLED()) {
+            LOG_DEBUG("received connection from: ip: {}, port: {}, secure: {}",
+                     remote.address().to_string(), remote.port(), sock->is_secure());
+        }
+
+        if (tcp_no_delay_) {
+            sock->enable_tcp_no_delay();
+        }
+
+        if (sock->requires_handshake()) {
+            // Use co_spawn to run the coroutine-based handshake
+            co_spawn(sock->get_io_context(),
+                [this, sock]() -> awaitable<void> {
+                    auto ec = co_await sock->handshake();
+                    if (ec) {
+                        LOG_ERROR("error while handling SSL handshake: {}, remote ip: {}",
+                                 ec.message(), sock->get_remote_ip());
+                        co_return;
+                    }
+                    if (handler_) handler_(sock);
+                },
+                detached);
+        } else {
+            if (handler_) handler_(std::move(sock));
+        }
+    }
+
+    // Continue accepting connections (right away if the budget was exhausted, after
+    // the handlers queued meanwhile got their turn)
+    if (running_) accept_connection(listener);
+}
+
+void tcp_socket_server::retry_accept(listener& listener) {
+    // Retry after a delay to avoid tight loop on persistent errors
+    auto timer = std::make_shared<boost::asio::steady_timer>(
+        listener.acceptor->get_executor(),
+        std::chrono::seconds(1)
+    );
+    timer->async_wait([this, timer, &listener](const boost::system::error_code& e) {
+        if (e != boost::asio::error::operation_aborted && running_) {
+            accept_connection(listener);
         }
     });
 }
 
+void tcp_socket_server::log_rejected(const boost::asio::ip::tcp::endpoint& remote) {
+    // one warning per second at most, so a flood of rejected connections does not flood the log
+    auto rejected = rejected_connections_.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (last_rejection_log_.exchange(now, std::memory_order_relaxed) != now) {
+        LOG_WARNING("rejecting connection from: ip: {}, port: {} ({} rejected connections so far)",
+                   remote.address().to_string(), remote.port(), rejected);
+    }
+}
+
 } // namespace thinger::asio
\ No newline at end of file
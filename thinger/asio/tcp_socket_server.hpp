@@ -5,11 +5,19 @@
 #include "sockets/tcp_socket.hpp"
 #include "sockets/ssl_socket.hpp"
 #include <boost/asio/ssl.hpp>
+#include <atomic>
+#include <vector>
 
 namespace thinger::asio {
 
+// Type for providing the io_contexts that run one listener each in reuse port mode
+using io_contexts_provider = std::function<std::vector<std::reference_wrapper<boost::asio::io_context>>()>;
+
 class tcp_socket_server : public socket_server_base {
 public:
+    // connections accepted per readiness event before other handlers get their turn
+    static constexpr size_t DEFAULT_ACCEPT_BUDGET = 64;
+
     // Constructor with io_context providers
     tcp_socket_server(std::string host, 
                      std::string port,
@@ -31,6 +39,17 @@ public:
 
     // TCP specific configuration
     void set_tcp_no_delay(bool tcp_no_delay);
+
+    // Open one SO_REUSEPORT listener per io_context of the provider (the worker threads with
+    // the legacy constructor), so the kernel spreads the accepts and each connection stays
+    // on the thread that accepted it. With incoming_cpu, listener i is also bound to CPU i
+    // with SO_INCOMING_CPU, so connections are preferably accepted by the thread on the CPU
+    // that received them. Linux only; a single listener is used where it is not supported.
+    void enable_reuse_port(bool enabled = true, bool incoming_cpu = false);
+    void set_listener_contexts_provider(io_contexts_provider provider);
+
+    // Maximum connections accepted per readiness event of a listener
+    void set_accept_budget(size_t connections);
     
     // SSL configuration
     void enable_ssl(bool ssl = true, bool client_certificate = false);
@@ -49,12 +68,44 @@ protected:
     void accept_connection() override;
 
 private:
+    // a listening acceptor, with the remote filter used by the thread accepting on it
+    struct listener {
+        std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
+        remote_filter_cache filter;
+    };
+
     void close_acceptor();
-    
-    std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
+
+    // open, bind and listen an acceptor on the given io_context
+    std::unique_ptr<boost::asio::ip::tcp::acceptor> open_acceptor(boost::asio::io_context& io_context,
+                                                                  const boost::asio::ip::tcp::endpoint& endpoint,
+                                                                  int incoming_cpu);
+
+    // wait for connections on one of the listeners
+    void accept_connection(listener& listener);
+
+    // accept the pending connections of a ready listener, up to the accept budget
+    void accept_pending(listener& listener);
+
+    // wait again for connections after an accept error
+    void retry_accept(listener& listener);
+
+    // log a rejected connection, at most once per second
+    void log_rejected(const boost::asio::ip::tcp::endpoint& remote);
+
+    // listeners: a single one, or one per io_context in reuse port mode
+    std::vector<std::unique_ptr<listener>> listeners_;
     std::string host_;
     std::string port_;
     bool tcp_no_delay_ = true;
+    size_t accept_budget_ = DEFAULT_ACCEPT_BUDGET;
+    std::atomic<uint64_t> rejected_connections_{0};
+    std::atomic<int64_t> last_rejection_log_{-1};
+
+    // reuse port mode
+    bool reuse_port_ = false;
+    bool incoming_cpu_ = false;
+    io_contexts_provider listener_contexts_provider_;
     
     // SSL configuration
     bool ssl_enabled_ = false;
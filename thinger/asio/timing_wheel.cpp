@@ -0,0 +1,182 @@
+#include "timing_wheel.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace thinger::asio{
+
+    boost::asio::execution_context::id timing_wheel::id;
+
+    timing_wheel::timing_wheel(boost::asio::io_context& io_context) :
+        boost::asio::execution_context::service(io_context),
+        timer_(io_context),
+        epoch_(std::chrono::steady_clock::now()){
+        // empty slots point to themselves
+        for(auto& slot : slots_){
+            slot.prev = slot.next = &slot;
+        }
+    }
+
+    timing_wheel::~timing_wheel() = default;
+
+    timing_wheel& timing_wheel::get(boost::asio::io_context& io_context){
+        return boost::asio::use_service<timing_wheel>(io_context);
+    }
+
+    void timing_wheel::shutdown(){
+        // the io_context is going away: detach the timers without running their handlers,
+        // releasing the handlers too, as they may hold their own owner alive
+        std::vector<std::function<void()>> handlers;
+        {
+            std::scoped_lock lock(mutex_);
+            handlers.reserve(size_);
+            for(auto& slot : slots_){
+                while(slot.next != &slot){
+                    auto& timer = static_cast<wheel_timer&>(*slot.next);
+                    unlink(timer);
+                    handlers.push_back(std::move(timer.handler_));
+                    timer.handler_ = nullptr;
+                }
+            }
+        }
+        ticking_ = false;
+        // destroyed once the slots are empty and unlocked, as owners destroyed here may
+        // own other timers
+        handlers.clear();
+    }
+
+    void timing_wheel::link(wheel_timer& timer){
+        insert(timer);
+        timer.armed_.store(true, std::memory_order_release);
+        ++size_;
+    }
+
+    void timing_wheel::unlink(wheel_timer& timer){
+        remove(timer);
+        timer.armed_.store(false, std::memory_order_release);
+        --size_;
+    }
+
+    void timing_wheel::insert(wheel_timer& timer){
+        hook& slot = slots_[timer.expiry() % SLOTS];
+        timer.prev = slot.prev;
+        timer.next = &slot;
+        slot.prev->next = &timer;
+        slot.prev = &timer;
+    }
+
+    void timing_wheel::remove(wheel_timer& timer){
+        timer.prev->next = timer.next;
+        timer.next->prev = timer.prev;
+        timer.prev = timer.next = nullptr;
+    }
+
+    uint64_t timing_wheel::clock_ticks() const{
+        return static_cast<uint64_t>((std::chrono::steady_clock::now() - epoch_) / TICK);
+    }
+
+    void timing_wheel::schedule(){
+        if(ticking_) return;
+        // the wheel stops while empty, so catch up with the clock before arming again
+        ticking_ = true;
+        now_ = clock_ticks();
+        timer_.expires_at(epoch_ + (now_ + 1) * TICK);
+        timer_.async_wait([this](const boost::system::error_code& ec){
+            on_tick(ec);
+        });
+    }
+
+    void timing_wheel::on_tick(const boost::system::error_code& ec){
+        if(ec || !ticking_) return;
+
+        // visit every slot between the last tick and now (each one at most once)
+        uint64_t target = clock_ticks();
+        if(target - now_ > SLOTS) now_ = target - SLOTS;
+        while(now_ < target){
+            ++now_;
+            process_slot(slots_[now_ % SLOTS]);
+        }
+
+        bool empty;
+        {
+            std::scoped_lock lock(mutex_);
+            empty = size_ == 0;
+        }
+        if(empty){
+            // nothing left to expire: stop ticking so an idle io_context can return
+            ticking_ = false;
+            return;
+        }
+
+        timer_.expires_at(epoch_ + (now_ + 1) * TICK);
+        timer_.async_wait([this](const boost::system::error_code& ec){
+            on_tick(ec);
+        });
+    }
+
+    void timing_wheel::process_slot(hook& slot){
+        std::unique_lock lock(mutex_);
+        if(slot.next == &slot) return;
+
+        // move the slot contents to a local list, so timers re-armed by a handler
+        // (or linked back below) are not visited again in this pass
+        hook pending;
+        pending.next = slot.next;
+        pending.prev = slot.prev;
+        pending.next->prev = &pending;
+        pending.prev->next = &pending;
+        slot.prev = slot.next = &slot;
+
+        while(pending.next != &pending){
+            auto& timer = static_cast<wheel_timer&>(*pending.next);
+            if(timer.expiry() > now_){
+                // touched since it was linked here: move it to its current deadline
+                remove(timer);
+                insert(timer);
+                continue;
+            }
+            unlink(timer);
+            // expired: the handler may re-arm the timer or destroy its owner, so it runs
+            // and is destroyed unlocked; timers cancelled meanwhile leave the pending list
+            auto handler = std::move(timer.handler_);
+            timer.handler_ = nullptr;
+            lock.unlock();
+            if(handler) handler();
+            handler = nullptr;
+            lock.lock();
+        }
+    }
+
+    wheel_timer::wheel_timer(boost::asio::io_context& io_context) :
+        wheel_(&timing_wheel::get(io_context)){
+    }
+
+    wheel_timer::~wheel_timer(){
+        cancel();
+    }
+
+    void wheel_timer::start(std::chrono::milliseconds timeout, std::function<void()> handler){
+        cancel();
+        // round up to whole ticks, plus one as activity is only recorded with tick resolution
+        auto ticks = (timeout + timing_wheel::TICK - std::chrono::milliseconds{1}) / timing_wheel::TICK;
+        timeout_ticks_ = static_cast<uint64_t>(std::max<int64_t>(ticks, 0)) + 1;
+        wheel_->schedule();
+        last_activity_ = wheel_->now_;
+        std::scoped_lock lock(wheel_->mutex_);
+        handler_ = std::move(handler);
+        wheel_->link(*this);
+    }
+
+    void wheel_timer::cancel(){
+        // disarmed timers only hold an empty handler
+        if(!is_armed()) return;
+        std::function<void()> handler;
+        {
+            std::scoped_lock lock(wheel_->mutex_);
+            if(is_armed()) wheel_->unlink(*this);
+            handler = std::move(handler_);
+            handler_ = nullptr;
+        }
+        // destroyed unlocked, as it may own other timers
+    }
+
+}
@@ -0,0 +1,119 @@
+#ifndef THINGER_ASIO_TIMING_WHEEL_HPP
+#define THINGER_ASIO_TIMING_WHEEL_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+namespace thinger::asio{
+
+    class wheel_timer;
+
+    // Hashed timing wheel shared by all the idle timeouts of an io_context. A single
+    // steady_timer ticks every TICK while any timer is armed, and each tick only
+    // visits the slot whose deadlines fall on it. Activity on a connection just
+    // stores the current tick in its wheel_timer; the deadline is re-evaluated
+    // lazily when its slot comes up, so keep-alive traffic never touches the
+    // reactor's timer queue.
+    //
+    // Timers are armed, touched and expired on the thread running the io_context
+    // (worker io_contexts run on a single thread). As with steady_timer, they can
+    // be cancelled and destroyed from any thread, i.e., when the last reference to
+    // a connection is released elsewhere, so the slots are guarded by a mutex that
+    // is uncontended on the io_context thread.
+    class timing_wheel : public boost::asio::execution_context::service {
+    public:
+        static boost::asio::execution_context::id id;
+
+        static constexpr auto TICK = std::chrono::milliseconds{250};
+        static constexpr size_t SLOTS = 512;    // one lap covers 128 seconds
+
+        explicit timing_wheel(boost::asio::io_context& io_context);
+        ~timing_wheel() override;
+
+        // Wheel associated with the given io_context (created on first use)
+        static timing_wheel& get(boost::asio::io_context& io_context);
+
+        // Current tick
+        uint64_t now() const { return now_; }
+
+        // Number of armed timers
+        size_t size() const { return size_; }
+
+    private:
+        friend class wheel_timer;
+
+        struct hook{
+            hook* prev = nullptr;
+            hook* next = nullptr;
+        };
+
+        void shutdown() override;
+
+        // all of them require mutex_; link and unlink arm and disarm the timer, while
+        // insert and remove only move it, so it never looks disarmed while moved
+        void link(wheel_timer& timer);
+        void unlink(wheel_timer& timer);
+        void insert(wheel_timer& timer);
+        void remove(wheel_timer& timer);
+
+        uint64_t clock_ticks() const;
+        void schedule();
+        void on_tick(const boost::system::error_code& ec);
+        void process_slot(hook& slot);
+
+        boost::asio::steady_timer timer_;
+        // guards the slots, size_ and the handlers of the armed timers
+        std::mutex mutex_;
+        std::chrono::steady_clock::time_point epoch_;
+        std::array<hook, SLOTS> slots_;
+        uint64_t now_ = 0;
+        size_t size_ = 0;
+        bool ticking_ = false;
+    };
+
+    // Idle timeout handled by the timing_wheel of an io_context. The handler runs
+    // once the timer has gone `timeout` without a touch(), between timeout and
+    // timeout + one TICK after the last activity. It is disarmed before the handler
+    // runs, so the handler may start it again or destroy its owner.
+    class wheel_timer : private timing_wheel::hook {
+    public:
+        explicit wheel_timer(boost::asio::io_context& io_context);
+        ~wheel_timer();
+
+        wheel_timer(const wheel_timer&) = delete;
+        wheel_timer& operator=(const wheel_timer&) = delete;
+
+        // Arm (or re-arm) the timer, replacing any previous timeout and handler
+        void start(std::chrono::milliseconds timeout, std::function<void()> handler);
+
+        // Record activity, postponing the expiration by a full timeout
+        void touch() { last_activity_ = wheel_->now_; }
+
+        // Disarm the timer without calling the handler (from any thread)
+        void cancel();
+
+        bool is_armed() const { return armed_.load(std::memory_order_acquire); }
+
+    private:
+        friend class timing_wheel;
+
+        uint64_t expiry() const { return last_activity_ + timeout_ticks_; }
+
+        timing_wheel* wheel_;
+        uint64_t last_activity_ = 0;
+        uint64_t timeout_ticks_ = 0;
+        std::function<void()> handler_;
+        // whether it is linked in a slot, readable without the lock, so a disarmed timer
+        // never touches its wheel, which may be gone with its io_context
+        std::atomic<bool> armed_{false};
+    };
+
+}
+
+#endif
@@ -1,10 +1,53 @@
 #include "worker_thread.hpp"
+#include "io_context_load.hpp"
 #include "../util/logger.hpp"
 #include <future>
+#include <filesystem>
 #include <boost/asio/dispatch.hpp>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace thinger::asio{
 
+    namespace {
+
+        thread_local int this_thread_numa_node = -1;
+
+        // the sysfs directory of a CPU has a nodeN link to its NUMA node
+        int numa_node_of(int cpu) {
+#ifdef __linux__
+            std::error_code ec;
+            std::filesystem::directory_iterator it("/sys/devices/system/cpu/cpu" + std::to_string(cpu), ec);
+            for(; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)){
+                auto name = it->path().filename().string();
+                if(name.size() > 4 && name.starts_with("node")){
+                    try{
+                        return std::stoi(name.substr(4));
+                    }catch(const std::exception&){
+                        return -1;
+                    }
+                }
+            }
+#endif
+            return -1;
+        }
+
+        bool pin_to_cpu(int cpu) {
+#ifdef __linux__
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+            return false;
+#endif
+        }
+
+    }
+
     std::thread::id worker_thread::start() {
         if(thread_.joinable()) return thread_.get_id();
 
@@ -12,6 +55,17 @@ namespace thinger::asio{
         thread_ = std::thread([this, &promise]{
             LOG_DEBUG("worker thread started: {}", worker_name_);
 
+            if(cpu_ >= 0){
+                if(pin_to_cpu(cpu_)){
+                    this_thread_numa_node = numa_node_;
+                    LOG_DEBUG("[{}] pinned to cpu {} (numa node {})", worker_name_, cpu_, numa_node_);
+                }else{
+                    LOG_WARNING("[{}] cannot pin thread to cpu {}", worker_name_, cpu_);
+                }
+            }
+
+            if(monitor_.enabled()) monitor_.attach();
+
             // start the async work in the child
             async_worker();
 
@@ -45,7 +99,9 @@ namespace thinger::asio{
     }
 
     worker_thread::worker_thread(std::string worker_name) :
-        worker_name_(std::move(worker_name))
+        worker_name_(std::move(worker_name)),
+        load_(io_context_load::of(worker_.get_io_context())),
+        monitor_(worker_, worker_name_)
     {
     }
 
@@ -57,6 +113,19 @@ namespace thinger::asio{
         worker_name_ = std::move(worker_name);
     }
 
+    void worker_thread::enable_loop_monitor(std::chrono::milliseconds interval){
+        monitor_.start(interval);
+    }
+
+    void worker_thread::set_cpu(int cpu){
+        cpu_ = cpu;
+        numa_node_ = cpu >= 0 ? numa_node_of(cpu) : -1;
+    }
+
+    int worker_thread::current_numa_node(){
+        return this_thread_numa_node;
+    }
+
     void worker_thread::run(std::function<void()> handler) {
         boost::asio::dispatch(worker_.get_io_context(), std::move(handler));
     }
@@ -1,8 +1,10 @@
 #ifndef THINGER_ASIO_WORKER_THREAD_HPP
 #define THINGER_ASIO_WORKER_THREAD_HPP
 
+#include <atomic>
 #include <thread>
 #include "io_worker.hpp"
+#include "loop_monitor.hpp"
 
 namespace thinger::asio{
     class worker_thread {
@@ -12,6 +14,27 @@ namespace thinger::asio{
 
         void set_thread_name(std::string worker_name);
 
+        /// pin the thread to a CPU when started (Linux only), so it also allocates from
+        /// the memory of the CPU's NUMA node; a negative value leaves it unpinned
+        void set_cpu(int cpu);
+        int get_cpu() const { return cpu_; }
+
+        /// NUMA node of the pinned CPU, or -1 if unpinned or unknown
+        int get_numa_node() const { return numa_node_; }
+
+        /// NUMA node of the calling thread if it is a pinned worker thread, or -1
+        static int current_numa_node();
+
+        /// open sockets running on the io_context of this worker
+        size_t get_load() const { return load_.load(std::memory_order_relaxed); }
+
+        /// probe the event loop lag and queue depth every interval, and record marked
+        /// handlers for a watchdog; call before start
+        void enable_loop_monitor(std::chrono::milliseconds interval);
+        loop_monitor& get_loop_monitor() { return monitor_; }
+
+        const std::string& get_name() const { return worker_name_; }
+
         boost::asio::io_context& get_io_context();
 
         std::thread::id start();
@@ -24,7 +47,11 @@ namespace thinger::asio{
     private:
         std::thread thread_;
         std::string worker_name_;
+        int cpu_ = -1;
+        int numa_node_ = -1;
         io_worker worker_;
+        std::atomic<size_t>& load_;
+        loop_monitor monitor_;
     };
 }
 
@@ -3,6 +3,7 @@
 #include <boost/asio/post.hpp>
 #include <mutex>
 #include <algorithm>
+#include "io_uring.hpp"
 #include "../util/logger.hpp"
 
 namespace thinger::asio{
@@ -61,17 +62,35 @@ namespace thinger::asio{
     {
         std::scoped_lock<std::mutex> lock(mutex_);
         if(running_) return false;
-        running_ = true;
 
-        LOG_INFO("starting {} working threads in the shared pool", worker_threads);
+        // sockets on io_uring have no runtime fallback: event loops could not run at all
+        if(io_uring_sockets() && !io_uring_supported()){
+            LOG_ERROR("io_uring is not supported by this kernel: build with THINGER_HTTP_IO_URING_SOCKETS=OFF to use epoll");
+            return false;
+        }
+
+        running_ = true;
+        LOG_INFO("starting {} working threads in the shared pool ({})", worker_threads, io_backend());
         worker_threads_.reserve(worker_threads);
+        auto cpus = std::max(1u, std::thread::hardware_concurrency());
         for(auto thread_number=1; thread_number<=worker_threads; ++thread_number){
             auto worker = std::make_unique<worker_thread>("worker thread " + std::to_string(thread_number));
+            if(pin_threads_){
+                auto index = thread_number - 1;
+                worker->set_cpu(cpus_.empty() ? static_cast<int>(index % cpus) : static_cast<int>(cpus_[index % cpus_.size()]));
+            }
+            worker->enable_loop_monitor(lag_interval_);
             auto id = worker->start();
             workers_threads_map_.emplace(id, *worker);
             worker_threads_.emplace_back(std::move(worker));
         }
 
+        if(lag_interval_.count() > 0){
+            std::scoped_lock<std::mutex> watchdog_lock(watchdog_mutex_);
+            watchdog_running_ = true;
+            watchdog_ = std::thread([this]{ run_watchdog(); });
+        }
+
         return running_;
     }
 
@@ -109,6 +128,8 @@ namespace thinger::asio{
             }
         }
         
+        stop_watchdog();
+
         // Stop all job threads
         LOG_INFO("stopping job threads");
         for(auto const& worker_thread : job_threads_){
@@ -121,12 +142,23 @@ namespace thinger::asio{
             worker_thread->stop();
         }
 
+        // Stop the offload pool before the io_contexts its jobs resume on are gone
+        std::unique_ptr<offload_pool> pool;
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+            pool = std::move(offload_pool_);
+        }
+        if(pool){
+            LOG_INFO("stopping offload pool");
+            pool.reset();
+        }
+
         // Clear auxiliary references
         LOG_INFO("clearing structures");
         worker_threads_.clear();
         job_threads_.clear();
         workers_threads_map_.clear();
-        next_io_context_ = 0;
+        next_io_context_.store(0, std::memory_order_relaxed);
 
         // Cancel signals and stop wait_context
         LOG_INFO("stopping wait context");
@@ -171,11 +203,120 @@ namespace thinger::asio{
         return true;
     }
 
+    void workers::set_cpu_affinity(bool enabled, std::vector<unsigned> cpus)
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        pin_threads_ = enabled;
+        cpus_ = std::move(cpus);
+    }
+
+    void workers::enable_loop_monitor(std::chrono::milliseconds lag_interval,
+                                      std::chrono::milliseconds block_threshold,
+                                      std::function<void(const blocked_handler&)> on_blocked)
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        lag_interval_ = lag_interval;
+        block_threshold_ = block_threshold;
+        on_blocked_ = std::move(on_blocked);
+    }
+
+    std::vector<loop_stats> workers::get_loop_stats()
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        std::vector<loop_stats> stats;
+        stats.reserve(worker_threads_.size());
+        for(auto const& worker_thread : worker_threads_){
+            stats.emplace_back(worker_thread->get_loop_monitor().get_stats());
+        }
+        return stats;
+    }
+
+    void workers::set_offload_pool(size_t threads, size_t max_pending)
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        offload_threads_ = threads;
+        offload_max_pending_ = max_pending;
+    }
+
+    offload_pool& workers::get_offload_pool()
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        if(!offload_pool_){
+            offload_pool_ = std::make_unique<offload_pool>(offload_threads_, offload_max_pending_);
+        }
+        return *offload_pool_;
+    }
+
+    void workers::run_watchdog()
+    {
+        // check several times per threshold, so blocks are reported soon after crossing it
+        auto period = std::max(std::chrono::milliseconds(1), std::min(lag_interval_, block_threshold_ / 4));
+        std::unique_lock<std::mutex> lock(watchdog_mutex_);
+        while(!watchdog_cv_.wait_for(lock, period, [this]{ return !watchdog_running_; })){
+            for(auto const& worker_thread : worker_threads_){
+                auto blocked = worker_thread->get_loop_monitor().check(block_threshold_);
+                if(!blocked) continue;
+                if(on_blocked_){
+                    on_blocked_(*blocked);
+                }else if(blocked->marker.empty()){
+                    LOG_WARNING("[{}] event loop blocked for {} ms", blocked->thread, blocked->blocked.count());
+                }else{
+                    LOG_WARNING("[{}] handler '{}' has blocked the event loop for {} ms",
+                                blocked->thread, blocked->marker, blocked->blocked.count());
+                }
+            }
+        }
+    }
+
+    void workers::stop_watchdog()
+    {
+        {
+            std::scoped_lock<std::mutex> lock(watchdog_mutex_);
+            if(!watchdog_running_) return;
+            watchdog_running_ = false;
+        }
+        watchdog_cv_.notify_all();
+        if(watchdog_.joinable()) watchdog_.join();
+    }
+
 	boost::asio::io_context& workers::get_next_io_context()
 	{
-        return worker_threads_[next_io_context_++%worker_threads_.size()]->get_io_context();
+        auto count = worker_threads_.size();
+        auto next = next_io_context_.fetch_add(1, std::memory_order_relaxed);
+        auto selection = selection_.load(std::memory_order_relaxed);
+        int node = worker_thread::current_numa_node();
+        if(selection == io_context_selection::round_robin && node < 0){
+            return worker_threads_[next % count]->get_io_context();
+        }
+
+        // scan from the round-robin position, so equally loaded io_contexts are used in turns
+        worker_thread* selected = nullptr;
+        size_t selected_load = 0;
+        for(size_t i=0; i<count; ++i){
+            auto& worker = *worker_threads_[(next + i) % count];
+            // keep connections on the NUMA node of the calling worker
+            if(node >= 0 && worker.get_numa_node() != node) continue;
+            if(selection == io_context_selection::round_robin) return worker.get_io_context();
+            auto load = worker.get_load();
+            if(!selected || load < selected_load){
+                selected = &worker;
+                selected_load = load;
+            }
+        }
+        return selected ? selected->get_io_context() : worker_threads_[next % count]->get_io_context();
 	}
 
+    std::vector<std::reference_wrapper<boost::asio::io_context>> workers::get_io_contexts()
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        std::vector<std::reference_wrapper<boost::asio::io_context>> io_contexts;
+        io_contexts.reserve(worker_threads_.size());
+        for(auto const& worker_thread : worker_threads_){
+            io_contexts.emplace_back(worker_thread->get_io_context());
+        }
+        return io_contexts;
+    }
+
 	boost::asio::io_context& workers::get_thread_io_context()
 	{
         std::thread::id this_id = std::this_thread::get_id();
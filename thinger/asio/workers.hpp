@@ -3,12 +3,20 @@
 
 #include <unordered_map>
 #include <set>
+#include <condition_variable>
 #include <boost/asio.hpp>
 #include "worker_thread.hpp"
 #include "worker_client.hpp"
+#include "offload_pool.hpp"
 
 namespace thinger::asio {
 
+    /// how get_next_io_context spreads new connections among the worker threads
+    enum class io_context_selection {
+        round_robin,        ///< in turns
+        least_connections   ///< the io_context with the fewest open sockets
+    };
+
 	class workers {
 	public:
         workers();
@@ -29,12 +37,43 @@ namespace thinger::asio {
         /// return an isolated io_context not shared in the pool
         boost::asio::io_context& get_isolated_io_context(std::string thread_name);
 
-        /// return the next io_context (round-robin)
+        /// return the next io_context, chosen as configured with set_io_context_selection. When
+        /// called from a pinned worker thread, io_contexts on its NUMA node are preferred
         boost::asio::io_context& get_next_io_context();
 
+        /// choose the io_context of new connections in turns (default) or by load
+        void set_io_context_selection(io_context_selection selection) { selection_ = selection; }
+        io_context_selection get_io_context_selection() const { return selection_; }
+
+        /// pin each worker thread to one CPU, taken in order from the given list (wrapping
+        /// around), or CPUs 0..n-1 if it is empty. Applied on the next start; Linux only
+        void set_cpu_affinity(bool enabled = true, std::vector<unsigned> cpus = {});
+
+        /// measure the event loop lag and queue depth of each worker thread every
+        /// lag_interval, and run a watchdog reporting handlers that block a loop longer than
+        /// block_threshold (logged as warnings, or passed to on_blocked). Handlers are named
+        /// after their route pattern. Applied on the next start
+        void enable_loop_monitor(std::chrono::milliseconds lag_interval = std::chrono::milliseconds(100),
+                                 std::chrono::milliseconds block_threshold = std::chrono::milliseconds(500),
+                                 std::function<void(const blocked_handler&)> on_blocked = {});
+
+        /// event loop statistics, one per worker thread (zero if the monitor is not enabled)
+        std::vector<loop_stats> get_loop_stats();
+
+        /// size the pool for offloaded CPU-bound jobs (0 threads means one per hardware
+        /// thread) and the jobs it accepts before rejecting new ones; takes effect when the
+        /// pool is created, on first use
+        void set_offload_pool(size_t threads, size_t max_pending = offload_pool::DEFAULT_MAX_PENDING);
+
+        /// pool for offloaded jobs (see thinger::offload), created on first use
+        offload_pool& get_offload_pool();
+
         /// return the io_context associated with the caller thread
 		boost::asio::io_context& get_thread_io_context();
 
+        /// return the io_contexts of the shared pool, one per worker thread
+        std::vector<std::reference_wrapper<boost::asio::io_context>> get_io_contexts();
+
         // Client management
         /// Register a client that uses workers
         void register_client(worker_client* client);
@@ -54,6 +93,10 @@ namespace thinger::asio {
 	private:
         /// Internal method to perform the actual stop
         void do_stop();
+
+        /// check the worker loops periodically until stopped
+        void run_watchdog();
+        void stop_watchdog();
         
         /// mutex used for initializing threads and data structures
         std::mutex mutex_;
@@ -70,7 +113,28 @@ namespace thinger::asio {
 		std::atomic<bool> running_{false};
 
         /// index to control next io_context to use (in the round-robin)
-        unsigned next_io_context_   = 0;
+        std::atomic<unsigned> next_io_context_{0};
+
+        /// policy for get_next_io_context
+        std::atomic<io_context_selection> selection_{io_context_selection::round_robin};
+
+        /// cpu pinning of the worker threads
+        bool pin_threads_ = false;
+        std::vector<unsigned> cpus_;
+
+        /// event loop monitor and watchdog
+        std::chrono::milliseconds lag_interval_{0};
+        std::chrono::milliseconds block_threshold_{0};
+        std::function<void(const blocked_handler&)> on_blocked_;
+        std::thread watchdog_;
+        std::mutex watchdog_mutex_;
+        std::condition_variable watchdog_cv_;
+        bool watchdog_running_ = false;
+
+        /// pool for offloaded jobs
+        std::unique_ptr<offload_pool> offload_pool_;
+        size_t offload_threads_ = 0;
+        size_t offload_max_pending_ = offload_pool::DEFAULT_MAX_PENDING;
 
 		/// worker threads used for general asio pool
 		std::vector<std::unique_ptr<worker_thread>> worker_threads_;
@@ -72,23 +72,24 @@ awaitable<void> client_connection::ensure_connected(const http_request& request)
 
 awaitable<std::shared_ptr<http_response>> client_connection::read_response(bool head_request) {
     response_parser_.reset();
+    read_buffer_pool::lease buffer;
 
     while (true) {
-        auto [ec, bytes] = co_await socket_->read_some(buffer_, MAX_BUFFER_SIZE);
+        auto [ec, bytes] = co_await socket_->read_some(buffer.data(), buffer.size());
 
         if (ec) {
             co_return nullptr;
         }
 
-        boost::tribool result = response_parser_.parse(buffer_, buffer_ + bytes, head_request);
+        boost::tribool result = response_parser_.parse(buffer.data(), buffer.data() + bytes, head_request);
 
         if (result) {
             // Successfully parsed response
             auto response = response_parser_.consume_response();
 
             // Decompress if needed
-            if (response && response->has_header("Content-Encoding")) {
-                std::string encoding = response->get_header("Content-Encoding");
+            if (response && response->has_header(header_id::content_encoding)) {
+                std::string encoding(response->get_header(header_id::content_encoding));
                 if (encoding == "gzip") {
                     auto decompressed = ::thinger::util::gzip::decompress(response->get_content());
                     if (decompressed) {
@@ -193,8 +194,9 @@ awaitable<stream_result> client_connection::send_request_streaming(
         co_await request->to_socket(socket_);
 
         // Read response with streaming
+        read_buffer_pool::lease buffer;
         while (true) {
-            auto [ec, bytes] = co_await socket_->read_some(buffer_, MAX_BUFFER_SIZE);
+            auto [ec, bytes] = co_await socket_->read_some(buffer.data(), buffer.size());
 
             if (ec) {
                 result.error = "Connection closed: " + ec.message();
@@ -203,7 +205,7 @@ awaitable<stream_result> client_connection::send_request_streaming(
 
             bool is_head = request->get_method() == http::method::HEAD;
             boost::tribool parse_result = response_parser_.parse(
-                buffer_, buffer_ + bytes, is_head);
+                buffer.data(), buffer.data() + bytes, is_head);
 
             if (result.status_code == 0) {
                 result.status_code = response_parser_.get_status_code();
@@ -12,12 +12,15 @@
 #include "../../asio/sockets/tcp_socket.hpp"
 #include "../../asio/sockets/unix_socket.hpp"
 #include "../../util/types.hpp"
+#include "../../util/buffer_pool.hpp"
 
 namespace thinger::http {
 
 class client_connection : public std::enable_shared_from_this<client_connection>, public boost::noncopyable {
 
     static constexpr unsigned MAX_BUFFER_SIZE = 4096;
+    // read buffers are only borrowed while a response is being read
+    using read_buffer_pool = ::thinger::util::buffer_pool<MAX_BUFFER_SIZE>;
     static constexpr unsigned MAX_RETRIES = 3;
     static constexpr auto DEFAULT_TIMEOUT = std::chrono::seconds{60};
     static constexpr auto CONNECT_TIMEOUT = std::chrono::seconds{10};
@@ -60,7 +63,6 @@ private:
     std::shared_ptr<thinger::asio::socket> socket_;
     std::string socket_path_;
     std::chrono::seconds timeout_;
-    uint8_t buffer_[MAX_BUFFER_SIZE];
     response_factory response_parser_;
     std::mutex connection_mutex_;
 };
@@ -81,7 +81,7 @@ public:
     // Headers
     std::string header(const std::string& key) const {
         return response_ && response_->has_header(key) ? 
-               response_->get_header(key) : "";
+               std::string(response_->get_header(key)) : "";
     }
     
     bool has_header(const std::string& key) const {
@@ -35,7 +35,7 @@ void http_client_base::apply_default_headers(const std::shared_ptr<http_request>
     if (!request->has_header("User-Agent")) {
         request->add_header("User-Agent", user_agent_);
     }
-    if (auto_decompress_ && !request->has_header("Accept-Encoding")) {
+    if (auto_decompress_ && !request->has_header(header_id::accept_encoding)) {
         request->add_header("Accept-Encoding", "gzip, deflate");
     }
 }
@@ -181,7 +181,7 @@ awaitable<stream_result> http_client_base::send_streaming(std::shared_ptr<http_r
                                                           stream_callback callback) {
     // Force no compression for streaming - we can't decompress chunks on the fly
     // Set this BEFORE apply_default_headers so it won't add gzip/deflate
-    if (!request->has_header("Accept-Encoding")) {
+    if (!request->has_header(header_id::accept_encoding)) {
         request->add_header("Accept-Encoding", "identity");
     }
     apply_default_headers(request);
@@ -210,9 +210,9 @@ awaitable<client_response> http_client_base::send_with_redirects(
 
     // Handle redirects
     if (follow_redirects_ && response->is_redirect_response() &&
-        redirect_count < max_redirects_ && response->has_header("Location")) {
+        redirect_count < max_redirects_ && response->has_header(header_id::location)) {
 
-        std::string location = response->get_header("Location");
+        std::string location(response->get_header(header_id::location));
         LOG_DEBUG("Following redirect #{} to: {}", redirect_count + 1, location);
 
         // Determine redirect method based on status code
@@ -238,8 +238,8 @@ awaitable<client_response> http_client_base::send_with_redirects(
         // Preserve body for 307/308
         if ((status == 307 || status == 308) && !request->get_body().empty()) {
             redirect_request->set_content(request->get_body());
-            if (request->has_header("Content-Type")) {
-                redirect_request->add_header("Content-Type", request->get_header("Content-Type"));
+            if (request->has_header(header_id::content_type)) {
+                redirect_request->add_header("Content-Type", request->get_header(header_id::content_type));
             }
             if (request->has_header("Content-Length")) {
                 redirect_request->add_header("Content-Length", request->get_header("Content-Length"));
@@ -248,8 +248,8 @@ awaitable<client_response> http_client_base::send_with_redirects(
 
         // Copy Authorization only for same origin
         std::string original_url = request->get_url();
-        if (request->has_header("Authorization") && is_same_origin(original_url, location)) {
-            redirect_request->add_header("Authorization", request->get_header("Authorization"));
+        if (request->has_header(header_id::authorization) && is_same_origin(original_url, location)) {
+            redirect_request->add_header("Authorization", request->get_header(header_id::authorization));
             LOG_DEBUG("Preserving Authorization header for same-origin redirect");
         }
 
@@ -355,7 +355,7 @@ awaitable<std::optional<websocket_client>> http_client_base::upgrade_websocket(
     }
 
     // Validate accept key
-    auto accept_key = response->get_header("Sec-WebSocket-Accept");
+    std::string accept_key(response->get_header(header_id::sec_websocket_accept));
     if (!websocket_util::validate_accept_key(accept_key, ws_key)) {
         LOG_ERROR("Invalid Sec-WebSocket-Accept key");
         co_return std::nullopt;
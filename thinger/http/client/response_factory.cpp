@@ -416,6 +416,10 @@ namespace thinger::http{
         resp->get_content().push_back(content);
     }
 
+    void response_factory::on_content_data(std::string_view content){
+        resp->get_content().append(content);
+    }
+
     size_t response_factory::get_content_length(){
         return resp->get_content_length();
     }
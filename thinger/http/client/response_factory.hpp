@@ -1,6 +1,8 @@
 #ifndef THINGER_HTTP_RESPONSE_FACTORY_HPP
 #define THINGER_HTTP_RESPONSE_FACTORY_HPP
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <functional>
 #include <string_view>
@@ -30,23 +32,31 @@ namespace thinger::http {
         boost::tribool parse(InputIterator begin, InputIterator end, bool head_request = false) {
             // iterate over all input chars
             while (begin != end) {
-                // Optimization: batch process content in streaming mode
-                if (on_streaming_ && state_ == lenght_delimited_content && tempInt_ > 0) {
+                // body bytes are handed over as whole spans instead of one by one
+                if (tempInt_ > 0 && (state_ == lenght_delimited_content || state_ == chunked_content)) {
                     size_t available = static_cast<size_t>(std::distance(begin, end));
                     size_t to_read = std::min(available, tempInt_);
 
-                    // Call streaming callback with batch data
                     // Need to cast to char* since buffer may be uint8_t*
                     std::string_view data(reinterpret_cast<const char*>(&*begin), to_read);
-                    streaming_downloaded_ += to_read;
+                    std::advance(begin, to_read);
+                    tempInt_ -= to_read;
 
-                    if (!on_streaming_(data, streaming_downloaded_, get_content_length())) {
-                        streaming_aborted_ = true;
-                        return false;
+                    if (state_ == chunked_content) {
+                        // chunk data is accumulated and flushed at the end of each chunk
+                        on_content_data(data);
+                        continue;
                     }
 
-                    std::advance(begin, to_read);
-                    tempInt_ -= to_read;
+                    if (on_streaming_) {
+                        streaming_downloaded_ += to_read;
+                        if (!on_streaming_(data, streaming_downloaded_, get_content_length())) {
+                            streaming_aborted_ = true;
+                            return false;
+                        }
+                    } else {
+                        on_content_data(data);
+                    }
 
                     if (tempInt_ == 0) {
                         return true;  // Done reading content
@@ -81,6 +91,8 @@ namespace thinger::http {
 
         void on_content_data(char content);
 
+        void on_content_data(std::string_view content);
+
         bool on_chunk_read(size_t size);
 
         bool on_length_delimited_content(size_t size);
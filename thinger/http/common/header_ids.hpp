@@ -0,0 +1,170 @@
+#ifndef THINGER_HTTP_HEADER_IDS_HPP
+#define THINGER_HTTP_HEADER_IDS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace thinger::http{
+
+    // Well-known header names. Headers are classified once when they are stored, so
+    // typed lookups and the checks done while parsing do not compare strings.
+    enum class header_id : uint8_t{
+        accept,
+        accept_encoding,
+        accept_language,
+        access_control_request_headers,
+        access_control_request_method,
+        authorization,
+        cache_control,
+        connection,
+        content_encoding,
+        content_length,
+        content_type,
+        cookie,
+        date,
+        etag,
+        expect,
+        host,
+        if_modified_since,
+        if_none_match,
+        keep_alive,
+        last_modified,
+        location,
+        origin,
+        range,
+        referer,
+        sec_websocket_accept,
+        sec_websocket_extensions,
+        sec_websocket_key,
+        sec_websocket_protocol,
+        sec_websocket_version,
+        server,
+        set_cookie,
+        transfer_encoding,
+        upgrade,
+        user_agent,
+        www_authenticate,
+        x_forwarded_for,
+        x_forwarded_proto,
+        x_frame_options,
+        x_real_ip,
+        unknown
+    };
+
+    namespace header_ids{
+
+        constexpr size_t count = static_cast<size_t>(header_id::unknown);
+
+        // canonical names, in header_id order
+        constexpr std::array<std::string_view, count> names{
+            "Accept",
+            "Accept-Encoding",
+            "Accept-Language",
+            "Access-Control-Request-Headers",
+            "Access-Control-Request-Method",
+            "Authorization",
+            "Cache-Control",
+            "Connection",
+            "Content-Encoding",
+            "Content-Length",
+            "Content-Type",
+            "Cookie",
+            "Date",
+            "ETag",
+            "Expect",
+            "Host",
+            "If-Modified-Since",
+            "If-None-Match",
+            "Keep-Alive",
+            "Last-Modified",
+            "Location",
+            "Origin",
+            "Range",
+            "Referer",
+            "Sec-WebSocket-Accept",
+            "Sec-WebSocket-Extensions",
+            "Sec-WebSocket-Key",
+            "Sec-WebSocket-Protocol",
+            "Sec-WebSocket-Version",
+            "Server",
+            "Set-Cookie",
+            "Transfer-Encoding",
+            "Upgrade",
+            "User-Agent",
+            "WWW-Authenticate",
+            "X-Forwarded-For",
+            "X-Forwarded-Proto",
+            "X-Frame-Options",
+            "X-Real-IP"
+        };
+
+        namespace detail{
+
+            constexpr size_t table_size = 128;
+
+            // seeded FNV-1a over the lowercase name; the seed is chosen so every name above
+            // lands on its own slot (checked below when the list changes)
+            constexpr uint32_t seed = 2006;
+
+            constexpr char lower(char c){
+                return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+            }
+
+            constexpr size_t hash(std::string_view name){
+                uint32_t h = seed;
+                for(char c : name){
+                    h = (h ^ static_cast<uint8_t>(lower(c))) * 16777619u;
+                }
+                return (h >> 16) % table_size;
+            }
+
+            constexpr std::array<header_id, table_size> make_table(){
+                std::array<header_id, table_size> table{};
+                for(auto& slot : table) slot = header_id::unknown;
+                for(size_t i = 0; i < count; ++i){
+                    table[hash(names[i])] = static_cast<header_id>(i);
+                }
+                return table;
+            }
+
+            constexpr auto table = make_table();
+
+            constexpr bool is_perfect(){
+                for(size_t i = 0; i < count; ++i){
+                    if(table[hash(names[i])] != static_cast<header_id>(i)) return false;
+                }
+                return true;
+            }
+
+            static_assert(is_perfect(), "header name hash collision: choose another seed");
+
+            constexpr bool iequals(std::string_view a, std::string_view b){
+                if(a.size() != b.size()) return false;
+                for(size_t i = 0; i < a.size(); ++i){
+                    if(lower(a[i]) != lower(b[i])) return false;
+                }
+                return true;
+            }
+        }
+
+        // map a header name (any case) to its id, or header_id::unknown
+        constexpr header_id lookup(std::string_view name){
+            auto id = detail::table[detail::hash(name)];
+            if(id != header_id::unknown && detail::iequals(names[static_cast<size_t>(id)], name)){
+                return id;
+            }
+            return header_id::unknown;
+        }
+
+        constexpr std::string_view name(header_id id){
+            return id == header_id::unknown ? std::string_view{} : names[static_cast<size_t>(id)];
+        }
+
+        static_assert(lookup("content-length") == header_id::content_length);
+        static_assert(lookup("X-Unknown") == header_id::unknown);
+    }
+
+}
+
+#endif
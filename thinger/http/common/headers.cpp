@@ -1,74 +1,232 @@
 #include "headers.hpp"
 #include <charconv>
+#include <cstring>
+#include <limits>
 #include <regex>
 #include "../../util/logger.hpp"
 
 namespace thinger::http{
 
-    void headers::process_header(std::string key, std::string value){
-        if(boost::indeterminate(keep_alive_) && is_header(key, header::connection)){
-            /*
-             * Firefox send both keep-alive and upgrade values in Connection header, i.e., when opening a WebSocket,
-             * so it is necessary to test values separately.
-             */
-            std::vector<std::string> strs;
-            boost::split(strs, value, boost::is_any_of(","));
-            for(auto& str:strs){
-                boost::algorithm::trim(str);
-                if(is_header(str, connection::keep_alive)){
-                    keep_alive_ = true;
-                }
-                else if (is_header(str, connection::close)){
-                    keep_alive_ = false;
+    headers::headers() :
+        arena_(arena_buffer_.data(), arena_buffer_.size())
+    {
+
+    }
+
+    headers::headers(const headers& other) :
+        http_frame(other),
+        headers_(other.headers_),
+        proxy_headers_(other.proxy_headers_),
+        keep_alive_(other.keep_alive_),
+        upgrade_(other.upgrade_),
+        stream_(other.stream_),
+        content_length_(other.content_length_),
+        http_version_major_(other.http_version_major_),
+        http_version_minor_(other.http_version_minor_),
+        index_(other.index_),
+        arena_(arena_buffer_.data(), arena_buffer_.size())
+    {
+        own_all();
+    }
+
+    headers& headers::operator=(const headers& other){
+        if(this == &other) return *this;
+        http_frame::operator=(other);
+        // the views of other never reference the storage released here
+        pinned_owner_.reset();
+        pinned_ = {};
+        owned_.clear();
+        arena_.release();
+        headers_ = other.headers_;
+        proxy_headers_ = other.proxy_headers_;
+        keep_alive_ = other.keep_alive_;
+        upgrade_ = other.upgrade_;
+        stream_ = other.stream_;
+        content_length_ = other.content_length_;
+        http_version_major_ = other.http_version_major_;
+        http_version_minor_ = other.http_version_minor_;
+        index_ = other.index_;
+        own_all();
+        return *this;
+    }
+
+    void headers::own_all(){
+        for(auto* list : {&headers_, &proxy_headers_}){
+            for(auto& [key, value] : *list){
+                key = keep(key);
+                value = keep(value);
+            }
+        }
+    }
+
+    void headers::process_header(std::string_view key, std::string_view value){
+        handle_header(header_ids::lookup(key), key, value);
+    }
+
+    void headers::handle_header(header_id id, std::string_view key, std::string_view value){
+        switch(id){
+            case header_id::connection:
+                if(!boost::indeterminate(keep_alive_)) break;
+                {
+                    /*
+                     * Firefox send both keep-alive and upgrade values in Connection header, i.e., when opening a WebSocket,
+                     * so it is necessary to test values separately.
+                     */
+                    std::string_view remaining = value;
+                    while(!remaining.empty()){
+                        auto comma = remaining.find(',');
+                        std::string_view token = remaining.substr(0, comma);
+                        remaining = comma == std::string_view::npos ? std::string_view{} : remaining.substr(comma + 1);
+
+                        // trim surrounding whitespace
+                        while(!token.empty() && (token.front() == ' ' || token.front() == '\t')) token.remove_prefix(1);
+                        while(!token.empty() && (token.back() == ' ' || token.back() == '\t')) token.remove_suffix(1);
+
+                        if(is_header(token, connection::keep_alive)){
+                            keep_alive_ = true;
+                        }
+                        else if (is_header(token, connection::close)){
+                            keep_alive_ = false;
+                        }
+                        else if(is_header(token, connection::upgrade)){
+                            upgrade_ = true;
+                        }
+                    }
                 }
-                else if(is_header(str, connection::upgrade)){
-                    upgrade_ = true;
+                break;
+            case header_id::accept:
+                stream_ = boost::iequals(value, accept::event_stream);
+                break;
+            case header_id::content_length:{
+                auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), content_length_);
+                if (ec != std::errc{}) {
+                    content_length_ = 0;
                 }
+                break;
             }
+            default:
+                break;
         }
 
-        if(is_header(key, header::accept)){
-            stream_ = boost::iequals(value, accept::event_stream);
-        }else if(is_header(key, header::content_length)){
-            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), content_length_);
-            if (ec != std::errc{}) {
-                content_length_ = 0;
+        store_header(id, key, value);
+    }
+
+    void headers::store_header(header_id id, std::string_view key, std::string_view value){
+        if(headers_.capacity() == 0) headers_.reserve(INITIAL_HEADERS);
+        headers_.emplace_back(keep(key), keep(value));
+        if(id != header_id::unknown){
+            auto& slot = index_[static_cast<size_t>(id)];
+            if(slot == 0 && headers_.size() <= std::numeric_limits<uint16_t>::max()){
+                slot = static_cast<uint16_t>(headers_.size());
             }
         }
+    }
+
+    size_t headers::find_header(std::string_view key) const{
+        auto id = header_ids::lookup(key);
+        if(id != header_id::unknown){
+            auto slot = index_[static_cast<size_t>(id)];
+            return slot ? slot - 1 : headers_.size();
+        }
+        for(size_t i = 0; i < headers_.size(); ++i){
+            if(is_header(headers_[i].first, key)) return i;
+        }
+        return headers_.size();
+    }
 
-        headers_.emplace_back(std::move(key), std::move(value));
+    void headers::reindex(){
+        index_.fill(0);
+        for(size_t i = 0; i < headers_.size() && i < std::numeric_limits<uint16_t>::max(); ++i){
+            auto id = header_ids::lookup(headers_[i].first);
+            if(id != header_id::unknown && index_[static_cast<size_t>(id)] == 0){
+                index_[static_cast<size_t>(id)] = static_cast<uint16_t>(i + 1);
+            }
+        }
     }
 
-    void headers::add_header(std::string key, std::string value){
+    void headers::add_header(std::string_view key, std::string_view value){
         if(key.empty()) return;
-        headers_.emplace_back(std::move(key), std::move(value));
+        store_header(header_ids::lookup(key), key, value);
     }
 
-    void headers::add_proxy(std::string key, std::string value){
+    void headers::add_proxy(std::string_view key, std::string_view value){
         if(key.empty()) return;
-        proxy_headers_.emplace_back(std::move(key), std::move(value));
+        proxy_headers_.emplace_back(keep(key), keep(value));
     }
 
-    void headers::set_header(std::string key, std::string value){
-        for(auto & header : headers_)
-        {
-            if(is_header(header.first, key)){
-                header.second = std::move(value);
-                return;
-            }
+    void headers::set_header(std::string_view key, std::string_view value){
+        auto position = find_header(key);
+        if(position != headers_.size()){
+            // value may be a view of the one it replaces
+            auto previous = headers_[position].second;
+            headers_[position].second = keep(value);
+            release(previous);
+            return;
         }
-        add_header(std::move(key), std::move(value));
+        add_header(key, value);
     }
 
-    void headers::set_proxy(std::string key, std::string value){
+    void headers::set_proxy(std::string_view key, std::string_view value){
         for(auto & header : proxy_headers_)
         {
             if(is_header(header.first, key)){
-                header.second = std::move(value);
+                auto previous = header.second;
+                header.second = keep(value);
+                release(previous);
                 return;
             }
         }
-        add_proxy(std::move(key), std::move(value));
+        add_proxy(key, value);
+    }
+
+    void headers::pin_buffer(std::shared_ptr<const void> owner, std::string_view data){
+        if(pinned_owner_ == owner && pinned_.data() == data.data() && pinned_.size() == data.size()) return;
+        unpin_buffer();
+        pinned_owner_ = std::move(owner);
+        pinned_ = data;
+    }
+
+    void headers::unpin_buffer(){
+        if(!pinned_owner_) return;
+        for(auto* list : {&headers_, &proxy_headers_}){
+            for(auto& [key, value] : *list){
+                if(in_pinned_buffer(key)) key = copy(key);
+                if(in_pinned_buffer(value)) value = copy(value);
+            }
+        }
+        pinned_ = {};
+        pinned_owner_.reset();
+    }
+
+    bool headers::is_pinned() const{
+        return pinned_owner_ != nullptr;
+    }
+
+    bool headers::in_pinned_buffer(std::string_view value) const{
+        if(!pinned_owner_ || value.empty()) return false;
+        std::less_equal<const char*> le;
+        return le(pinned_.data(), value.data()) && le(value.data() + value.size(), pinned_.data() + pinned_.size());
+    }
+
+    std::string_view headers::copy(std::string_view value){
+        if(value.empty()) return {};
+        auto* data = static_cast<char*>(arena_.allocate(value.size(), alignof(char)));
+        std::memcpy(data, value.data(), value.size());
+        return {data, value.size()};
+    }
+
+    std::string_view headers::keep(std::string_view value){
+        if(value.empty()) return {};
+        if(in_pinned_buffer(value)) return value;
+        return owned_.emplace_back(value);
+    }
+
+    void headers::release(std::string_view value){
+        if(value.empty()) return;
+        auto it = std::find_if(owned_.begin(), owned_.end(), [&](const std::string& owned){
+            return owned.data() == value.data();
+        });
+        if(it != owned_.end()) owned_.erase(it);
     }
 
     bool headers::upgrade() const{
@@ -80,25 +238,24 @@ namespace thinger::http{
     }
 
     bool headers::has_header(std::string_view key) const{
-        for(const auto & header : headers_)
-        {
-            if(is_header(header.first, key)){
-                return true;
-            }
-        }
-        return false;
+        return find_header(key) != headers_.size();
     }
 
-    const std::string& headers::get_header(std::string_view key) const
+    bool headers::has_header(header_id id) const{
+        return id != header_id::unknown && index_[static_cast<size_t>(id)] != 0;
+    }
+
+    std::string_view headers::get_header(std::string_view key) const
     {
-        for(const auto & header : headers_)
-        {
-            if(is_header(header.first, key)){
-                return header.second;
-            }
-        }
-        static std::string emtpy;
-        return emtpy;
+        auto position = find_header(key);
+        return position != headers_.size() ? headers_[position].second : std::string_view{};
+    }
+
+    std::string_view headers::get_header(header_id id) const
+    {
+        if(id == header_id::unknown) return {};
+        auto slot = index_[static_cast<size_t>(id)];
+        return slot ? headers_[slot - 1].second : std::string_view{};
     }
 
     std::vector<std::string> headers::get_headers_with_key(std::string_view key) const{
@@ -106,7 +263,7 @@ namespace thinger::http{
         for(const auto & header : headers_)
         {
             if(is_header(header.first, key)){
-                headers.push_back(header.second);
+                headers.emplace_back(header.second);
             }
         }
         return headers;
@@ -116,43 +273,40 @@ namespace thinger::http{
         return headers_;
     }
 
-    std::vector<headers::http_header>& headers::get_headers(){
-        return headers_;
-    }
-
     bool headers::remove_header(std::string_view key)
     {
-        for(auto it=headers_.begin(); it!=headers_.end(); ++it){
-            if(is_header(it->first, key)){
-                headers_.erase(it);
-                return true;
-            }
-        }
-        return false;
+        auto position = find_header(key);
+        if(position == headers_.size()) return false;
+        auto [name, value] = headers_[position];
+        headers_.erase(headers_.begin() + position);
+        release(name);
+        release(value);
+        reindex();
+        return true;
     }
 
-    const std::string& headers::get_authorization() const
+    std::string_view headers::get_authorization() const
     {
-        return get_header(header::authorization);
+        return get_header(header_id::authorization);
     }
 
-    const std::string& headers::get_cookie() const
+    std::string_view headers::get_cookie() const
     {
-        return get_header(header::cookie);
+        return get_header(header_id::cookie);
     }
 
-    const std::string& headers::get_user_agent() const{
-        return get_header(header::user_agent);
+    std::string_view headers::get_user_agent() const{
+        return get_header(header_id::user_agent);
     }
 
-    const std::string& headers::get_content_type() const
+    std::string_view headers::get_content_type() const
     {
-        return get_header(header::content_type);
+        return get_header(header_id::content_type);
     }
 
-    bool headers::is_content_type(const std::string& value) const
+    bool headers::is_content_type(std::string_view value) const
     {
-        return boost::istarts_with(get_header(header::content_type), value);
+        return boost::istarts_with(get_header(header_id::content_type), value);
     }
 
     bool headers::empty_headers() const{
@@ -160,7 +314,7 @@ namespace thinger::http{
     }
 
     void headers::debug_headers(std::ostream& os) const{
-        for(const std::pair<std::string, std::string>& t: headers_){
+        for(const auto& t: headers_){
             os << "\t> " << t.first << ": " << t.second << std::endl;
         }
     }
@@ -209,22 +363,21 @@ namespace thinger::http{
         return http_version_minor_;
     }
 
-    std::string headers::get_parameter(const std::string& header_value, std::string_view name) {
+    std::string headers::get_parameter(std::string_view header_value, std::string_view name) {
 
-        auto start = header_value.begin();
-		auto end   = header_value.end();
+        auto start = header_value.data();
+		auto end   = header_value.data() + header_value.size();
 
 		if(start==end) return "";
 
 		static std::regex cookie_regex("([^;^\\s]+)=\"?([^;^\"]*)\"?");
-		std::smatch what;
+		std::cmatch what;
 
 		while (std::regex_search(start, end, what, cookie_regex))
 		{
-			std::string key(what[1].first, what[1].second);
-			std::string value(what[2].first, what[2].second);
+			std::string_view key(what[1].first, what[1].length());
 
-			if(key==name) return value;
+			if(key==name) return what[2].str();
 
 			start = what[0].second;
 		}
@@ -2,10 +2,16 @@
 #define THINGER_HTTP_HEADERS_HPP
 
 #include <algorithm>
+#include <array>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
 #include <boost/logic/tribool.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include "http_frame.hpp"
+#include "header_ids.hpp"
 
 namespace thinger::http{
 
@@ -35,6 +41,7 @@ namespace thinger::http{
         const std::string host = "Host";
         const std::string referer = "Referer";
         const std::string x_frame_options = "X-Frame-Options";
+        const std::string date = "Date";
     }
 
     namespace connection{
@@ -55,38 +62,57 @@ namespace thinger::http{
 class headers : public http_frame{
 
 public:
-    using http_header = std::pair<std::string, std::string>;
+    // header names and values are views into either a pinned input buffer (parsed
+    // requests) or storage owned by this object (headers set by the application), valid
+    // until the header is replaced or removed. Unlike previous versions, get_header returns
+    // a view instead of a const std::string&, and headers are only modified through the
+    // setters, as there is no mutable get_headers()
+    using http_header = std::pair<std::string_view, std::string_view>;
+
+    // header slots reserved on the first header, so typical messages do not regrow the vector
+    static constexpr size_t INITIAL_HEADERS = 8;
 
     // constructors
-    headers() = default;
+    headers();
     ~headers() override = default;
 
+    // copies own all their values and are not pinned to the input buffer of the original
+    headers(const headers& other);
+    headers& operator=(const headers& other);
+
     // setters
-    void add_header(std::string key, std::string value);
-    void set_header(std::string key, std::string value);
-    void set(std::string key, std::string value) { set_header(std::move(key), std::move(value)); }
-    void set_proxy(std::string key, std::string value);
-    void add_proxy(std::string key, std::string value);
+    void add_header(std::string_view key, std::string_view value);
+    void set_header(std::string_view key, std::string_view value);
+    void set(std::string_view key, std::string_view value) { set_header(key, value); }
+    void set_proxy(std::string_view key, std::string_view value);
+    void add_proxy(std::string_view key, std::string_view value);
     bool upgrade() const;
     bool stream() const;
     bool has_header(std::string_view key) const;
+    bool has_header(header_id id) const;
     bool remove_header(std::string_view key);
     void set_http_version_major(uint8_t http_version_major);
     void set_http_version_minor(uint8_t http_version_minor);
     void set_keep_alive(bool keep_alive);
 
+    // input buffer pinning: headers processed while a buffer is pinned reference it
+    // directly instead of being copied; unpin copies them before releasing the buffer
+    void pin_buffer(std::shared_ptr<const void> owner, std::string_view data);
+    void unpin_buffer();
+    bool is_pinned() const;
+
     // getters
-    std::vector<http_header>& get_headers();
     const std::vector<http_header>& get_headers() const;
-    static std::string get_parameter(const std::string& key, std::string_view name) ;
+    static std::string get_parameter(std::string_view header_value, std::string_view name) ;
     std::vector<std::string> get_headers_with_key(std::string_view key) const;
-    const std::string& get_header(std::string_view key) const;
-
-    const std::string& get_authorization() const;
-    const std::string& get_cookie() const;
-    const std::string& get_user_agent() const;
-    const std::string& get_content_type() const;
-    bool is_content_type(const std::string& value) const;
+    std::string_view get_header(std::string_view key) const;
+    std::string_view get_header(header_id id) const;
+
+    std::string_view get_authorization() const;
+    std::string_view get_cookie() const;
+    std::string_view get_user_agent() const;
+    std::string_view get_content_type() const;
+    bool is_content_type(std::string_view value) const;
     bool empty_headers() const;
     size_t get_content_length() const;
     int get_http_version_major() const;
@@ -98,10 +124,16 @@ public:
     void debug_headers(std::ostream& os) const;
     void log(const char* scope, int level) const override;
 
-    // process header intended to be override to process headers
-    virtual void process_header(std::string key, std::string value);
+    // process a received header, classifying its name once
+    void process_header(std::string_view key, std::string_view value);
 
 protected:
+    // handle a received header, intended to be override to process headers
+    virtual void handle_header(header_id id, std::string_view key, std::string_view value);
+
+    // returns a view that lives as long as this object, copying it to owned storage if required
+    std::string_view keep(std::string_view value);
+
     std::vector<http_header> headers_;
     std::vector<http_header> proxy_headers_;
     boost::tribool keep_alive_    = boost::indeterminate;
@@ -110,6 +142,31 @@ protected:
     size_t content_length_        = 0;
     uint8_t http_version_major_   = 1;
     uint8_t http_version_minor_   = 1;
+
+private:
+    void store_header(header_id id, std::string_view key, std::string_view value);
+    // position of the first header named key, or headers_.size()
+    size_t find_header(std::string_view key) const;
+    void reindex();
+
+    // make every header independent of the pinned buffer and of other objects
+    void own_all();
+    // frees the owned copy of a value that is no longer referenced
+    void release(std::string_view value);
+    // copies a pinned value to the arena, when unpinning
+    std::string_view copy(std::string_view value);
+    bool in_pinned_buffer(std::string_view value) const;
+
+    std::shared_ptr<const void> pinned_owner_;
+    std::string_view pinned_;
+    // position + 1 in headers_ of the first header with each well-known name (0 if absent);
+    // unknown names are looked up by scanning headers_
+    std::array<uint16_t, header_ids::count> index_{};
+    // values set by the application, in nodes so views survive other insertions
+    std::list<std::string> owned_;
+    // values copied out of the pinned buffer when it is released
+    std::array<std::byte, 512> arena_buffer_;
+    std::pmr::monotonic_buffer_resource arena_;
 };
 
 }
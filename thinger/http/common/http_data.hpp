@@ -35,6 +35,16 @@ public:
         return data_;
     }
 
+    // data written with its own to_socket, like streamed bodies, is not gathered
+    awaitable<io_result> to_socket(std::shared_ptr<thinger::asio::socket> socket) override{
+        if(data_ && !data_->supports_buffer()) return data_->to_socket(std::move(socket));
+        return out_data::to_socket(std::move(socket));
+    }
+
+    bool supports_buffer() override{
+        return !data_ || data_->supports_buffer();
+    }
+
     size_t get_size() override{
         if(data_){
             return data_->get_size();
@@ -15,6 +15,9 @@ namespace thinger::http {
         void set_last_frame(bool last_frame);
         virtual bool end_stream();
 
+        // called once when the frame is queued for writing, after which it does not change
+        virtual void finalize() {}
+
         // debug
         virtual void log(const char* scope, int level) const;
 
@@ -1,5 +1,4 @@
 #include "http_request.hpp"
-#include <unordered_map>
 #include <set>
 #include "../../util/logger.hpp"
 
@@ -18,8 +17,8 @@ namespace thinger::http {
     static const std::string CONNECT_STR = "CONNECT";
     static const std::string PATCH_STR = "PATCH";
 
-    method get_method(const std::string &method) {
-        static std::unordered_map<std::string, http::method> methods = {
+    method get_method(std::string_view method) {
+        static const std::pair<const std::string&, http::method> methods[] = {
             {GET_STR, method::GET},
             {HEAD_STR, method::HEAD},
             {POST_STR, method::POST},
@@ -30,9 +29,8 @@ namespace thinger::http {
             {CONNECT_STR, method::CONNECT},
             {PATCH_STR, method::PATCH}
         };
-        auto it = methods.find(method);
-        if (it != methods.end()) {
-            return it->second;
+        for(const auto& [name, value] : methods){
+            if(name == method) return value;
         }
         return method::UNKNOWN;
     }
@@ -112,6 +110,26 @@ namespace thinger::http {
         return on_chunked_;
     }
 
+    void http_request::set_uri_change_callback(std::function<void()> callback){
+        on_uri_change_.callback = std::move(callback);
+    }
+
+    void http_request::uri_changing(){
+        if(!on_uri_change_.callback) return;
+        auto callback = std::move(on_uri_change_.callback);
+        on_uri_change_.callback = nullptr;
+        callback();
+    }
+
+    http_request::uri_callback& http_request::uri_callback::operator=(const uri_callback&){
+        if(callback){
+            auto pending = std::move(callback);
+            callback = nullptr;
+            pending();
+        }
+        return *this;
+    }
+
     std::shared_ptr<http_request>
     http_request::create_http_request(http::method method, const std::string& url, const std::string& unix_socket){
         auto request = std::make_shared<http_request>();
@@ -138,33 +156,41 @@ namespace thinger::http {
     }
 
     bool http_request::set_url(const std::string& url){
-        static const std::regex uri_regex(R"((wss?|https?):\/\/(?:(.*):(.*)@)?([a-zA-Z\.\-0-9_]+)(?::(\d+))*(.*))");
-        std::match_results<std::string::const_iterator> results;
-        if (std::regex_match(url, results, uri_regex)) {
-            std::string protocol = results[1];
-            std::string username = results[2];
-            std::string password = results[3];
-            std::string host = results[4];
-            std::string port = results[5];
-            std::string uri = results[6];
-            set_host(host);
-            if(!port.empty()){
-                set_port(port);
-            }
-            set_protocol(protocol);
-            set_ssl(protocol==https || protocol==wss);
-            set_uri(uri.empty() ? "/" : uri);
-
-
-            // set upgrade headers if it is a websocket
-            if(protocol==wss || protocol==ws){
-                set_header(http::header::connection, "upgrade");
-                set_header(http::header::upgrade, "websocket");
-            }
+        util::url::uri_parts parts;
+        if(!util::url::split_uri(url, parts) || !parts.has_authority) return false;
+
+        std::string protocol(parts.scheme);
+        boost::algorithm::to_lower(protocol);
+        if(protocol!=http && protocol!=https && protocol!=ws && protocol!=wss) return false;
+
+        // only plain host names and IPv4 addresses are supported
+        bool valid_host = std::all_of(parts.host.begin(), parts.host.end(), [](char c){
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-' || c == '_';
+        });
+        if(!valid_host) return false;
+
+        set_host(std::string(parts.host));
+        if(!parts.port.empty()){
+            set_port(std::string(parts.port));
+        }
+        set_protocol(protocol);
+        set_ssl(protocol==https || protocol==wss);
+
+        // request target: path and query (the fragment is never sent)
+        std::string uri = parts.path.empty() ? "/" : std::string(parts.path);
+        if(parts.has_query){
+            uri += '?';
+            uri += parts.query;
+        }
+        set_uri(uri);
 
-            return true;
+        // set upgrade headers if it is a websocket
+        if(protocol==wss || protocol==ws){
+            set_header(http::header::connection, "upgrade");
+            set_header(http::header::upgrade, "websocket");
         }
-        return false;
+
+        return true;
     }
 
     std::shared_ptr<http_request> http_request::create_http_request(const std::string& method, const std::string& url){
@@ -172,6 +198,7 @@ namespace thinger::http {
     }
 
     bool http_request::has_query_parameters() const{
+        parse_query();
         return !uri_params_.empty();
     }
 
@@ -196,6 +223,7 @@ namespace thinger::http {
     }
 
     void http_request::set_resource(const std::string& resource){
+        parse_query();
         // update resource
         resource_ = resource;
         // refresh uri
@@ -203,23 +231,28 @@ namespace thinger::http {
     }
 
     bool http_request::has_uri_parameters() const{
+        parse_query();
         return !uri_params_.empty();
     }
 
     bool http_request::has_uri_value(const std::string& key, const std::string& value) const{
+        parse_query();
         auto position = uri_params_.find(key);
         return position != uri_params_.end() && position->second == value;
     }
 
     bool http_request::has_uri_parameter(const std::string& key) const{
+        parse_query();
         return uri_params_.find(key) != uri_params_.end();
     }
 
     const std::multimap<std::string, std::string>& http_request::get_uri_parameters() const{
+        parse_query();
         return uri_params_;
     }
 
     const std::string& http_request::get_uri_parameter(const std::string& key) const{
+        parse_query();
         auto position = uri_params_.find(key);
         if(position != uri_params_.end()){
             return position->second;
@@ -229,6 +262,7 @@ namespace thinger::http {
     }
 
     void http_request::add_uri_parameter(const std::string& key, const std::string& value){
+        parse_query();
         // store uri value
         uri_params_.emplace(key, value);
         // update uri
@@ -236,7 +270,7 @@ namespace thinger::http {
     }
 
     bool http_request::has_content() const{
-        return !content_.empty() || has_header(http::header::content_length);
+        return !content_.empty() || has_header(header_id::content_length);
     }
 
     void http_request::set_content(std::string content, std::string content_type){
@@ -261,12 +295,13 @@ namespace thinger::http {
         // set method
         method_ = method;
         // force methods with a supposed body to force a default content length
-        if((method_==http::method::POST || method_==http::method::PUT || method==http::method::PATCH) && !has_header(http::header::content_length)){
+        if((method_==http::method::POST || method_==http::method::PUT || method==http::method::PATCH) && !has_header(header_id::content_length)){
             set_header(http::header::content_length, "0");
         }
     }
 
     std::string http_request::get_query_string() const{
+        parse_query();
         return get_url_encoded_data(uri_params_);
     }
 
@@ -278,19 +313,17 @@ namespace thinger::http {
         return uri_;
     }
 
-    void http_request::set_method(const std::string& method){
+    void http_request::set_method(std::string_view method){
         method_ = http::get_method(method);
     }
 
-    std::string& http_request::get_uri(){
-        return uri_;
-    }
-
     const std::string& http_request::get_uri() const{
         return uri_;
     }
 
     void http_request::refresh_uri(){
+        parse_query();
+        uri_changing();
         if(uri_params_.empty()){
             uri_ = util::url::uri_path_encode(resource_);
         }else{
@@ -298,25 +331,58 @@ namespace thinger::http {
         }
     }
 
-    void http_request::set_uri(const std::string& uri){
-        std::smatch what;
-        std::string::const_iterator start = uri.begin();
-        std::string::const_iterator end   = uri.end();
-
-        static const std::regex resource_regex("(\\/[^\\?#]*)");
-        if(std::regex_search(start, end, what, resource_regex)){
-            resource_ = util::url::url_decode(std::string(what[0].first, what[1].second));
-            start = what[0].second;
+    bool http_request::set_uri(const std::string& uri){
+        uri_changing();
+        // just save the original uri to avoid generating it again
+        uri_ = uri;
+        uri_params_.clear();
+        query_pending_ = false;
+        query_offset_ = 0;
+        query_size_ = 0;
+
+        std::string_view path;
+        std::string_view query;
+        bool has_query = false;
+        if(!uri.empty() && uri[0] == '/'){
+            // origin-form target: there is no authority to look for
+            path = std::string_view(uri).substr(0, uri.find('#'));
+            auto mark = path.find('?');
+            if(mark != std::string_view::npos){
+                query = path.substr(mark + 1);
+                has_query = true;
+                path = path.substr(0, mark);
+            }
+        }else{
+            util::url::uri_parts parts;
+            if(!util::url::split_uri(uri, parts)){
+                resource_.clear();
+                return false;
+            }
+            // resource is the path starting at its first slash
+            auto slash = parts.path.find('/');
+            path = slash != std::string_view::npos ? parts.path.substr(slash) : std::string_view{};
+            query = parts.query;
+            has_query = parts.has_query;
         }
 
-        // Regex will stop at ? or # or end of the uri. Check if there is parameters available for its parsing
-        if(start!=uri.end() && *start=='?'){
-            ++start;
-            parse_url_encoded_data(start, end, uri_params_);
+        // resource is the decoded path
+        if(util::url::needs_decoding(path)){
+            resource_ = util::url::url_decode(path);
+        }else{
+            resource_.assign(path);
         }
 
-        // just save the original uri to avoid generating it again
-        uri_ = uri;
+        // query parameters are decoded on first access
+        query_pending_ = has_query && !query.empty();
+        query_offset_ = query_pending_ ? static_cast<size_t>(query.data() - uri.data()) : 0;
+        query_size_ = query.size();
+        return true;
+    }
+
+    void http_request::parse_query() const{
+        if(!query_pending_) return;
+        query_pending_ = false;
+        parse_url_encoded_data(std::string_view(uri_).substr(std::min(query_offset_, uri_.size()), query_size_), uri_params_);
     }
 
     const std::string& http_request::get_unix_socket(){
@@ -389,17 +455,17 @@ namespace thinger::http {
         return cookie_store_;
     }
 
-    void http_request::process_header(std::string key, std::string value){
+    void http_request::handle_header(header_id id, std::string_view key, std::string_view value){
         // adjust host
-        if(boost::iequals(key, http::header::host)){
-            set_host(std::move(value));
+        if(id == header_id::host){
+            set_host(std::string(value));
         }else{
             // detect chunked transfer encoding
-            if(boost::iequals(key, http::header::transfer_encoding) && boost::iequals(value, "chunked")){
+            if(id == header_id::transfer_encoding && boost::iequals(value, "chunked")){
                 chunked_transfer_ = true;
             }
             // handle header by parent
-            headers::process_header(std::move(key), std::move(value));
+            headers::handle_header(id, key, value);
         }
     }
 
@@ -411,7 +477,7 @@ namespace thinger::http {
         buffer.emplace_back(boost::asio::buffer(misc_strings::http_1_1));
         buffer.emplace_back(boost::asio::buffer(misc_strings::crlf));
 
-        std::set<std::string> proxy_headers;
+        std::set<std::string_view> proxy_headers;
 
         // replace headers with proxy headers (if any)
         for(const auto& [key, value] : proxy_headers_){
@@ -2,7 +2,6 @@
 #define HTTP_REQUEST_HPP
 
 #include <boost/asio.hpp>
-#include <regex>
 #include <utility>
 #include "headers.hpp"
 #include "../client/cookie_store.hpp"
@@ -23,7 +22,7 @@ namespace thinger::http {
         UNKNOWN
     };
 
-    method get_method(const std::string& method);
+    method get_method(std::string_view method);
     const std::string& get_method(method);
     static const std::string https = "https";
     static const std::string wss = "wss";
@@ -47,8 +46,11 @@ public:
     void set_protocol(std::string protocol);
     void set_ssl(bool ssl);
     void set_unix_socket(const std::string& unix_socket);
-    void set_uri(const std::string &uri);
-    void set_method(const std::string &method);
+    // request target: a path starting with '/' is always an absolute path, even if it starts
+    // with "//"; other targets are split as URIs. Returns false if the target is malformed,
+    // leaving the request without resource nor query
+    bool set_uri(const std::string &uri);
+    void set_method(std::string_view method);
     void set_method(http::method method);
     void set_content(std::string content);
     void set_content(std::string content, std::string content_type);
@@ -71,7 +73,7 @@ public:
     const std::string& get_method_string() const;
     std::string get_query_string() const;
     std::string get_path() const;
-    std::string& get_uri();
+    // the uri only changes through the setters, so views into it can be told before it does
     const std::string& get_uri() const;
     const std::string& get_unix_socket();
     const std::string& get_protocol() const;
@@ -105,11 +107,13 @@ public:
     std::function<void(int, const std::string&)> get_chunked_callback();
     void set_chunked_callback(std::function<void(int, const std::string&)> callback);
 
+    // called once before the uri changes, i.e., to copy views taken into it
+    void set_uri_change_callback(std::function<void()> callback);
+
     // stream related
     bool end_stream() override;
     size_t get_size() override;
     void to_buffer(std::vector<boost::asio::const_buffer> &buffer) const override;
-    void process_header(std::string key, std::string value) override;
 
     // logs
     void log(const char* scope, int level) const override;
@@ -133,12 +137,35 @@ public:
     // other
     void refresh_uri();
 
+protected:
+    void handle_header(header_id id, std::string_view key, std::string_view value) override;
+
 private:
+    // decode the query of uri_ into uri_params_ if it has not been done yet
+    void parse_query() const;
+
+    // calls and clears the uri change callback
+    void uri_changing();
+
+    // uri change callback, not inherited by copies, as it refers to views into this request
+    struct uri_callback{
+        std::function<void()> callback;
+        uri_callback() = default;
+        uri_callback(const uri_callback&) {}
+        // assigning a request replaces its uri
+        uri_callback& operator=(const uri_callback&);
+    };
+
     bool ssl_ = false;
     method method_ = method::UNKNOWN;
+    // before uri_, so assignments notify the change before replacing it
+    uri_callback on_uri_change_;
     std::string uri_;
     std::string resource_;
-    std::multimap<std::string, std::string> uri_params_;
+    mutable std::multimap<std::string, std::string> uri_params_;
+    mutable bool query_pending_ = false;
+    size_t query_offset_ = 0;
+    size_t query_size_ = 0;
     std::string content_;
     std::string host_;
     std::string port_;
@@ -120,16 +120,175 @@ namespace thinger::http{
         }
     }
 
-    void http_response::to_buffer(std::vector<boost::asio::const_buffer>& buffer) const{
-        buffer.emplace_back(boost::asio::buffer(status_strings::get_status_string(status_)));
-        buffer.emplace_back(boost::asio::buffer(misc_strings::crlf));
+    namespace preambles{
+
+        const std::string keep_alive = "Connection: Keep-Alive\r\n";
+        const std::string close = "Connection: Close\r\n";
+        const std::string cors_names[] = {
+                "Access-Control-Allow-Origin",
+                "Access-Control-Allow-Methods",
+                "Access-Control-Allow-Headers",
+                "Access-Control-Allow-Credentials"
+        };
+        const std::string cors_lines[] = {
+                "Access-Control-Allow-Origin: *\r\n",
+                "Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS, HEAD, PATCH\r\n",
+                "Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n",
+                "Access-Control-Allow-Credentials: true\r\n"
+        };
+        const std::string cors = cors_lines[0] + cors_lines[1] + cors_lines[2] + cors_lines[3];
+        constexpr uint8_t all_cors = (1 << std::size(cors_names)) - 1;
+
+        enum connection_header{ with_keep_alive, with_close, without_connection, connection_headers };
+
+        constexpr http_response::status statuses[] = {
+            http_response::status::switching_protocols,
+            http_response::status::ok,
+            http_response::status::created,
+            http_response::status::accepted,
+            http_response::status::no_content,
+            http_response::status::multiple_choices,
+            http_response::status::moved_permanently,
+            http_response::status::moved_temporarily,
+            http_response::status::not_modified,
+            http_response::status::temporary_redirect,
+            http_response::status::permanent_redirect,
+            http_response::status::bad_request,
+            http_response::status::unauthorized,
+            http_response::status::forbidden,
+            http_response::status::not_found,
+            http_response::status::not_allowed,
+            http_response::status::timed_out,
+            http_response::status::conflict,
+            http_response::status::payload_too_large,
+            http_response::status::upgrade_required,
+            http_response::status::too_many_requests,
+            http_response::status::internal_server_error,
+            http_response::status::not_implemented,
+            http_response::status::bad_gateway,
+            http_response::status::service_unavailable
+        };
+
+        constexpr size_t MAX_STATUS_CODE = 600;
+        constexpr size_t VARIANTS = connection_headers * 2;
+
+        // status line, Connection header variant and optional CORS headers
+        std::string build(http_response::status status, connection_header connection, bool with_cors){
+            std::string block = status_strings::get_status_string(status) + misc_strings::crlf;
+            if(connection == with_keep_alive) block += keep_alive;
+            else if(connection == with_close) block += close;
+            if(with_cors) block += cors;
+            return block;
+        }
+
+        struct table{
+            std::array<std::string, std::size(statuses) * VARIANTS> blocks;
+            // status code -> position in statuses + 1, or 0 without pre-serialized blocks
+            std::array<uint8_t, MAX_STATUS_CODE> positions{};
+
+            table(){
+                for(size_t i = 0; i < std::size(statuses); ++i){
+                    positions[static_cast<size_t>(statuses[i])] = static_cast<uint8_t>(i + 1);
+                    for(int connection = 0; connection < connection_headers; ++connection){
+                        for(int with_cors = 0; with_cors < 2; ++with_cors){
+                            blocks[i * VARIANTS + connection * 2 + with_cors] =
+                                build(statuses[i], static_cast<connection_header>(connection), with_cors);
+                        }
+                    }
+                }
+            }
+        };
+
+        // pre-serialized block, or nullptr for unknown status codes
+        const std::string* get(http_response::status status, connection_header connection, bool with_cors){
+            static const table preambles;
+            auto code = static_cast<size_t>(status);
+            if(code >= MAX_STATUS_CODE || preambles.positions[code] == 0) return nullptr;
+            return &preambles.blocks[(preambles.positions[code] - 1) * VARIANTS + connection * 2 + with_cors];
+        }
+
+        // pass the preamble to emit, from a single block when possible; with cors, only the
+        // CORS headers not in cors_set are emitted
+        template<typename Emit>
+        void write(Emit&& emit, http_response::status status, connection_header connection, bool cors_enabled, uint8_t cors_set){
+            if(cors_set == all_cors) cors_enabled = false;
+            bool with_cors = cors_enabled && cors_set == 0;
+            if(auto* block = get(status, connection, with_cors)){
+                emit(*block);
+            }else{
+                emit(status_strings::get_status_string(status));
+                emit(misc_strings::crlf);
+                if(connection == with_keep_alive) emit(keep_alive);
+                else if(connection == with_close) emit(close);
+                if(with_cors) emit(cors);
+            }
+            if(cors_enabled && !with_cors){
+                for(size_t i = 0; i < std::size(cors_lines); ++i){
+                    if(!(cors_set & (1 << i))) emit(cors_lines[i]);
+                }
+            }
+        }
+
+    }
+
+    void http_response::use_preamble(bool keep_alive, bool cors){
+        keep_alive_ = keep_alive;
+        preamble_ = true;
+        cors_ = cors;
+    }
+
+    uint8_t http_response::preamble_cors_header(std::string_view name){
+        for(size_t i = 0; i < std::size(preambles::cors_names); ++i){
+            if(header_ids::detail::iequals(name, preambles::cors_names[i])) return 1 << i;
+        }
+        return 0;
+    }
+
+    uint8_t http_response::preamble_cors_headers(const headers& h){
+        uint8_t set = 0;
+        for(size_t i = 0; i < std::size(preambles::cors_names); ++i){
+            if(h.has_header(preambles::cors_names[i])) set |= 1 << i;
+        }
+        return set;
+    }
+
+    void http_response::append_preamble(std::pmr::string& out, status status, bool keep_alive, bool cors, uint8_t cors_set){
+        auto connection = keep_alive ? preambles::with_keep_alive : preambles::with_close;
+        preambles::write([&](std::string_view piece){ out.append(piece); }, status, connection, cors, cors_set);
+    }
+
+    template<typename Emit>
+    void http_response::write_head(Emit&& emit) const{
+        if(preamble_){
+            // headers set in the response replace the ones of the preamble
+            auto connection = has_header(header_id::connection) ? preambles::without_connection :
+                              keep_alive() ? preambles::with_keep_alive : preambles::with_close;
+            uint8_t cors_set = cors_ ? preamble_cors_headers(*this) : 0;
+            preambles::write(emit, status_, connection, cors_, cors_set);
+        }else{
+            emit(status_strings::get_status_string(status_));
+            emit(misc_strings::crlf);
+        }
         for(const auto& t: headers_){
-            buffer.emplace_back(boost::asio::buffer(t.first));
-            buffer.emplace_back(boost::asio::buffer(misc_strings::name_value_separator));
-            buffer.emplace_back(boost::asio::buffer(t.second));
-            buffer.emplace_back(boost::asio::buffer(misc_strings::crlf));
+            emit(t.first);
+            emit(misc_strings::name_value_separator);
+            emit(t.second);
+            emit(misc_strings::crlf);
+        }
+        emit(misc_strings::crlf);
+    }
+
+    void http_response::finalize(){
+        head_.clear();
+        write_head([this](std::string_view piece){ head_.append(piece); });
+    }
+
+    void http_response::to_buffer(std::vector<boost::asio::const_buffer>& buffer) const{
+        if(!head_.empty()){
+            buffer.emplace_back(boost::asio::buffer(head_.data(), head_.size()));
+        }else{
+            write_head([&](std::string_view piece){ buffer.emplace_back(piece.data(), piece.size()); });
         }
-        buffer.emplace_back(boost::asio::buffer(misc_strings::crlf));
         if(!content_.empty()){
             buffer.emplace_back(boost::asio::buffer(content_));
         }
@@ -343,7 +502,7 @@ namespace thinger::http{
         return response;
     }
 
-    http_response::http_response()= default;
+    http_response::http_response() = default;
 
     bool http_response::is_redirect_response() const{
         return status_ == status::temporary_redirect ||
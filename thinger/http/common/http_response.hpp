@@ -1,6 +1,7 @@
 #ifndef HTTP_RESPONSE_HPP
 #define HTTP_RESPONSE_HPP
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <boost/asio.hpp>
@@ -48,9 +49,29 @@ public:
     http_response();
     ~http_response() override = default;
 
-    // response to buffer
+    // response to buffer: status line and headers, followed by the content. Once finalized,
+    // the status line and headers are a single block
     void to_buffer(std::vector<boost::asio::const_buffer>&buffer) const override;
 
+    // serialize the status line and headers into a single block. Called when the response is
+    // queued for writing; headers changed afterwards are not written
+    void finalize() override;
+
+    // emit the status line, the Connection header and, with cors, the CORS headers from a block
+    // pre-serialized once per combination instead of storing them as headers. A Connection or
+    // CORS header set in the response replaces the one from the block.
+    void use_preamble(bool keep_alive, bool cors);
+
+    // CORS headers emitted by the preamble that are set in h, as a bit mask
+    static uint8_t preamble_cors_headers(const headers& h);
+    // bit of a header name in that mask, or 0 if the preamble does not emit it
+    static uint8_t preamble_cors_header(std::string_view name);
+
+    // append the status line, the Connection header and, with cors, the CORS headers not in
+    // cors_set to out, as use_preamble does for a response without a Connection header
+    static void append_preamble(std::pmr::string& out, status status, bool keep_alive, bool cors,
+                                uint8_t cors_set = 0);
+
     // some setters
     void set_content(std::string content);
     void set_content(std::string content, std::string content_type);
@@ -83,6 +104,14 @@ private:
     std::string content_;
     status status_ = status::ok;
     std::string reason_phrase_;
+    bool preamble_ = false;
+    bool cors_ = false;
+    // serialized status line and headers, built by finalize
+    std::pmr::string head_;
+
+    // pass each piece of the status line and headers to emit
+    template<typename Emit>
+    void write_head(Emit&& emit) const;
 };
 
 }
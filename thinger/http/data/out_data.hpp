@@ -28,7 +28,8 @@ public:
     virtual size_t get_size() = 0;
     virtual void to_buffer(std::vector<boost::asio::const_buffer>& buffer) const = 0;
 
-protected:
+    // append the buffers of this data and any chained data, so several frames can be
+    // gathered into a single write
     void fill_buffer(std::vector<boost::asio::const_buffer>& buffer) {
         to_buffer(buffer);
         if (data_) {
@@ -36,6 +37,7 @@ protected:
         }
     }
 
+    // false for data that must be written with its own to_socket (e.g. sendfile)
     virtual bool supports_buffer() {
         return true;
     }
@@ -0,0 +1,85 @@
+#ifndef THINGER_HTTP_DATA_OUT_JSON_STREAM_HPP
+#define THINGER_HTTP_DATA_OUT_JSON_STREAM_HPP
+
+#include <cstdio>
+#include <nlohmann/json.hpp>
+#include "out_data.hpp"
+#include "../util/json_writer.hpp"
+#include "../../util/logger.hpp"
+
+namespace thinger::http::data{
+
+/**
+ * Chunked body with a JSON document, serialized while it is written: each chunk is written
+ * before serializing the next one, so the output held in memory stays around FLUSH_SIZE
+ * whatever the size of the document. Ends with the last chunk of the body.
+ */
+class out_json_stream : public out_data{
+
+public:
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+    explicit out_json_stream(nlohmann::json document) :
+        document_(std::move(document)), writer_(document_){
+    }
+
+    ~out_json_stream() override = default;
+
+    awaitable<io_result> to_socket(std::shared_ptr<thinger::asio::socket> socket) override{
+        static const std::string crlf = "\r\n";
+        static const std::string last_chunk = "0\r\n\r\n";
+
+        ::thinger::util::output_buffer chunk;
+        std::vector<boost::asio::const_buffer> buffers;
+        char chunk_size[24];
+        size_t written = 0;
+
+        bool done = false;
+        while(!done){
+            try{
+                done = writer_.write(chunk, FLUSH_SIZE);
+            }catch(const nlohmann::json::exception& e){
+                // the status was already sent, so the body can only be cut by closing
+                LOG_ERROR("cannot serialize streamed JSON body: {}", e.what());
+                socket->close();
+                co_return io_result{boost::asio::error::operation_aborted, written};
+            }
+
+            buffers.clear();
+            if(!chunk.empty()){
+                int length = std::snprintf(chunk_size, sizeof(chunk_size), "%zx\r\n", chunk.size());
+                buffers.emplace_back(chunk_size, static_cast<size_t>(length));
+                chunk.to_buffer(buffers);
+                buffers.emplace_back(boost::asio::buffer(crlf));
+            }
+            if(done) buffers.emplace_back(boost::asio::buffer(last_chunk));
+
+            auto [ec, bytes] = co_await socket->write(buffers);
+            written += bytes;
+            if(ec) co_return io_result{ec, written};
+            chunk.clear();
+        }
+        co_return io_result{boost::system::error_code{}, written};
+    }
+
+    size_t get_size() override{
+        // unknown until written
+        return 0;
+    }
+
+    void to_buffer([[maybe_unused]] std::vector<boost::asio::const_buffer>& buffer) const override{
+        LOG_ERROR("cannot append to buffer a streamed JSON body");
+    }
+
+    bool supports_buffer() override{
+        return false;
+    }
+
+private:
+    nlohmann::json document_;
+    util::json_writer writer_;
+};
+
+}
+
+#endif
@@ -58,7 +58,7 @@ namespace thinger::http {
 
 		    // check if gzip a text file
 		    if(fs>200 && extensions.find(extension)!=extensions.end()){
-			    const std::string& accept_encoding = http_request->get_header("Accept-Encoding");
+			    std::string accept_encoding(http_request->get_header(header_id::accept_encoding));
 			    std::vector<std::string> dataLine;
 			    boost::split(dataLine, accept_encoding, boost::is_any_of(","));
 			    for(auto& encoding : dataLine){
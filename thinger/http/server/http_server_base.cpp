@@ -4,6 +4,8 @@
 #include "response.hpp"
 #include "../../util/logger.hpp"
 #include "../../util/base64.hpp"
+#include "../../asio/loop_monitor.hpp"
+#include "../../asio/offload.hpp"
 #include <filesystem>
 
 namespace thinger::http {
@@ -113,38 +115,34 @@ route& http_server_base::options(const std::string& path, route_callback_request
 
 // Middleware
 void http_server_base::use(middleware_function middleware) {
-    middlewares_.push_back(std::move(middleware));
+    middlewares_.add(std::move(middleware));
+}
+
+void http_server_base::use(const std::string& path_prefix, middleware_function middleware) {
+    middlewares_.add(std::move(middleware), path_prefix);
 }
 
 // Basic Auth helpers
 void http_server_base::set_basic_auth(const std::string& path_prefix, 
                                  const std::string& realm,
                                  auth_verify_function verify) {
-    use([path_prefix, realm, verify](request& req, response& res, std::function<void()> next) {
-        // Get the request path
+    // only run for the requests under path_prefix
+    use(path_prefix, [realm, verify](request& req, response& res, std::function<void()> next) {
         auto http_request = req.get_http_request();
         if (!http_request) {
             next();
             return;
         }
-        
-        const std::string& path = http_request->get_uri();
-        
-        // Check if this path requires auth
-        if (!path.starts_with(path_prefix)) {
-            next();
-            return;
-        }
-        
+
         // Check for Authorization header
-        if (!http_request->has_header("Authorization")) {
+        if (!http_request->has_header(header_id::authorization)) {
             res.status(http_response::status::unauthorized);
             res.header("WWW-Authenticate", "Basic realm=\"" + realm + "\"");
             res.send("Authentication required");
             return;
         }
         
-        auto auth_header = http_request->get_header("Authorization");
+        auto auth_header = http_request->get_header(header_id::authorization);
         if (!auth_header.starts_with("Basic ")) {
             res.status(http_response::status::unauthorized);
             res.header("WWW-Authenticate", "Basic realm=\"" + realm + "\"");
@@ -153,7 +151,7 @@ void http_server_base::set_basic_auth(const std::string& path_prefix,
         }
         
         // Decode base64 credentials
-        auto encoded = auth_header.substr(6);
+        std::string encoded(auth_header.substr(6));
         std::string decoded;
         try {
             decoded = ::thinger::util::base64::decode(encoded);
@@ -234,10 +232,30 @@ void http_server_base::set_max_body_size(size_t size) {
     max_body_size_ = size;
 }
 
+void http_server_base::set_max_pipelined_requests(size_t requests) {
+    max_pipelined_requests_ = requests;
+}
+
+void http_server_base::set_max_coalesced_size(size_t size) {
+    max_coalesced_size_ = size;
+}
+
 void http_server_base::set_max_listening_attempts(int attempts) {
     max_listening_attempts_ = attempts;
 }
 
+void http_server_base::set_response_cache_size(size_t size) {
+    response_cache_.set_max_size(size);
+}
+
+void http_server_base::set_response_cache_wait_timeout(std::chrono::milliseconds timeout) {
+    response_cache_.set_wait_timeout(timeout);
+}
+
+void http_server_base::clear_response_cache() {
+    response_cache_.clear();
+}
+
 // Static file serving
 void http_server_base::serve_static(const std::string& url_prefix,
                                const std::string& directory,
@@ -429,17 +447,31 @@ void http_server_base::setup_connection_handler() {
             // 1. Match route
             auto* matched_route = router_.find_route(req);
 
-            // 2. Run middlewares (synchronous)
-            bool passed = false;
-            execute_middlewares(*req, stream, 0, [&passed]() { passed = true; });
-            if (!passed) co_return;
+            // 2. Run server and route middlewares, sharing the response with the handler
+            response res(http_connection, stream, http_request, cors_enabled_);
+            const middleware_chain* route_middlewares = matched_route ? &matched_route->get_middlewares() : nullptr;
+            if (route_middlewares && route_middlewares->empty()) route_middlewares = nullptr;
+
+            if (!middlewares_.empty() || route_middlewares) {
+                // only chains with awaitable middlewares run as a coroutine
+                bool passed;
+                if (middlewares_.is_awaitable() || (route_middlewares && route_middlewares->is_awaitable())) {
+                    passed = co_await middleware_chain::run_async(middlewares_, route_middlewares, *req, res);
+                } else {
+                    passed = middleware_chain::run(middlewares_, route_middlewares, *req, res);
+                }
+                if (!passed) co_return;
+            }
 
             // 3. Three-way dispatch
-            response res(http_connection, stream, http_request, cors_enabled_);
 
             if (!matched_route) {
                 // No route matched → fallback / 404
                 router_.handle_unmatched(req);
+            } else if (matched_route->is_cached() && http_request->get_method() == method::GET &&
+                       !http_request->has_pending_body()) {
+                // CACHED: answer from the response cache, or run the route once for concurrent misses
+                co_await handle_cached(*matched_route, *req, res);
             } else if (matched_route->is_deferred_body()) {
                 // DEFERRED: handler reads body at its discretion
                 co_await matched_route->handle_request_coro(*req, res);
@@ -455,7 +487,11 @@ void http_server_base::setup_connection_handler() {
                     res.error(http_response::status::payload_too_large, "Payload Too Large");
                     co_return;
                 }
-                matched_route->handle_request(*req, res);
+                if (matched_route->is_offloaded()) co_await handle_offloaded(*matched_route, *req, res);
+                else matched_route->handle_request(*req, res);
+            } else if (matched_route->is_offloaded()) {
+                // NO BODY, OFFLOADED: run on the offload pool
+                co_await handle_offloaded(*matched_route, *req, res);
             } else {
                 // NO BODY: dispatch directly
                 matched_route->handle_request(*req, res);
@@ -464,32 +500,46 @@ void http_server_base::setup_connection_handler() {
             co_return;
         });
 
+        connection->set_max_pipelined_requests(max_pipelined_requests_);
+        connection->set_max_coalesced_size(max_coalesced_size_);
+
         // Start handling the connection with configured timeout
         connection->start(connection_timeout_);
     });
 }
 
-void http_server_base::execute_middlewares(request& req, std::shared_ptr<http_stream> stream, 
-                                      size_t index, std::function<void()> final_handler) {
-    if (index >= middlewares_.size()) {
-        // All middlewares executed, call final handler
-        final_handler();
-        return;
-    }
-    
-    // Create response object for middleware
-    auto connection = req.get_http_connection();
-    auto http_request = req.get_http_request();
-    
-    if (connection) {
-        response res(connection, stream, http_request, cors_enabled_);
-        
-        // Execute current middleware
-        middlewares_[index](req, res, [this, &req, stream, index, final_handler]() {
-            // Middleware called next(), execute next middleware
-            execute_middlewares(req, stream, index + 1, final_handler);
+awaitable<void> http_server_base::handle_offloaded(const route& matched_route, request& req, response& res) {
+    // the connection coroutine waits here, so request and response outlive the job
+    try {
+        co_await thinger::offload([&matched_route, &req, &res] {
+            matched_route.handle_request(req, res);
         });
+    } catch (const asio::offload_rejected&) {
+        // counted by the pool; not logged, as it happens under overload
+        res.error(http_response::status::service_unavailable, "Service Unavailable");
+    }
+}
+
+awaitable<void> http_server_base::handle_cached(const route& matched_route, request& req, response& res) {
+    auto lookup = response_cache_.acquire(
+        response_cache::make_key(*req.get_http_request(), matched_route.get_cache_vary()));
+
+    if (!lookup.hit && !lookup.leader) {
+        // another request is running the handler for the same key
+        lookup.hit = co_await response_cache_.wait(lookup.miss);
+    }
+    if (lookup.hit) {
+        res.send_cached(std::move(lookup.hit));
+        co_return;
+    }
+
+    // the leader fills the cache with its response; waiters whose leader did not send a
+    // cacheable one in time run the handler on their own
+    if (lookup.leader) {
+        res.capture(std::make_shared<response_capture>(response_cache_, lookup.miss, matched_route.get_cache_ttl()));
     }
+    if (matched_route.is_offloaded()) co_await handle_offloaded(matched_route, req, res);
+    else co_await matched_route.handle_request_coro(req, res);
 }
 
 } // namespace thinger::http
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "routing/route_handler.hpp"
 #include "routing/route.hpp"
 #include "http_stream.hpp"
+#include "middleware.hpp"
+#include "response_cache.hpp"
 #include "../../asio/socket_server.hpp"
 #include "../../asio/socket_server_base.hpp"
 #include "../../asio/unix_socket_server.hpp"
@@ -19,14 +21,12 @@ namespace thinger::http {
 class request;
 class response;
 
-// Middleware function type
-using middleware_function = std::function<void(request&, response&, std::function<void()>)>;
-
 class http_server_base {
 protected:
     route_handler router_;
     std::unique_ptr<asio::socket_server_base> socket_server_;
-    std::vector<middleware_function> middlewares_;
+    middleware_chain middlewares_;
+    response_cache response_cache_;
     std::string host_ = "0.0.0.0";
     std::string port_ = "8080";
     std::string unix_path_;
@@ -39,6 +39,12 @@ protected:
 
     // Maximum allowed request body size
     size_t max_body_size_{8 * 1024 * 1024}; // 8MB default
+
+    // Pipelined requests without body handled concurrently per connection (1 = disabled)
+    size_t max_pipelined_requests_{1};
+
+    // Largest response piece copied into a contiguous output buffer instead of written as its own iovec
+    size_t max_coalesced_size_{4096};
     
     // Listening attempts (-1 = infinite)
     int max_listening_attempts_ = -1;
@@ -123,6 +129,25 @@ public:
 
     // Middleware
     void use(middleware_function middleware);
+
+    template<typename F>
+        requires requires(F f, request& req, response& res, middleware_next next) {
+            { f(req, res, next) } -> std::same_as<thinger::awaitable<void>>;
+        }
+    void use(F&& middleware) {
+        middlewares_.add(middleware_awaitable(std::forward<F>(middleware)));
+    }
+
+    // Middleware only run for requests whose uri starts with the given prefix
+    void use(const std::string& path_prefix, middleware_function middleware);
+
+    template<typename F>
+        requires requires(F f, request& req, response& res, middleware_next next) {
+            { f(req, res, next) } -> std::same_as<thinger::awaitable<void>>;
+        }
+    void use(const std::string& path_prefix, F&& middleware) {
+        middlewares_.add(middleware_awaitable(std::forward<F>(middleware)), path_prefix);
+    }
     
     // Basic Auth helpers
     using auth_verify_function = std::function<bool(const std::string& username, const std::string& password)>;
@@ -152,7 +177,15 @@ public:
     void enable_ssl(bool enabled = true);
     void set_connection_timeout(std::chrono::seconds timeout);
     void set_max_body_size(size_t size);
+    void set_max_pipelined_requests(size_t requests);
+    void set_max_coalesced_size(size_t size);
     void set_max_listening_attempts(int attempts);
+
+    // Size limit of the responses kept for the routes with cache()
+    void set_response_cache_size(size_t size);
+    // Longest wait for a concurrent request filling the cache before running the handler
+    void set_response_cache_wait_timeout(std::chrono::milliseconds timeout);
+    void clear_response_cache();
     
     // Static file serving
     void serve_static(const std::string& url_prefix,
@@ -199,7 +232,12 @@ protected:
     
 private:
     void setup_connection_handler();
-    void execute_middlewares(request& req, std::shared_ptr<http_stream> stream, size_t index, std::function<void()> final_handler);
+
+    // Run a synchronous route on the offload pool, or answer 503 if it is saturated
+    awaitable<void> handle_offloaded(const route& matched_route, request& req, response& res);
+
+    // Answer from the response cache, or run the route filling it
+    awaitable<void> handle_cached(const route& matched_route, request& req, response& res);
 };
 
 } // namespace thinger::http
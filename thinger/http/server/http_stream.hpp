@@ -1,8 +1,10 @@
 #ifndef HTTP_STREAM_HPP
 #define HTTP_STREAM_HPP
 
+#include <deque>
 #include <queue>
 #include <memory>
+#include <memory_resource>
 #include <functional>
 #include "../common/http_frame.hpp"
 
@@ -30,7 +32,7 @@ namespace thinger::http {
          * Queue for each HTTP frame composing a response. A response can be composed on several frames
          * i.e., while sending large files
          */
-        std::queue<std::shared_ptr<http_frame>> queue_;
+        std::queue<std::shared_ptr<http_frame>, std::pmr::deque<std::shared_ptr<http_frame>>> queue_;
 
         /**
          * Callback to be able to register a function when the stream was completed, i.e., completed a
@@ -41,7 +43,10 @@ namespace thinger::http {
         bool keep_alive_;
 
     public:
-        http_stream(stream_id stream_id, bool keep_alive) : stream_id_(stream_id), keep_alive_(keep_alive) {}
+        http_stream(stream_id stream_id, bool keep_alive,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+            stream_id_(stream_id), queue_(std::pmr::polymorphic_allocator<std::shared_ptr<http_frame>>(resource)),
+            keep_alive_(keep_alive) {}
 
         virtual ~http_stream() {}
 
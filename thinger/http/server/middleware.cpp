@@ -0,0 +1,109 @@
+#include "middleware.hpp"
+#include "request.hpp"
+#include "../../asio/loop_monitor.hpp"
+
+namespace thinger::http {
+
+namespace detail {
+
+    struct middleware_context {
+        const middleware_chain::stage* stages[2];
+        size_t sizes[2];
+        request& req;
+        response& res;
+        std::string_view uri;
+        // stage where a synchronous run stopped at an awaitable middleware or the end
+        size_t resume;
+        bool passed = false;
+
+        size_t total() const { return sizes[0] + sizes[1]; }
+
+        const middleware_chain::stage& at(size_t index) const {
+            return index < sizes[0] ? stages[0][index] : stages[1][index - sizes[0]];
+        }
+
+        // first stage from index that applies to the request uri
+        size_t next(size_t index) const {
+            for (; index < total(); ++index) {
+                const auto& prefix = at(index).prefix;
+                if (prefix.empty() || uri.starts_with(prefix)) break;
+            }
+            return index;
+        }
+    };
+
+}
+
+namespace {
+    constexpr size_t stopped = static_cast<size_t>(-1);
+}
+
+void middleware_chain::add(middleware_function middleware, std::string prefix) {
+    stages_.push_back({std::move(prefix), std::move(middleware), {}});
+}
+
+void middleware_chain::add(middleware_awaitable middleware, std::string prefix) {
+    stages_.push_back({std::move(prefix), {}, std::move(middleware)});
+    awaitable_ = true;
+}
+
+void middleware_chain::run_sync(detail::middleware_context& context, size_t index) {
+    index = context.next(index);
+    if (index == context.total() || context.at(index).awaitable) {
+        context.resume = index;
+        return;
+    }
+
+    // tell the worker watchdog a middleware is running
+    asio::handler_scope scope("middleware");
+    context.at(index).function(context.req, context.res, [&context, index]() {
+        run_sync(context, index + 1);
+    });
+}
+
+awaitable<void> middleware_chain::run_from(detail::middleware_context& context, size_t index) {
+    while (true) {
+        index = context.next(index);
+        if (index == context.total()) {
+            context.passed = true;
+            co_return;
+        }
+
+        const auto& current = context.at(index);
+        if (current.awaitable) {
+            // the rest of the chain runs when the middleware awaits next()
+            co_await current.awaitable(context.req, context.res, middleware_next(context, index + 1));
+            co_return;
+        }
+
+        context.resume = stopped;
+        run_sync(context, index);
+        if (context.resume == stopped) co_return;
+        index = context.resume;
+    }
+}
+
+awaitable<void> middleware_next::operator()() const {
+    return middleware_chain::run_from(*context_, index_);
+}
+
+bool middleware_chain::run(const middleware_chain& server, const middleware_chain* route, request& req, response& res) {
+    detail::middleware_context context{
+        {server.stages_.data(), route ? route->stages_.data() : nullptr},
+        {server.stages_.size(), route ? route->stages_.size() : 0},
+        req, res, req.get_http_request()->get_uri(), stopped};
+    run_sync(context, 0);
+    return context.resume == context.total();
+}
+
+awaitable<bool> middleware_chain::run_async(const middleware_chain& server, const middleware_chain* route,
+                                            request& req, response& res) {
+    detail::middleware_context context{
+        {server.stages_.data(), route ? route->stages_.data() : nullptr},
+        {server.stages_.size(), route ? route->stages_.size() : 0},
+        req, res, req.get_http_request()->get_uri(), stopped};
+    co_await run_from(context, 0);
+    co_return context.passed;
+}
+
+} // namespace thinger::http
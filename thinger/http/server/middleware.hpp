@@ -0,0 +1,84 @@
+#ifndef THINGER_HTTP_SERVER_MIDDLEWARE_HPP
+#define THINGER_HTTP_SERVER_MIDDLEWARE_HPP
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../util/types.hpp"
+
+namespace thinger::http {
+
+// Forward declarations
+class request;
+class response;
+class middleware_next;
+
+// Middleware function type: call next() to continue with the next middleware
+using middleware_function = std::function<void(request&, response&, std::function<void()>)>;
+
+// Awaitable middleware function type: co_await next() to run the rest of the middlewares
+using middleware_awaitable = std::function<thinger::awaitable<void>(request&, response&, middleware_next)>;
+
+namespace detail {
+    struct middleware_context;
+}
+
+// Middlewares in registration order, stored in a flat array and run by a loop instead of
+// nesting a closure per middleware. A middleware can be limited to the requests whose uri
+// starts with a prefix; others are skipped without calling them.
+//
+// Requests run the middlewares of the server and then the ones of the matched route, with
+// the same response object. A synchronous middleware calling next() runs the synchronous
+// middlewares after it before returning, as nested calls; awaitable ones continue after it
+// returns.
+class middleware_chain {
+public:
+    void add(middleware_function middleware, std::string prefix = {});
+    void add(middleware_awaitable middleware, std::string prefix = {});
+
+    bool empty() const { return stages_.empty(); }
+    size_t size() const { return stages_.size(); }
+
+    // Whether some middleware is awaitable, so the chain must run as a coroutine
+    bool is_awaitable() const { return awaitable_; }
+
+    // Run the server middlewares and then the route ones (may be null). Returns true if the
+    // request went through all of them. The synchronous run requires no awaitable middleware
+    static bool run(const middleware_chain& server, const middleware_chain* route, request& req, response& res);
+    static thinger::awaitable<bool> run_async(const middleware_chain& server, const middleware_chain* route,
+                                              request& req, response& res);
+
+private:
+    friend class middleware_next;
+    friend struct detail::middleware_context;
+
+    struct stage {
+        std::string prefix;
+        middleware_function function;
+        middleware_awaitable awaitable;
+    };
+
+    std::vector<stage> stages_;
+    bool awaitable_ = false;
+
+    static void run_sync(detail::middleware_context& context, size_t index);
+    static thinger::awaitable<void> run_from(detail::middleware_context& context, size_t index);
+};
+
+// Continuation given to awaitable middlewares
+class middleware_next {
+public:
+    thinger::awaitable<void> operator()() const;
+
+private:
+    friend class middleware_chain;
+    middleware_next(detail::middleware_context& context, size_t index) : context_(&context), index_(index) {}
+
+    detail::middleware_context* context_;
+    size_t index_;
+};
+
+} // namespace thinger::http
+
+#endif // THINGER_HTTP_SERVER_MIDDLEWARE_HPP
@@ -21,6 +21,7 @@ std::unique_ptr<asio::socket_server> pool_server::create_socket_server(
     
     // Use legacy constructor that automatically uses workers
     auto server = std::make_unique<asio::socket_server>(host, port);
+    server->enable_reuse_port(reuse_port_, incoming_cpu_);
     
     // Configure SSL if enabled
     if (ssl_enabled_) {
@@ -50,6 +51,11 @@ std::unique_ptr<asio::unix_socket_server> pool_server::create_unix_socket_server
     return server;
 }
 
+void pool_server::enable_reuse_port(bool enabled, bool incoming_cpu) {
+    reuse_port_ = enabled;
+    incoming_cpu_ = incoming_cpu;
+}
+
 bool pool_server::stop() {
     // Stop the socket server
     bool result = http_server_base::stop();
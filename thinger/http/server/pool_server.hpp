@@ -30,10 +30,18 @@ public:
     // Expose http_server_base::start overloads (hidden by worker_client::start)
     using http_server_base::start;
     
+    // Accept with one SO_REUSEPORT listener per worker thread, keeping each connection on the
+    // thread that accepted it, optionally with SO_INCOMING_CPU hints (set before listen)
+    void enable_reuse_port(bool enabled = true, bool incoming_cpu = false);
+
     // Implementation of worker_client interface
     bool start() override { return true; } // Already started in listen()
     bool stop() override;
     void wait() override;
+
+private:
+    bool reuse_port_ = false;
+    bool incoming_cpu_ = false;
 };
 
 } // namespace thinger::http
@@ -21,7 +21,9 @@ namespace thinger::http{
 
     }
 
-    request::~request()= default;
+    request::~request(){
+        if(watching_uri_) http_request_->set_uri_change_callback(nullptr);
+    }
 
     const string& request::operator[](const std::string& param) const{
         return get_uri_parameter(param);
@@ -79,24 +81,35 @@ namespace thinger::http{
         params_.erase(param);
 
         // insert the new key-value pair
-        params_.insert(std::make_pair(param, value));
+        params_.add(param, value);
     }
 
     void request::add_uri_parameter(const std::string& param, const std::string& value){
-        params_.insert({param, value});
+        params_.add(param, value);
+    }
+
+    void request::set_route_parameter(std::string_view param, std::string_view value){
+        if(!watching_uri_ && http_request_){
+            watching_uri_ = true;
+            http_request_->set_uri_change_callback([this]{
+                watching_uri_ = false;
+                params_.copy_values(http_request_->get_uri());
+            });
+        }
+        params_.erase(param);
+        params_.add_view(param, value);
     }
 
     const std::string& request::get_uri_parameter(const std::string& param) const{
-        auto it = params_.find(param);
-        if(it!=params_.end()){
-            return it->second;
+        if(auto value = params_.find_string(param)){
+            return *value;
         }
         LOG_WARNING("cannot find required parameter: {}", param);
         static std::string empty_string;
         return empty_string;
     }
 
-    const std::multimap<std::string, std::string>& request::get_uri_parameters() const{
+    const route_params& request::get_uri_parameters() const{
         return params_;
     }
 
@@ -111,7 +124,7 @@ namespace thinger::http{
     std::string request::debug_parameters() const {
         std::stringstream str;
         for(const auto& param: params_){
-            str << "(" << param.first << ":" << param.second << ") ";
+            str << "(" << param.name << ":" << param.value << ") ";
         }
         return str.str();
     }
@@ -213,7 +226,7 @@ namespace thinger::http{
     }
 
     std::string request::header(const std::string& key) const {
-        return http_request_ ? http_request_->get_header(key) : "";
+        return http_request_ ? std::string(http_request_->get_header(key)) : "";
     }
 
     // --- Deferred body reading support ---
@@ -472,8 +485,8 @@ namespace thinger::http{
             }
 
             // Decompress chunked body if Content-Encoding is set
-            if (http_request_->has_header("Content-Encoding")) {
-                std::string encoding = http_request_->get_header("Content-Encoding");
+            if (http_request_->has_header(header_id::content_encoding)) {
+                std::string encoding(http_request_->get_header(header_id::content_encoding));
                 if (encoding == "gzip") {
                     auto decompressed = ::thinger::util::gzip::decompress(body);
                     if (decompressed) {
@@ -509,8 +522,8 @@ namespace thinger::http{
         if (bytes_read != cl) co_return false;
 
         // Decompress body if Content-Encoding is set
-        if (http_request_->has_header("Content-Encoding")) {
-            std::string encoding = http_request_->get_header("Content-Encoding");
+        if (http_request_->has_header(header_id::content_encoding)) {
+            std::string encoding(http_request_->get_header(header_id::content_encoding));
             if (encoding == "gzip") {
                 auto decompressed = ::thinger::util::gzip::decompress(body);
                 if (decompressed) {
@@ -11,6 +11,7 @@
 #include "http_stream.hpp"
 #include "server_connection.hpp"
 #include "../common/http_response.hpp"
+#include "routing/route_params.hpp"
 #include "../../util/types.hpp"
 
 namespace thinger::http{
@@ -32,6 +33,10 @@ namespace thinger::http{
 
         virtual ~request();
 
+        // not copyable, as the http request refers back to its route parameters
+        request(const request&) = delete;
+        request& operator=(const request&) = delete;
+
     public:
         /// get parameter
         const std::string& operator[](const std::string& param) const;
@@ -75,9 +80,15 @@ namespace thinger::http{
 
         void add_uri_parameter(const std::string& param, const std::string& value);
 
+        /// set a parameter without copying it: the name must outlive the request, like the names
+        /// interned by the routes, and the value must outlive the request or point into the uri
+        /// of the http request. Values pointing into the uri are copied before it changes (i.e.,
+        /// when a middleware calls set_uri), so parameters are valid for the whole request
+        void set_route_parameter(std::string_view param, std::string_view value);
+
         const std::string& get_uri_parameter(const std::string& param) const;
 
-        const std::multimap<std::string, std::string>& get_uri_parameters() const;
+        const route_params& get_uri_parameters() const;
 
         void set_auth_groups(const std::set<std::string>& groups);
 
@@ -147,9 +158,13 @@ namespace thinger::http{
         std::shared_ptr<http_request> http_request_;
 
         /**
-         * Vector for storing the matched parameters found in the URL, like username, device, etc.
+         * Parameters found in the URL by the matched route, like username, device, etc., as views
+         * into the request path, plus the ones set by the application.
          */
-        std::multimap<std::string, std::string> params_;
+        route_params params_;
+
+        /// whether params_ is notified before the uri of the http request changes
+        bool watching_uri_ = false;
 
         std::string auth_user_;
 
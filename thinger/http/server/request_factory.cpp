@@ -1,7 +1,10 @@
 #include <sstream>
+#include <algorithm>
+#include <cstring>
 #include "request_factory.hpp"
 #include "../common/http_request.hpp"
 #include "../util/url.hpp"
+#include "../util/char_scan.hpp"
 #include "../../util/logger.hpp"
 
 namespace thinger::http {
@@ -9,6 +12,89 @@ namespace thinger::http {
     request_factory::request_factory() : state_(method_start) {
     }
 
+    boost::tribool request_factory::parse_block(const char*& begin, const char* end) {
+        while (begin != end) {
+            // bulk-append the run of bytes that consume() would just accumulate
+            switch (state_) {
+                case method:
+                case header_name: {
+                    auto* run_end = util::scan::find_token_end(begin, end);
+                    tempString1_.append(begin, run_end);
+                    begin = run_end;
+                    break;
+                }
+                case uri: {
+                    auto* run_end = util::scan::find_uri_end(begin, end);
+                    tempString1_.append(begin, run_end);
+                    begin = run_end;
+                    break;
+                }
+                case header_value: {
+                    auto* run_end = util::scan::find_value_end(begin, end);
+                    tempString2_.append(begin, run_end);
+                    begin = run_end;
+                    break;
+                }
+                case http_version_h:
+                    if (parse_http_version(begin, end)) continue;
+                    break;
+                case header_line_start:
+                    if (parse_header_line(begin, end)) continue;
+                    break;
+                case content: {
+                    // copy as much of the remaining body as this block holds
+                    size_t size = std::min(static_cast<size_t>(end - begin), get_content_length() - get_content_read());
+                    on_content(begin, size);
+                    begin += size;
+                    if (get_content_read() >= get_content_length()) return true;
+                    continue;
+                }
+                default:
+                    break;
+            }
+
+            if (begin == end) break;
+
+            // delimiter or any other state: run the state machine for this byte
+            boost::tribool result = consume(*begin++);
+            if (result || !result)
+                return result;
+        }
+        return boost::indeterminate;
+    }
+
+    bool request_factory::parse_http_version(const char*& begin, const char* end) {
+        static constexpr size_t version_size = sizeof("HTTP/1.1\r\n") - 1;
+        if (static_cast<size_t>(end - begin) < version_size) return false;
+        if (std::memcmp(begin, "HTTP/", 5) != 0 || !is_digit(begin[5]) || begin[6] != '.' ||
+            !is_digit(begin[7]) || begin[8] != '\r' || begin[9] != '\n') {
+            return false;
+        }
+        on_http_major_version(begin[5] - '0');
+        on_http_minor_version(begin[7] - '0');
+        tempInt_ = -1;
+        state_ = header_line_start;
+        begin += version_size;
+        return true;
+    }
+
+    bool request_factory::parse_header_line(const char*& begin, const char* end) {
+        auto* name_end = util::scan::find_token_end(begin, end);
+        // empty name (end of headers, folding, invalid byte) or separator not available yet
+        if (name_end == begin || end - name_end < 2 || name_end[0] != ':' || name_end[1] != ' ') {
+            return false;
+        }
+        auto* value_begin = name_end + 2;
+        auto* value_end = util::scan::find_value_end(value_begin, end);
+        if (end - value_end < 2 || value_end[0] != '\r' || value_end[1] != '\n') {
+            return false;
+        }
+        on_http_header({begin, static_cast<size_t>(name_end - begin)},
+                       {value_begin, static_cast<size_t>(value_end - value_begin)});
+        begin = value_end + 2;
+        return true;
+    }
+
     boost::tribool request_factory::consume(char input) {
         switch (state_) {
             case method_start:
@@ -23,7 +109,11 @@ namespace thinger::http {
             case method:
                 if (input == ' ') {
                     // initialize a new http request if necessary
-                    if(!req) req = std::make_shared<http_request>();
+                    if(!req) {
+                        req = arena_ ? std::allocate_shared<http_request>(::thinger::util::arena_allocator<http_request>(arena_))
+                                     : std::make_shared<http_request>();
+                        if (auto owner = input_owner_.lock()) req->pin_buffer(std::move(owner), input_);
+                    }
                     // store read method
                     on_http_method(tempString1_);
                     tempString1_.clear();
@@ -39,12 +129,17 @@ namespace thinger::http {
                 }
             case uri:
                 if (input == ' ') {
-                    // decode get uri
-                    std::string parsed_uri;
-                    bool parsed_ok = util::url::url_decode(tempString1_, parsed_uri);
+                    // decode get uri (only if it contains escapes)
+                    std::string decoded_uri;
+                    std::string_view parsed_uri = tempString1_;
+                    bool parsed_ok = true;
+                    if (util::url::needs_decoding(parsed_uri)) {
+                        parsed_ok = util::url::url_decode(parsed_uri, decoded_uri);
+                        parsed_uri = decoded_uri;
+                    }
                     if (parsed_ok) {
                         // http_request path must be absolute and not contain "..".
-                        if (parsed_uri.empty() || parsed_uri[0] != '/' || parsed_uri.find("..") != std::string::npos) {
+                        if (parsed_uri.empty() || parsed_uri[0] != '/' || parsed_uri.find("..") != std::string_view::npos) {
                             return false;
                         }
                         on_http_uri(tempString1_);
@@ -215,6 +310,8 @@ namespace thinger::http {
                         return true;
                     }
                     state_ = content;
+                    // presize the body, bounded so a large Content-Length alone cannot reserve memory
+                    req->get_body().reserve(std::min(get_content_length(), MAX_CONTENT_RESERVE));
                     return boost::indeterminate;
                 }
                 return false;
@@ -277,7 +374,18 @@ namespace thinger::http {
         return request;
     }
 
-    void request_factory::on_http_method(const std::string& method){
+    void request_factory::shrink() {
+        if (state_ != method_start || req) return;
+        std::string().swap(tempString1_);
+        std::string().swap(tempString2_);
+    }
+
+    void request_factory::set_input_buffer(const std::shared_ptr<const void>& owner, const void* data, size_t size) {
+        input_owner_ = owner;
+        input_ = {static_cast<const char*>(data), size};
+    }
+
+    void request_factory::on_http_method(std::string_view method){
         req->set_method(method);
     }
 
@@ -298,7 +406,7 @@ namespace thinger::http {
         req->set_http_version_minor(minor);
     }
 
-    void request_factory::on_http_header(const std::string& name, const std::string& value){
+    void request_factory::on_http_header(std::string_view name, std::string_view value){
         req->process_header(name, value);
     }
 
@@ -306,6 +414,10 @@ namespace thinger::http {
         req->get_body().push_back(content);
     }
 
+    void request_factory::on_content(const char* data, size_t size){
+        req->get_body().append(data, size);
+    }
+
     size_t request_factory::get_content_length(){
         return req->get_content_length();
     }
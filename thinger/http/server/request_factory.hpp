@@ -2,9 +2,12 @@
 #define HTTP_REQUEST_PARSER_HPP
 
 #include <memory>
+#include <string_view>
+#include <type_traits>
 #include <boost/logic/tribool.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/lexical_cast.hpp>
+#include "../../util/arena.hpp"
 
 namespace thinger::http {
 
@@ -13,6 +16,10 @@ namespace thinger::http {
     /// Parser for incoming requests.
     class request_factory {
     public:
+        /// Maximum body capacity reserved up front from the Content-Length header; larger
+        /// bodies grow as their data arrives.
+        static constexpr size_t MAX_CONTENT_RESERVE = 1048576;  // 1 MB
+
         /// Construct ready to parse the http_request method.
         request_factory();
 
@@ -22,14 +29,23 @@ namespace thinger::http {
         /// input has been consumed.
         template<typename InputIterator>
         boost::tribool parse(InputIterator& begin, InputIterator end) {
-            while (begin != end) {
-                boost::tribool result = consume(*begin++);
-                // parsed completed or parse failed
-                if (result || !result)
-                    return result;
+            if constexpr (std::is_pointer_v<InputIterator> && sizeof(std::remove_pointer_t<InputIterator>) == 1) {
+                // contiguous byte buffer: scan whole runs at once
+                auto* first = reinterpret_cast<const char*>(begin);
+                auto* cursor = first;
+                boost::tribool result = parse_block(cursor, reinterpret_cast<const char*>(end));
+                begin += cursor - first;
+                return result;
+            } else {
+                while (begin != end) {
+                    boost::tribool result = consume(*begin++);
+                    // parsed completed or parse failed
+                    if (result || !result)
+                        return result;
+                }
+                // still not finished
+                return boost::indeterminate;
             }
-            // still not finished
-            return boost::indeterminate;
         }
 
         void set_headers_only(bool headers_only) {
@@ -40,10 +56,24 @@ namespace thinger::http {
             return headers_only_;
         }
 
+        /// Set the buffer holding the data passed to parse(). Requests created while it is
+        /// set keep it alive and reference their headers in place instead of copying them.
+        void set_input_buffer(const std::shared_ptr<const void>& owner, const void* data, size_t size);
+
+        /// Set the arena new requests are allocated from (the heap if null). Parsing must
+        /// then happen on the thread owning the arena.
+        void set_arena(std::shared_ptr<::thinger::util::arena> arena) {
+            arena_ = std::move(arena);
+        }
+
         std::shared_ptr<http_request> consume_request();
 
+        /// Release the memory held by the token buffers if no request is being parsed,
+        /// so idle connections only keep the parser state.
+        void shrink();
+
 
-        void on_http_method(const std::string& method);
+        void on_http_method(std::string_view method);
 
         void on_http_status_code(unsigned short status_code);
 
@@ -53,10 +83,12 @@ namespace thinger::http {
 
         void on_http_minor_version(uint16_t minor);
 
-        void on_http_header(const std::string& name, const std::string& value);
+        void on_http_header(std::string_view name, std::string_view value);
 
         void on_content(char content);
 
+        void on_content(const char* data, size_t size);
+
         size_t get_content_length();
 
         size_t get_content_read();
@@ -67,6 +99,17 @@ namespace thinger::http {
         /// Handle the next character of input.
         boost::tribool consume(char input);
 
+        /// Parse a contiguous block, appending token, uri, header value and body runs in
+        /// bulk and handing only the delimiters to consume().
+        boost::tribool parse_block(const char*& begin, const char* end);
+
+        /// Consume a complete "HTTP/x.y\r\n" request line suffix if fully available.
+        bool parse_http_version(const char*& begin, const char* end);
+
+        /// Consume a complete "name: value\r\n" header line if fully available, passing
+        /// name and value as views of the input.
+        bool parse_header_line(const char*& begin, const char* end);
+
         /// Check if a byte is an HTTP character.
         static bool is_char(int c);
 
@@ -81,6 +124,11 @@ namespace thinger::http {
 
         std::shared_ptr<http_request> req;
 
+        std::shared_ptr<::thinger::util::arena> arena_;
+
+        std::weak_ptr<const void> input_owner_;
+        std::string_view input_;
+
         std::string tempString1_;
         std::string tempString2_;
         size_t tempInt_;
@@ -5,9 +5,11 @@
 #include "../../util/base64.hpp"
 #include "../../util/sha1.hpp"
 #include "../../asio/sockets/websocket.hpp"
+#include "../../asio/io_uring.hpp"
 #include <boost/algorithm/string.hpp>
 #include "../common/http_data.hpp"
 #include "../data/out_chunk.hpp"
+#include "../data/out_json_stream.hpp"
 #include <fstream>
 #include <sstream>
 
@@ -37,6 +39,17 @@ void response::send_file(const std::filesystem::path& path, bool force_download)
         error(http_response::status::forbidden, "Not a regular file");
         return;
     }
+
+#ifdef THINGER_HTTP_IO_URING_ENABLED
+    // Read the file asynchronously on the connection's thread; blocking read otherwise
+    if (::thinger::asio::io_uring_supported()) {
+        if (auto conn = connection_.lock()) {
+            co_spawn(conn->get_socket()->get_io_context(), read_file(*this, path, force_download), detached);
+        }
+        responded_ = true;
+        return;
+    }
+#endif
     
     // Read file content
     std::ifstream file(path, std::ios::binary);
@@ -53,14 +66,18 @@ void response::send_file(const std::filesystem::path& path, bool force_download)
     // Read file content
     std::string content(file_size, '\0');
     file.read(&content[0], file_size);
-    
+
+    send_file_content(std::move(content), path, force_download);
+}
+
+void response::send_file_content(std::string content, const std::filesystem::path& path, bool force_download) {
     // Determine content type using mime_types
     std::string content_type = mime_types::extension_to_type(path.extension().string());
     
     // Create response
     prepare_response();
     response_->set_status(http_response::status::ok);
-    response_->set_content(content, content_type);
+    response_->set_content(std::move(content), content_type);
     
     // Add Content-Disposition header if force_download is true
     if (force_download) {
@@ -70,6 +87,29 @@ void response::send_file(const std::filesystem::path& path, bool force_download)
     send_prepared_response();
 }
 
+#ifdef THINGER_HTTP_IO_URING_ENABLED
+awaitable<void> response::read_file(response res, std::filesystem::path path, bool force_download) {
+    boost::system::error_code ec;
+    boost::asio::random_access_file file(co_await boost::asio::this_coro::executor);
+    file.open(path.string(), boost::asio::random_access_file::read_only, ec);
+    if (ec) {
+        res.error(http_response::status::internal_server_error, "Failed to open file");
+        co_return;
+    }
+
+    std::string content(file.size(ec), '\0');
+    auto [read_ec, bytes] = co_await boost::asio::async_read_at(file, 0, boost::asio::buffer(content), use_nothrow_awaitable);
+    if (ec || (read_ec && read_ec != boost::asio::error::eof)) {
+        LOG_ERROR("cannot read file {}: {}", path.string(), (ec ? ec : read_ec).message());
+        res.error(http_response::status::internal_server_error, "Failed to read file");
+        co_return;
+    }
+    content.resize(bytes);
+
+    res.send_file_content(std::move(content), path, force_download);
+}
+#endif
+
 // WebSocket upgrade implementation
 void response::upgrade_websocket(std::function<void(std::shared_ptr<websocket_connection>)> handler,
                                 const std::set<std::string>& supported_protocols) {
@@ -83,13 +123,13 @@ void response::upgrade_websocket(std::function<void(std::shared_ptr<websocket_co
     }
     
     // Check if this is a WebSocket upgrade request
-    if (!boost::iequals(http_request_->get_header(http::header::upgrade), "websocket")) {
+    if (!boost::iequals(http_request_->get_header(header_id::upgrade), "websocket")) {
         error(http_response::status::upgrade_required, "This service requires use of WebSockets");
         return;
     }
     
     // Check WebSocket protocol if specified
-    auto protocol = http_request_->get_header("Sec-WebSocket-Protocol");
+    std::string protocol(http_request_->get_header(header_id::sec_websocket_protocol));
     if (!protocol.empty()) {
         LOG_DEBUG("Received WebSocket protocol: {}", protocol);
         if (!supported_protocols.contains(protocol)) {
@@ -102,14 +142,14 @@ void response::upgrade_websocket(std::function<void(std::shared_ptr<websocket_co
     }
     
     // Get WebSocket key
-    auto ws_key = http_request_->get_header("Sec-WebSocket-Key");
+    auto ws_key = http_request_->get_header(header_id::sec_websocket_key);
     if (ws_key.empty()) {
         error(http_response::status::bad_request, "Missing Sec-WebSocket-Key header");
         return;
     }
     
     // Calculate WebSocket accept key
-    std::string accept_key = ws_key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    std::string accept_key = std::string(ws_key) + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
     std::string hash = ::thinger::util::sha1::hash(accept_key);
     accept_key = ::thinger::util::base64::encode(hash);
     
@@ -220,6 +260,19 @@ bool response::start_chunked(const std::string& content_type, http::http_respons
     return true;
 }
 
+void response::json_chunked(nlohmann::json data, http::http_response::status status) {
+    if (!start_chunked("application/json", status)) return;
+
+    auto conn = connection_.lock();
+    auto str = stream_.lock();
+    if (!conn || !str) return;
+
+    // the body frame ends the stream with the last chunk
+    auto body = std::make_shared<http_data>(std::make_shared<data::out_json_stream>(std::move(data)));
+    body->set_last_frame(true);
+    conn->handle_stream(str, body);
+}
+
 bool response::write_chunk(const std::string& data) {
     if (!responded_) {
         LOG_ERROR("Must call start_chunked() before writing chunks");
@@ -7,7 +7,9 @@
 #include "http_stream.hpp"
 #include "websocket_connection.hpp"
 #include "sse_connection.hpp"
+#include "response_cache.hpp"
 #include "../../util/compression.hpp"
+#include "../util/http_date.hpp"
 #include <nlohmann/json.hpp>
 #include <memory>
 #include <functional>
@@ -27,6 +29,8 @@ private:
     std::shared_ptr<http::http_request> http_request_;
     std::shared_ptr<http_response> response_;
     bool responded_ = false;
+    // set when this response fills the response cache
+    std::shared_ptr<response_capture> capture_;
     bool cors_enabled_ = false;
 
     bool ensure_not_responded() const {
@@ -39,20 +43,16 @@ private:
     
     void prepare_response() {
         if (!response_) {
-            response_ = std::make_shared<http_response>();
-            response_->set_keep_alive(http_request_->keep_alive());
-            
-            // Add CORS headers if enabled
-            if (cors_enabled_) {
-                response_->add_header("Access-Control-Allow-Origin", "*");
-                response_->add_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS, HEAD, PATCH");
-                response_->add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
-                response_->add_header("Access-Control-Allow-Credentials", "true");
-            }
+            auto connection = connection_.lock();
+            response_ = connection ? connection->allocate<http_response>() : std::make_shared<http_response>();
+
+            // Status line, Connection and CORS headers come pre-serialized
+            response_->use_preamble(http_request_->keep_alive(), cors_enabled_);
+            response_->add_header(header::date, util::http_date());
         }
     }
     
-    static bool is_compressible_content_type(const std::string& content_type) {
+    static bool is_compressible_content_type(std::string_view content_type) {
         // Only compress text-based content types
         return content_type.starts_with("text/")
             || content_type.starts_with("application/json")
@@ -68,14 +68,14 @@ private:
         if (content.size() < 200) return;
 
         // Don't compress if already compressed
-        if (response_->has_header("Content-Encoding")) return;
+        if (response_->has_header(header_id::content_encoding)) return;
 
         // Only compress text-based content types
         const auto& ct = response_->get_content_type();
         if (ct.empty() || !is_compressible_content_type(ct)) return;
 
         // Check what the client accepts
-        std::string accept_encoding = http_request_->get_header("Accept-Encoding");
+        std::string accept_encoding(http_request_->get_header(header_id::accept_encoding));
         if (accept_encoding.empty()) return;
 
         if (accept_encoding.find("gzip") != std::string::npos) {
@@ -97,6 +97,7 @@ private:
         if (!ensure_not_responded()) return;
         prepare_response();
         compress_response_if_needed();
+        if (capture_) capture_->store(*response_);
 
         if (auto conn = connection_.lock()) {
             if (auto str = stream_.lock()) {
@@ -106,6 +107,14 @@ private:
         responded_ = true;
     }
 
+    // Send the content of a file read by send_file
+    void send_file_content(std::string content, const std::filesystem::path& path, bool force_download);
+
+#ifdef THINGER_HTTP_IO_URING_ENABLED
+    // Read a file through io_uring, without blocking the event loop, and send it with res
+    static awaitable<void> read_file(response res, std::filesystem::path path, bool force_download);
+#endif
+
 public:
     response(const std::shared_ptr<server_connection>& connection,
              const std::shared_ptr<http_stream>& stream, 
@@ -121,6 +130,10 @@ public:
         send_prepared_response();
     }
 
+    // JSON response sent as a chunked body, serialized while it is written, so the memory used
+    // for the output does not grow with the document. Move large documents in. Not compressed
+    void json_chunked(nlohmann::json data, http::http_response::status status = http::http_response::status::ok);
+
     // Text response
     void send(const std::string& text, const std::string& content_type = "text/plain") {
         prepare_response();
@@ -162,18 +175,15 @@ public:
         if (!ensure_not_responded()) return;
         response_ = response;
 
-        // Ensure keep-alive is set properly
-        response_->set_keep_alive(http_request_->keep_alive());
-
-        // Add CORS headers if enabled
-        if (cors_enabled_) {
-            response_->add_header("Access-Control-Allow-Origin", "*");
-            response_->add_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS, HEAD, PATCH");
-            response_->add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
-            response_->add_header("Access-Control-Allow-Credentials", "true");
+        // Keep-alive follows the request, replacing any Connection header of the response
+        response_->remove_header(header::connection);
+        response_->use_preamble(http_request_->keep_alive(), cors_enabled_);
+        if (!response_->has_header(header_id::date)) {
+            response_->add_header(header::date, util::http_date());
         }
 
         compress_response_if_needed();
+        if (capture_) capture_->store(*response_);
 
         if (auto conn = connection_.lock()) {
             if (auto str = stream_.lock()) {
@@ -183,6 +193,25 @@ public:
         responded_ = true;
     }
 
+    // Send a response from the response cache
+    void send_cached(std::shared_ptr<const response_cache::entry> entry) {
+        if (!ensure_not_responded()) return;
+        if (auto conn = connection_.lock()) {
+            if (auto str = stream_.lock()) {
+                conn->handle_stream(str, std::make_shared<cached_response>(std::move(entry),
+                    http_request_->keep_alive(), cors_enabled_, response_.get()));
+            }
+        }
+        responded_ = true;
+    }
+
+    // Store the response sent through this object, or its copies, in the response cache
+    void capture(std::shared_ptr<response_capture> capture) {
+        // headers set so far come from middlewares, not from the handler being cached
+        if (response_) capture->exclude(*response_);
+        capture_ = std::move(capture);
+    }
+
     // WebSocket upgrade
     void upgrade_websocket(std::function<void(std::shared_ptr<websocket_connection>)> handler,
                           const std::set<std::string>& supported_protocols = {});
@@ -0,0 +1,247 @@
+#include "response_cache.hpp"
+#include <algorithm>
+#include <boost/asio/steady_timer.hpp>
+#include "../util/http_date.hpp"
+#include "../../util/logger.hpp"
+
+namespace thinger::http {
+
+response_cache::response_cache(size_t max_size) : max_size_(max_size) {}
+
+std::string response_cache::make_key(const http_request& request, const std::vector<std::string>& vary_headers) {
+    // the encoding the response will be compressed with, chosen as response does
+    auto accept_encoding = request.get_header(header_id::accept_encoding);
+    char encoding = accept_encoding.find("gzip") != std::string_view::npos ? 'g' :
+                    accept_encoding.find("deflate") != std::string_view::npos ? 'd' : '-';
+
+    const auto& uri = request.get_uri();
+    auto host = request.get_header(header_id::host);
+    std::string key;
+    key.reserve(2 + host.size() + uri.size() + vary_headers.size() * 32);
+    key.push_back(encoding);
+    // header values cannot contain line breaks
+    key.append(host);
+    key.push_back('\n');
+    key.append(uri);
+    for (const auto& header : vary_headers) {
+        key.push_back('\n');
+        key.append(request.get_header(header));
+    }
+    return key;
+}
+
+response_cache::lookup response_cache::acquire(const std::string& key) {
+    auto index = std::hash<std::string>{}(key) % SHARDS;
+    auto& shard = shards_[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        if (it->second->second->expires > std::chrono::steady_clock::now()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return {it->second->second, nullptr, false};
+        }
+        erase(shard, it->second);
+    }
+
+    auto flight_it = shard.flights.find(key);
+    if (flight_it != shard.flights.end()) {
+        return {nullptr, flight_it->second, false};
+    }
+
+    std::shared_ptr<flight> miss(new flight(key, index));
+    shard.flights.emplace(key, miss);
+    return {nullptr, std::move(miss), true};
+}
+
+awaitable<std::shared_ptr<const response_cache::entry>> response_cache::wait(std::shared_ptr<flight> miss) {
+    auto timeout = get_wait_timeout();
+    return boost::asio::async_initiate<decltype(use_awaitable), void(std::shared_ptr<const entry>)>(
+        [this, miss, timeout](auto handler) {
+            // the handler is move-only, and resumed on its own executor by the leader or,
+            // if the leader takes too long, once the flight is abandoned
+            using handler_type = decltype(handler);
+            struct waiter {
+                handler_type resume;
+                boost::asio::steady_timer timer;
+            };
+            auto executor = boost::asio::get_associated_executor(handler);
+            auto state = std::make_shared<waiter>(waiter{std::move(handler), boost::asio::steady_timer(executor)});
+
+            auto resume = [state](std::shared_ptr<const entry> result) {
+                boost::asio::post(state->timer.get_executor(), [state, result = std::move(result)]() mutable {
+                    state->timer.cancel();
+                    state->resume(std::move(result));
+                });
+            };
+
+            std::unique_lock<std::mutex> lock(shards_[miss->shard_].mutex);
+            if (!miss->done_) {
+                miss->waiters_.emplace_back(std::move(resume));
+                lock.unlock();
+                state->timer.expires_after(timeout);
+                state->timer.async_wait([this, miss](const boost::system::error_code& ec) {
+                    if (ec) return;
+                    LOG_WARNING("response cache: abandoning a request still running after the wait timeout");
+                    complete(miss, nullptr, std::chrono::milliseconds::zero());
+                });
+                return;
+            }
+            auto result = miss->result_;
+            lock.unlock();
+            resume(std::move(result));
+        }, use_awaitable);
+}
+
+std::shared_ptr<const response_cache::entry> response_cache::make_entry(const http_response& response,
+                                                                         std::chrono::milliseconds ttl,
+                                                                         const header_list& excluded) {
+    // only complete successful responses, not bound to a client
+    if (response.get_status() != http_response::status::ok) return nullptr;
+    if (response.has_header(header_id::set_cookie)) return nullptr;
+
+    auto cached = std::make_shared<entry>();
+    cached->status = response.get_status();
+    cached->cors_headers = 0;
+    for (const auto& [name, value] : response.get_headers()) {
+        auto id = header_ids::lookup(name);
+        if (id == header_id::connection || id == header_id::date) continue;
+
+        // headers set by middlewares before the handler belong to each request
+        bool before_handler = std::any_of(excluded.begin(), excluded.end(), [&](const auto& header) {
+            return header.second == value && header_ids::detail::iequals(header.first, name);
+        });
+        if (before_handler) continue;
+
+        cached->cors_headers |= http_response::preamble_cors_header(name);
+        cached->header_names.emplace_back(name);
+        cached->headers.append(name);
+        cached->headers.append(misc_strings::name_value_separator);
+        cached->headers.append(value);
+        cached->headers.append(misc_strings::crlf);
+    }
+    cached->content = response.get_content();
+    cached->expires = std::chrono::steady_clock::now() + ttl;
+    return cached;
+}
+
+void response_cache::complete(const std::shared_ptr<flight>& miss, const http_response* response,
+                              std::chrono::milliseconds ttl, const header_list& excluded) {
+    auto cached = response ? make_entry(*response, ttl, excluded) : nullptr;
+    auto& shard = shards_[miss->shard_];
+    std::vector<std::function<void(std::shared_ptr<const entry>)>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (miss->done_) return;
+        miss->done_ = true;
+        miss->result_ = cached;
+        waiters.swap(miss->waiters_);
+        shard.flights.erase(miss->key_);
+
+        // entries larger than the shard are not kept
+        size_t shard_max_size = max_size_ / SHARDS;
+        if (cached && cached->size() + miss->key_.size() <= shard_max_size) {
+            auto it = shard.index.find(miss->key_);
+            if (it != shard.index.end()) erase(shard, it->second);
+
+            shard.lru.emplace_front(miss->key_, cached);
+            shard.index.emplace(shard.lru.front().first, shard.lru.begin());
+            shard.size += cached->size() + miss->key_.size();
+
+            while (shard.size > shard_max_size) {
+                erase(shard, std::prev(shard.lru.end()));
+            }
+        }
+    }
+
+    for (auto& waiter : waiters) {
+        waiter(cached);
+    }
+}
+
+void response_cache::erase(shard& shard, decltype(shard::lru)::iterator it) {
+    shard.size -= it->second->size() + it->first.size();
+    shard.index.erase(it->first);
+    shard.lru.erase(it);
+}
+
+void response_cache::set_max_size(size_t max_size) {
+    max_size_ = max_size;
+}
+
+size_t response_cache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.size;
+    }
+    return total;
+}
+
+size_t response_cache::entries() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.lru.size();
+    }
+    return total;
+}
+
+void response_cache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+        shard.size = 0;
+    }
+}
+
+cached_response::cached_response(std::shared_ptr<const response_cache::entry> entry, bool keep_alive, bool cors,
+                                 const http_response* request_headers)
+    : entry_(std::move(entry)) {
+    // headers set for this request by middlewares, unless the cached response sets them
+    std::string own_headers;
+    uint8_t cors_headers = entry_->cors_headers;
+    if (request_headers) {
+        for (const auto& [name, value] : request_headers->get_headers()) {
+            auto id = header_ids::lookup(name);
+            if (id == header_id::connection || id == header_id::date) continue;
+            bool cached = std::any_of(entry_->header_names.begin(), entry_->header_names.end(), [&](const auto& cached_name) {
+                return header_ids::detail::iequals(cached_name, name);
+            });
+            if (cached) continue;
+            cors_headers |= http_response::preamble_cors_header(name);
+            own_headers.append(name);
+            own_headers.append(misc_strings::name_value_separator);
+            own_headers.append(value);
+            own_headers.append(misc_strings::crlf);
+        }
+    }
+
+    http_response::append_preamble(head_, entry_->status, keep_alive, cors, cors_headers);
+    head_.append(header::date);
+    head_.append(misc_strings::name_value_separator);
+    head_.append(util::http_date());
+    head_.append(misc_strings::crlf);
+    head_.append(own_headers);
+    head_.append(entry_->headers);
+    head_.append(misc_strings::crlf);
+}
+
+void cached_response::to_buffer(std::vector<boost::asio::const_buffer>& buffer) const {
+    buffer.emplace_back(boost::asio::buffer(head_.data(), head_.size()));
+    if (!entry_->content.empty()) {
+        buffer.emplace_back(boost::asio::buffer(entry_->content));
+    }
+}
+
+size_t cached_response::get_size() {
+    // size of the payload, as http_response
+    return entry_->content.size();
+}
+
+void cached_response::log(const char* scope, [[maybe_unused]] int level) const {
+    LOG_DEBUG("[{}] cached response: {} bytes", scope, entry_->content.size());
+}
+
+} // namespace thinger::http
@@ -0,0 +1,191 @@
+#ifndef THINGER_HTTP_SERVER_RESPONSE_CACHE_HPP
+#define THINGER_HTTP_SERVER_RESPONSE_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../common/http_frame.hpp"
+#include "../common/http_request.hpp"
+#include "../common/http_response.hpp"
+#include "../../util/types.hpp"
+
+namespace thinger::http {
+
+/**
+ * Cache of complete responses for the routes configured with route::cache(), so repeated GET
+ * requests are answered without running their handler. Responses are stored as sent, once
+ * compressed, and keyed by host, uri, the encoding the client accepts and the values of the
+ * vary headers of the route. Only the headers set by the handler are stored: the ones set by
+ * middlewares before it belong to each request. Entries are spread over shards with their own
+ * lock and LRU list, and the least recently used ones are evicted when a shard exceeds its
+ * part of the size limit.
+ *
+ * Concurrent misses of the same key are collapsed: the first request (the leader) runs the
+ * handler, and the others wait for its response instead of running the handler again. If the
+ * leader takes longer than the wait timeout, the flight is abandoned and every waiter runs
+ * the handler on its own.
+ */
+class response_cache {
+public:
+    static constexpr size_t SHARDS = 16;
+    static constexpr size_t DEFAULT_MAX_SIZE = 32 * 1024 * 1024;
+    static constexpr std::chrono::milliseconds DEFAULT_WAIT_TIMEOUT{5000};
+
+    // Headers of a response set before its handler ran, which are not cached
+    using header_list = std::vector<std::pair<std::string, std::string>>;
+
+    // A cached response, without the Connection and Date headers, which are set per request
+    struct entry {
+        http_response::status status;
+        std::string headers;
+        // names of those headers, so the headers of each request do not repeat them
+        std::vector<std::string> header_names;
+        std::string content;
+        // CORS headers of the preamble set by the response, as http_response::preamble_cors_headers
+        uint8_t cors_headers;
+        std::chrono::steady_clock::time_point expires;
+
+        size_t size() const {
+            size_t names = 0;
+            for (const auto& name : header_names) names += name.size() + sizeof(std::string);
+            return headers.size() + names + content.size() + sizeof(entry);
+        }
+    };
+
+    // A miss being served by a leader
+    class flight {
+    private:
+        friend class response_cache;
+        flight(std::string key, size_t shard) : key_(std::move(key)), shard_(shard) {}
+
+        std::string key_;
+        size_t shard_;
+        bool done_ = false;
+        std::shared_ptr<const entry> result_;
+        std::vector<std::function<void(std::shared_ptr<const entry>)>> waiters_;
+    };
+
+    struct lookup {
+        // cached response, if any
+        std::shared_ptr<const entry> hit;
+        // otherwise, the flight to wait for or, for the leader, to complete
+        std::shared_ptr<flight> miss;
+        bool leader = false;
+    };
+
+    explicit response_cache(size_t max_size = DEFAULT_MAX_SIZE);
+
+    // Key of a request for a route varying on the given headers
+    static std::string make_key(const http_request& request, const std::vector<std::string>& vary_headers);
+
+    // Find a fresh entry, or join or start the flight of the key
+    lookup acquire(const std::string& key);
+
+    // Wait for the leader of a flight. Resolves to null if it did not send a cacheable response
+    // or did not send any within the wait timeout
+    awaitable<std::shared_ptr<const entry>> wait(std::shared_ptr<flight> miss);
+
+    // Complete the flight of a leader, caching the response if given and cacheable, without
+    // the excluded headers, and wake up its waiters
+    void complete(const std::shared_ptr<flight>& miss, const http_response* response, std::chrono::milliseconds ttl,
+                  const header_list& excluded = {});
+
+    void set_max_size(size_t max_size);
+    size_t get_max_size() const { return max_size_; }
+
+    void set_wait_timeout(std::chrono::milliseconds timeout) { wait_timeout_ = timeout.count(); }
+    std::chrono::milliseconds get_wait_timeout() const { return std::chrono::milliseconds(wait_timeout_.load()); }
+
+    // Current size of the entries, and their number
+    size_t size() const;
+    size_t entries() const;
+
+    void clear();
+
+private:
+    struct shard {
+        mutable std::mutex mutex;
+        // most recently used first; the index keys are views into the list keys
+        std::list<std::pair<std::string, std::shared_ptr<const entry>>> lru;
+        std::unordered_map<std::string_view, decltype(lru)::iterator> index;
+        std::unordered_map<std::string, std::shared_ptr<flight>> flights;
+        size_t size = 0;
+    };
+
+    std::array<shard, SHARDS> shards_;
+    std::atomic<size_t> max_size_;
+    std::atomic<std::chrono::milliseconds::rep> wait_timeout_{DEFAULT_WAIT_TIMEOUT.count()};
+
+    static std::shared_ptr<const entry> make_entry(const http_response& response, std::chrono::milliseconds ttl,
+                                                   const header_list& excluded);
+    void erase(shard& shard, decltype(shard::lru)::iterator it);
+};
+
+/**
+ * Completes the flight of a leader with the response it sends, or with no response once the
+ * last copy of the response is destroyed without sending a complete one.
+ */
+class response_capture {
+public:
+    response_capture(response_cache& cache, std::shared_ptr<response_cache::flight> miss,
+                     std::chrono::milliseconds ttl)
+        : cache_(cache), miss_(std::move(miss)), ttl_(ttl) {}
+
+    ~response_capture() {
+        if (miss_) cache_.complete(miss_, nullptr, ttl_);
+    }
+
+    response_capture(const response_capture&) = delete;
+    response_capture& operator=(const response_capture&) = delete;
+
+    // Headers set before the handler runs, by middlewares, are left out of the cached response
+    void exclude(const http_response& response) {
+        for (const auto& [name, value] : response.get_headers()) {
+            excluded_.emplace_back(name, value);
+        }
+    }
+
+    void store(const http_response& response) {
+        if (!miss_) return;
+        cache_.complete(miss_, &response, ttl_, excluded_);
+        miss_.reset();
+    }
+
+private:
+    response_cache& cache_;
+    std::shared_ptr<response_cache::flight> miss_;
+    std::chrono::milliseconds ttl_;
+    response_cache::header_list excluded_;
+};
+
+/**
+ * Frame sending a cached response, adding the Connection and Date headers of this request and
+ * the headers set for it by middlewares
+ */
+class cached_response : public http_frame {
+public:
+    // the head, with the Date of now, is built here, as the frame is created to be sent
+    cached_response(std::shared_ptr<const response_cache::entry> entry, bool keep_alive, bool cors,
+                    const http_response* request_headers = nullptr);
+
+    void to_buffer(std::vector<boost::asio::const_buffer>& buffer) const override;
+    size_t get_size() override;
+    void log(const char* scope, int level) const override;
+
+private:
+    std::shared_ptr<const response_cache::entry> entry_;
+    std::pmr::string head_;
+};
+
+} // namespace thinger::http
+
+#endif // THINGER_HTTP_SERVER_RESPONSE_CACHE_HPP
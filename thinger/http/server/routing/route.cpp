@@ -1,35 +1,88 @@
 #include "route.hpp"
 #include "../response.hpp"
 #include <regex>
+#include <unordered_set>
 #include "../../../util/logger.hpp"
+#include "../../../asio/loop_monitor.hpp"
 
 namespace thinger::http {
 
+namespace {
+
+    std::string_view intern_parameter_name(const std::string& name) {
+        // set nodes do not move, and parameter names are few
+        static std::mutex mutex;
+        static std::unordered_set<std::string> names;
+        std::scoped_lock lock(mutex);
+        return *names.insert(name).first;
+    }
+
+    const std::regex& custom_param_regex() {
+        static const std::regex regex(":([a-zA-Z_][a-zA-Z0-9_]*)\\(([^)]+)\\)");
+        return regex;
+    }
+
+    const std::regex& simple_param_regex() {
+        static const std::regex regex(":([a-zA-Z_][a-zA-Z0-9_]*)(?![\\(])");
+        return regex;
+    }
+
+    // Convert route pattern to an anchored regex. Supports two syntaxes:
+    // 1. :param_name - matches any non-slash characters
+    // 2. :param_name(regex) - matches the specified regex pattern
+    std::string to_regex(const std::string& pattern) {
+        const auto& custom_param = custom_param_regex();
+        const auto& simple_param = simple_param_regex();
+        std::smatch match;
+        std::string temp;
+
+        // Escape special regex characters in the pattern (but not in our parameter patterns)
+        std::string escaped = pattern;
+
+        // First, temporarily replace our parameter patterns to protect them
+        escaped = std::regex_replace(escaped, custom_param, "__CUSTOM_PARAM_$1__");
+        escaped = std::regex_replace(escaped, simple_param, "__SIMPLE_PARAM_$1__");
+
+        // Escape special characters
+        escaped = std::regex_replace(escaped, std::regex("([.^$*+?{}\\[\\]\\\\|])"), "\\\\$1");
+
+        // Now replace parameters with their regex groups
+        // Custom parameters: restore the custom regex
+        temp = pattern;
+        std::string result = escaped;
+        while (std::regex_search(temp, match, custom_param)) {
+            std::string param_name = match[1];
+            std::string param_regex = match[2];
+            std::string placeholder = "__CUSTOM_PARAM_" + param_name + "__";
+            result = std::regex_replace(result, std::regex(placeholder), "(" + param_regex + ")");
+            temp = match.suffix();
+        }
+
+        // Simple parameters: use default regex
+        result = std::regex_replace(result, std::regex("__SIMPLE_PARAM_([a-zA-Z_][a-zA-Z0-9_]*)__"), "([^/]+)");
+
+        // Add anchors
+        return "^" + result + "$";
+    }
+
+}
+
 route::route(const std::string& pattern)
     : pattern_(pattern)
+    , regex_(std::make_shared<lazy_regex>())
 {
-    // Convert route pattern to regex
-    // Support two syntaxes:
-    // 1. :param_name - matches any non-slash characters
-    // 2. :param_name(regex) - matches the specified regex pattern
-    
-    std::string regex_pattern = pattern;
-    
-    // First, handle parameters with custom regex: :param(regex)
-    std::regex custom_param_regex(":([a-zA-Z_][a-zA-Z0-9_]*)\\(([^)]+)\\)");
     std::smatch match;
     std::string temp = pattern;
-    
+
     // Find all :param(regex) patterns
-    while (std::regex_search(temp, match, custom_param_regex)) {
+    while (std::regex_search(temp, match, custom_param_regex())) {
         parameters_.push_back(match[1]);
         temp = match.suffix();
     }
-    
+
     // Then, handle simple parameters: :param
-    std::regex simple_param_regex(":([a-zA-Z_][a-zA-Z0-9_]*)(?![\\(])");
     temp = pattern;
-    while (std::regex_search(temp, match, simple_param_regex)) {
+    while (std::regex_search(temp, match, simple_param_regex())) {
         // Only add if not already added (avoid duplicates with custom regex params)
         std::string param_name = match[1];
         if (std::find(parameters_.begin(), parameters_.end(), param_name) == parameters_.end()) {
@@ -37,36 +90,21 @@ route::route(const std::string& pattern)
         }
         temp = match.suffix();
     }
-    
-    // Escape special regex characters in the pattern (but not in our parameter patterns)
-    std::string escaped = pattern;
-    
-    // First, temporarily replace our parameter patterns to protect them
-    escaped = std::regex_replace(escaped, custom_param_regex, "__CUSTOM_PARAM_$1__");
-    escaped = std::regex_replace(escaped, simple_param_regex, "__SIMPLE_PARAM_$1__");
-    
-    // Escape special characters
-    escaped = std::regex_replace(escaped, std::regex("([.^$*+?{}\\[\\]\\\\|])"), "\\\\$1");
-    
-    // Now replace parameters with their regex groups
-    // Custom parameters: restore the custom regex
-    temp = pattern;
-    std::string result = escaped;
-    while (std::regex_search(temp, match, custom_param_regex)) {
-        std::string param_name = match[1];
-        std::string param_regex = match[2];
-        std::string placeholder = "__CUSTOM_PARAM_" + param_name + "__";
-        result = std::regex_replace(result, std::regex(placeholder), "(" + param_regex + ")");
-        temp = match.suffix();
+
+    parameter_names_.reserve(parameters_.size());
+    for (const auto& name : parameters_) {
+        parameter_names_.push_back(intern_parameter_name(name));
     }
-    
-    // Simple parameters: use default regex
-    result = std::regex_replace(result, std::regex("__SIMPLE_PARAM_([a-zA-Z_][a-zA-Z0-9_]*)__"), "([^/]+)");
-    
-    // Add anchors
-    regex_pattern = "^" + result + "$";
-    
-    regex_ = std::regex(regex_pattern);
+
+    // The pattern regex is only compiled when needed: the route handler matches most
+    // patterns with its route tree
+}
+
+const std::regex& route::get_regex() const {
+    std::call_once(regex_->once, [this] {
+        regex_->regex = std::regex(to_regex(pattern_));
+    });
+    return regex_->regex;
 }
 
 route& route::operator=(route_callback_response_only callback) {
@@ -100,6 +138,22 @@ route& route::deferred_body(bool enabled) {
     return *this;
 }
 
+route& route::offload(bool enabled) {
+    offload_ = enabled;
+    return *this;
+}
+
+route& route::cache(std::chrono::milliseconds ttl, std::vector<std::string> vary_headers) {
+    cache_ttl_ = ttl;
+    cache_vary_ = std::move(vary_headers);
+    return *this;
+}
+
+route& route::use(middleware_function middleware) {
+    middlewares_.add(std::move(middleware));
+    return *this;
+}
+
 route& route::auth(auth_level level) {
     auth_level_ = level;
     return *this;
@@ -111,10 +165,13 @@ route& route::description(const std::string& desc) {
 }
 
 bool route::matches(const std::string& path, std::smatch& matches) const {
-    return std::regex_match(path, matches, regex_);
+    return std::regex_match(path, matches, get_regex());
 }
 
 void route::handle_request(request& req, response& res) const {
+    // tell the worker watchdog which route is running
+    asio::handler_scope scope(pattern_.c_str());
+
     // Handle response-only callback
     if (std::holds_alternative<route_callback_response_only>(callback_)) {
         std::get<route_callback_response_only>(callback_)(res);
@@ -1,12 +1,16 @@
 #ifndef THINGER_HTTP_ROUTE_DESCRIPTOR_HPP
 #define THINGER_HTTP_ROUTE_DESCRIPTOR_HPP
 
+#include <chrono>
 #include <functional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include "../request.hpp"
+#include "../middleware.hpp"
 #include "../../../util/types.hpp"
 
 #ifdef THINGER_HTTP_VALIJSON_ENABLED
@@ -73,6 +77,32 @@ public:
     route& deferred_body(bool enabled = true);
     bool is_deferred_body() const { return deferred_body_; }
 
+    // Offloaded mode - synchronous callbacks run on the workers offload pool instead of the
+    // I/O thread, answering 503 if the pool is saturated
+    route& offload(bool enabled = true);
+    bool is_offloaded() const { return offload_; }
+
+    // Cached mode - GET responses are kept in the server response cache for ttl, keyed by uri and
+    // the given request headers, and concurrent misses run the handler once
+    route& cache(std::chrono::milliseconds ttl, std::vector<std::string> vary_headers = {});
+    bool is_cached() const { return cache_ttl_.count() > 0; }
+    std::chrono::milliseconds get_cache_ttl() const { return cache_ttl_; }
+    const std::vector<std::string>& get_cache_vary() const { return cache_vary_; }
+
+    // Middleware only run for this route, after the server middlewares
+    route& use(middleware_function middleware);
+
+    template<typename F>
+        requires requires(F f, request& req, response& res, middleware_next next) {
+            { f(req, res, next) } -> std::same_as<thinger::awaitable<void>>;
+        }
+    route& use(F&& middleware) {
+        middlewares_.add(middleware_awaitable(std::forward<F>(middleware)));
+        return *this;
+    }
+
+    const middleware_chain& get_middlewares() const { return middlewares_; }
+
     // Set JSON Schema for request body validation
     route& schema(const nlohmann::json& json_schema);
 
@@ -84,9 +114,15 @@ public:
     
     // Check if route matches the given path
     bool matches(const std::string& path, std::smatch& matches) const;
+
+    // Regex equivalent to the pattern, compiled on first use
+    const std::regex& get_regex() const;
     
     // Get route parameters from regex
     const std::vector<std::string>& get_parameters() const { return parameters_; }
+
+    // Same parameters, interned for the life of the process, so requests can refer to them
+    const std::vector<std::string_view>& get_parameter_names() const { return parameter_names_; }
     
     // Get authorization level
     auth_level get_auth_level() const { return auth_level_; }
@@ -101,12 +137,22 @@ public:
     const std::string& get_pattern() const { return pattern_; }
     
 private:
+    struct lazy_regex {
+        std::once_flag once;
+        std::regex regex;
+    };
+
     std::string pattern_;
-    std::regex regex_;
+    std::shared_ptr<lazy_regex> regex_;
     std::vector<std::string> parameters_;
+    std::vector<std::string_view> parameter_names_;
     auth_level auth_level_ = auth_level::PUBLIC;
     std::string description_;
     bool deferred_body_ = false;
+    bool offload_ = false;
+    std::chrono::milliseconds cache_ttl_{0};
+    std::vector<std::string> cache_vary_;
+    middleware_chain middlewares_;
     std::variant<
         route_callback_response_only,
         route_callback_json_response,
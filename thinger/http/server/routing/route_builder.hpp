@@ -4,24 +4,33 @@
 #include <vector>
 #include <string>
 #include "route.hpp"
+#include "route_tree.hpp"
 #include "../../common/http_request.hpp"
 
 namespace thinger::http {
 
 class route_builder {
 public:
-    route_builder(method http_method, std::vector<route>& routes)
-        : method_(http_method), routes_(routes) {}
+    route_builder(method http_method, std::vector<route>& routes, route_tree& tree)
+        : method_(http_method), routes_(routes), tree_(tree) {}
     
     // Create a new route with the given pattern
     route& operator[](const std::string& pattern) {
         routes_.emplace_back(pattern);
+        try {
+            tree_.insert(routes_.back(), routes_.size() - 1);
+        } catch (...) {
+            // invalid parameter regex: the route is not registered
+            routes_.pop_back();
+            throw;
+        }
         return routes_.back();
     }
     
 private:
     method method_;
     std::vector<route>& routes_;
+    route_tree& tree_;
 };
 
 } // namespace thinger::http
@@ -1,14 +1,13 @@
 #include "route_handler.hpp"
 #include "../response.hpp"
 #include "../../../util/logger.hpp"
-#include <regex>
 
 namespace thinger::http {
 
 route_handler::route_handler() = default;
 
 route_builder route_handler::operator[](method http_method) {
-    return route_builder(http_method, routes_[http_method]);
+    return route_builder(http_method, routes_[http_method], trees_[http_method]);
 }
 
 void route_handler::enable_cors(bool enabled) {
@@ -50,7 +49,9 @@ void route_handler::send_error_response(std::shared_ptr<request> req, http_respo
 const route* route_handler::find_route(std::shared_ptr<request> req) {
     auto http_request = req->get_http_request();
     const auto& request_method = http_request->get_method();
-    const auto path = http_request->get_path();
+    // the route parameters point into the uri of the request
+    std::string_view path = http_request->get_uri();
+    path = path.substr(0, path.find('?'));
 
     LOG_DEBUG("Finding route for {} {}", get_method(request_method), path);
 
@@ -61,31 +62,30 @@ const route* route_handler::find_route(std::shared_ptr<request> req) {
         return nullptr;
     }
 
-    // Try to match against registered routes
-    for (auto& route : method_routes->second) {
-        std::smatch matches;
-        if (route.matches(path, matches)) {
-            LOG_DEBUG("Matched route: {}", route.get_pattern());
-
-            // Extract parameters from the match
-            for (size_t i = 0; i < route.get_parameters().size(); ++i) {
-                const auto& param = route.get_parameters()[i];
-                if (i + 1 < matches.size() && matches[i + 1].matched) {
-                    req->set_uri_parameter(param, matches[i + 1].str());
-                }
+    // Find the first registered route matching the path
+    route_tree::match match;
+    if (trees_.at(request_method).find(method_routes->second, path, match)) {
+        const auto& route = method_routes->second[match.index];
+        LOG_DEBUG("Matched route: {}", route.get_pattern());
+
+        // Extract parameters from the match
+        const auto& names = route.get_parameter_names();
+        for (size_t i = 0; i < names.size() && i < match.captures.size(); ++i) {
+            if (match.captures[i].data() != nullptr) {
+                req->set_route_parameter(names[i], match.captures[i]);
             }
+        }
 
-            // Set the matched route in request
-            req->set_matched_route(&route);
-
-            // Check authorization if required
-            if (route.get_auth_level() != auth_level::PUBLIC) {
-                LOG_DEBUG("Route requires authentication level: {}",
-                         static_cast<int>(route.get_auth_level()));
-            }
+        // Set the matched route in request
+        req->set_matched_route(&route);
 
-            return &route;
+        // Check authorization if required
+        if (route.get_auth_level() != auth_level::PUBLIC) {
+            LOG_DEBUG("Route requires authentication level: {}",
+                     static_cast<int>(route.get_auth_level()));
         }
+
+        return &route;
     }
 
     LOG_DEBUG("No matching route found for {}", path);
@@ -7,6 +7,7 @@
 #include "../request_handler.hpp"
 #include "route.hpp"
 #include "route_builder.hpp"
+#include "route_tree.hpp"
 
 namespace thinger::http {
 
@@ -38,6 +39,8 @@ public:
     
 private:
     std::map<method, std::vector<route>> routes_;
+    // routes_ indexed by pattern, to find the first matching route without trying them all
+    std::map<method, route_tree> trees_;
     bool cors_enabled_ = false;
     std::function<void(request&, response&)> fallback_handler_;
     
@@ -0,0 +1,55 @@
+#include "route_params.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace thinger::http {
+
+void route_params::add(std::string_view name, std::string_view value) {
+    const auto& owned_name = strings_.emplace_front(name);
+    const auto& owned_value = strings_.emplace_front(value);
+    auto& added = entries_.emplace_back(owned_name, owned_value);
+    added.string_ = &owned_value;
+}
+
+void route_params::copy_values(std::string_view buffer) {
+    std::less_equal<const char*> le;
+    for (auto& e : entries_) {
+        if (e.value.empty() || !le(buffer.data(), e.value.data()) ||
+            !le(e.value.data() + e.value.size(), buffer.data() + buffer.size())) continue;
+        if (!e.string_) e.string_ = &strings_.emplace_front(e.value);
+        e.value = *e.string_;
+    }
+}
+
+size_t route_params::erase(std::string_view name) {
+    auto removed = std::remove_if(entries_.begin(), entries_.end(),
+                                  [&](const entry& e) { return e.name == name; });
+    size_t count = entries_.end() - removed;
+    entries_.erase(removed, entries_.end());
+    return count;
+}
+
+const route_params::entry* route_params::find_entry(std::string_view name) const {
+    for (const auto& e : entries_) {
+        if (e.name == name) return &e;
+    }
+    return nullptr;
+}
+
+const std::string_view* route_params::find(std::string_view name) const {
+    auto e = find_entry(name);
+    return e ? &e->value : nullptr;
+}
+
+const std::string* route_params::find_string(std::string_view name) const {
+    auto e = find_entry(name);
+    if (!e) return nullptr;
+    if (!e->string_) e->string_ = &strings_.emplace_front(e->value);
+    return e->string_;
+}
+
+size_t route_params::count(std::string_view name) const {
+    return std::count_if(entries_.begin(), entries_.end(), [&](const entry& e) { return e.name == name; });
+}
+
+} // namespace thinger::http
@@ -0,0 +1,71 @@
+#ifndef THINGER_HTTP_ROUTE_PARAMS_HPP
+#define THINGER_HTTP_ROUTE_PARAMS_HPP
+
+#include <forward_list>
+#include <string>
+#include <string_view>
+#include <boost/container/small_vector.hpp>
+
+namespace thinger::http {
+
+// Parameters of a matched route, in the order they were set, kept inline for the usual
+// handful of parameters. Route parameters are views: their names are interned by the route
+// and their values point into the request path, so matching a route does not allocate.
+// Parameters added by the application are copied into the container.
+class route_params {
+public:
+    class entry {
+    public:
+        entry(std::string_view name, std::string_view value) : name(name), value(value) {}
+
+        std::string_view name;
+        std::string_view value;
+
+    private:
+        friend class route_params;
+        // value as std::string, once requested as such
+        mutable const std::string* string_ = nullptr;
+    };
+
+    using container = boost::container::small_vector<entry, 8>;
+    using const_iterator = container::const_iterator;
+
+    // Add a parameter whose name and value outlive this container
+    void add_view(std::string_view name, std::string_view value) {
+        entries_.emplace_back(name, value);
+    }
+
+    // Add a parameter, keeping a copy of its name and value
+    void add(std::string_view name, std::string_view value);
+
+    // Copy the values that are views into buffer, before it changes
+    void copy_values(std::string_view buffer);
+
+    // Remove all parameters with this name, returning how many were removed
+    size_t erase(std::string_view name);
+
+    // Value of the first parameter with this name, or nullptr
+    const std::string_view* find(std::string_view name) const;
+
+    // Value of the first parameter with this name as std::string (created on first use), or nullptr
+    const std::string* find_string(std::string_view name) const;
+
+    bool contains(std::string_view name) const { return find(name) != nullptr; }
+    size_t count(std::string_view name) const;
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+
+private:
+    container entries_;
+    // owned names and values; a list keeps them in place while parameters are added
+    mutable std::forward_list<std::string> strings_;
+
+    const entry* find_entry(std::string_view name) const;
+};
+
+} // namespace thinger::http
+
+#endif // THINGER_HTTP_ROUTE_PARAMS_HPP
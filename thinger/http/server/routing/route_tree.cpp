@@ -0,0 +1,315 @@
+#include "route_tree.hpp"
+#include <algorithm>
+
+namespace thinger::http {
+
+struct route_tree::node {
+    enum class kind { text, param, regex };
+
+    kind type = kind::text;
+    // static text matched by text nodes
+    std::string prefix;
+    // regex of regex nodes, and its source to share nodes between routes
+    std::string source;
+    std::regex regex;
+
+    // text children start with different characters
+    std::vector<std::unique_ptr<node>> children;
+    std::unique_ptr<node> param;
+    std::vector<std::unique_ptr<node>> regexes;
+
+    // route ending at this node, and lowest route index below it, to skip subtrees
+    // that cannot improve the match found so far
+    size_t route = npos;
+    size_t min_route = npos;
+};
+
+struct route_tree::search {
+    std::string_view path;
+    size_t best = npos;
+    decltype(match::captures) captures;
+    decltype(match::captures)* best_captures = nullptr;
+};
+
+namespace {
+
+    struct token {
+        enum class kind { text, param, regex };
+        kind type;
+        std::string text;
+        std::regex regex;
+    };
+
+    bool is_name_start(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    bool is_name_char(char c) {
+        return is_name_start(c) || (c >= '0' && c <= '9');
+    }
+
+    // whether a :param(regex) matched on its own behaves as when embedded in the route regex:
+    // no groups or alternation, no anchors, back references or word boundaries, and no lazy
+    // quantifiers, as candidates are tried from the longest one
+    bool is_plain_regex(const std::string& source) {
+        for (size_t i = 0; i < source.size(); ++i) {
+            char c = source[i];
+            switch (c) {
+                case '(': case '|': case '^': case '$':
+                    return false;
+                case '\\':
+                    if (i + 1 < source.size()) {
+                        char next = source[i + 1];
+                        if ((next >= '0' && next <= '9') || next == 'b' || next == 'B') return false;
+                        ++i;
+                    }
+                    break;
+                case '?':
+                    if (i > 0 && (source[i - 1] == '*' || source[i - 1] == '+' ||
+                                  source[i - 1] == '?' || source[i - 1] == '}')) return false;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
+    // Split a pattern as route builds its regex: static text, :name and :name(regex). Returns
+    // false if the route must be matched with its whole regex instead
+    bool tokenize(const std::string& pattern, std::vector<token>& tokens) {
+        // placeholders used while translating the pattern to a regex
+        if (pattern.find("_PARAM_") != std::string::npos) return false;
+
+        std::string text;
+        std::vector<std::string> regex_names;
+        auto add_param = [&](token::kind type, std::string source) {
+            if (!text.empty()) {
+                tokens.push_back({token::kind::text, std::move(text), {}});
+                text.clear();
+            } else if (!tokens.empty() && tokens.back().type != token::kind::text) {
+                // adjacent parameters split the text by backtracking
+                return false;
+            }
+            std::regex regex;
+            if (type == token::kind::regex) regex = std::regex(source);
+            tokens.push_back({type, std::move(source), std::move(regex)});
+            return true;
+        };
+
+        size_t i = 0;
+        while (i < pattern.size()) {
+            char c = pattern[i];
+            if (c == ':' && i + 1 < pattern.size() && is_name_start(pattern[i + 1])) {
+                size_t end = i + 2;
+                while (end < pattern.size() && is_name_char(pattern[end])) ++end;
+                if (end < pattern.size() && pattern[end] == '(') {
+                    auto close = pattern.find(')', end + 1);
+                    if (close == std::string::npos || close == end + 1) return false;
+                    auto source = pattern.substr(end + 1, close - end - 1);
+                    if (!is_plain_regex(source)) return false;
+                    // the route regex replaces placeholders named after these parameters: a
+                    // repeated name, or names that make a placeholder contain another one,
+                    // swap regexes between parameters
+                    auto name = pattern.substr(i + 1, end - i - 1);
+                    if (name.back() == '_' || name.find("__") != std::string::npos) return false;
+                    if (std::find(regex_names.begin(), regex_names.end(), name) != regex_names.end()) return false;
+                    regex_names.push_back(std::move(name));
+                    if (!add_param(token::kind::regex, std::move(source))) return false;
+                    i = close + 1;
+                } else {
+                    if (!add_param(token::kind::param, {})) return false;
+                    i = end;
+                }
+                continue;
+            }
+            // parenthesis are not escaped in the route regex, and the other regex characters
+            // are escaped as a backslash followed by any character
+            if (std::string_view("()[]{}.^$*+?|\\").find(c) != std::string_view::npos) return false;
+            text += c;
+            ++i;
+        }
+        if (!text.empty()) tokens.push_back({token::kind::text, std::move(text), {}});
+        return true;
+    }
+
+}
+
+route_tree::route_tree() : root_(std::make_unique<node>()) {}
+route_tree::~route_tree() = default;
+route_tree::route_tree(route_tree&&) noexcept = default;
+route_tree& route_tree::operator=(route_tree&&) noexcept = default;
+
+void route_tree::insert(const route& r, size_t index) {
+    std::vector<token> tokens;
+    if (!tokenize(r.get_pattern(), tokens)) {
+        // compile it now, so an invalid pattern fails when registered
+        r.get_regex();
+        regex_routes_.push_back(index);
+        return;
+    }
+
+    node* current = root_.get();
+    current->min_route = std::min(current->min_route, index);
+    for (auto& t : tokens) {
+        switch (t.type) {
+            case token::kind::text:
+                current = insert_static(current, t.text, index);
+                break;
+            case token::kind::param:
+                current = insert_param(current, index);
+                break;
+            case token::kind::regex:
+                current = insert_regex(current, std::move(t.text), std::move(t.regex), index);
+                break;
+        }
+    }
+    current->route = std::min(current->route, index);
+}
+
+route_tree::node* route_tree::insert_static(node* parent, std::string_view text, size_t index) {
+    node* current = parent;
+    while (!text.empty()) {
+        auto it = std::find_if(current->children.begin(), current->children.end(),
+                               [&](const auto& child) { return child->prefix[0] == text[0]; });
+        if (it == current->children.end()) {
+            auto child = std::make_unique<node>();
+            child->prefix = text;
+            child->min_route = index;
+            current->children.push_back(std::move(child));
+            return current->children.back().get();
+        }
+
+        auto& slot = *it;
+        size_t common = 0;
+        while (common < slot->prefix.size() && common < text.size() && slot->prefix[common] == text[common]) ++common;
+
+        if (common < slot->prefix.size()) {
+            // split the child: a new node keeps the shared prefix
+            auto shared = std::make_unique<node>();
+            shared->prefix = slot->prefix.substr(0, common);
+            shared->min_route = slot->min_route;
+            slot->prefix.erase(0, common);
+            shared->children.push_back(std::move(slot));
+            slot = std::move(shared);
+        }
+
+        slot->min_route = std::min(slot->min_route, index);
+        current = slot.get();
+        text.remove_prefix(common);
+    }
+    return current;
+}
+
+route_tree::node* route_tree::insert_param(node* parent, size_t index) {
+    if (!parent->param) {
+        parent->param = std::make_unique<node>();
+        parent->param->type = node::kind::param;
+    }
+    parent->param->min_route = std::min(parent->param->min_route, index);
+    return parent->param.get();
+}
+
+route_tree::node* route_tree::insert_regex(node* parent, std::string source, std::regex regex, size_t index) {
+    auto it = std::find_if(parent->regexes.begin(), parent->regexes.end(),
+                           [&](const auto& child) { return child->source == source; });
+    if (it == parent->regexes.end()) {
+        auto child = std::make_unique<node>();
+        child->type = node::kind::regex;
+        child->source = std::move(source);
+        child->regex = std::move(regex);
+        parent->regexes.push_back(std::move(child));
+        it = std::prev(parent->regexes.end());
+    }
+    (*it)->min_route = std::min((*it)->min_route, index);
+    return it->get();
+}
+
+bool route_tree::find(const std::vector<route>& routes, std::string_view path, match& result) const {
+    search state;
+    state.path = path;
+    state.best_captures = &result.captures;
+    result.captures.clear();
+
+    match_children(*root_, 0, state);
+
+    // routes matched with their regex win if registered before the tree match
+    for (auto index : regex_routes_) {
+        if (index >= state.best) break;
+        std::match_results<std::string_view::const_iterator> matches;
+        if (std::regex_match(path.begin(), path.end(), matches, routes[index].get_regex())) {
+            state.best = index;
+            result.captures.clear();
+            for (size_t i = 1; i < matches.size(); ++i) {
+                if (matches[i].matched) {
+                    result.captures.push_back(path.substr(matches[i].first - path.begin(), matches[i].length()));
+                } else {
+                    result.captures.emplace_back();
+                }
+            }
+            break;
+        }
+    }
+
+    result.index = state.best;
+    return state.best != npos;
+}
+
+void route_tree::match_node(const node& n, size_t pos, search& state) {
+    if (n.min_route >= state.best) return;
+
+    const auto& path = state.path;
+    switch (n.type) {
+        case node::kind::text:
+            if (path.size() - pos < n.prefix.size() || path.compare(pos, n.prefix.size(), n.prefix) != 0) return;
+            match_children(n, pos + n.prefix.size(), state);
+            return;
+
+        case node::kind::param: {
+            // one or more characters up to the next slash, longest first, as the greedy ([^/]+)
+            auto end = path.find('/', pos);
+            if (end == std::string_view::npos) end = path.size();
+            for (size_t last = end; last > pos && n.min_route < state.best; --last) {
+                state.captures.push_back(path.substr(pos, last - pos));
+                match_children(n, last, state);
+                state.captures.pop_back();
+            }
+            return;
+        }
+
+        case node::kind::regex:
+            // the regex only runs on candidates where the rest of a route can continue
+            for (size_t last = path.size() + 1; last-- > pos && n.min_route < state.best;) {
+                bool continues = (last == path.size() && n.route != npos) || n.param || !n.regexes.empty() ||
+                    (last < path.size() && std::any_of(n.children.begin(), n.children.end(),
+                        [&](const auto& child) { return child->prefix[0] == path[last]; }));
+                if (!continues) continue;
+                if (!std::regex_match(path.begin() + pos, path.begin() + last, n.regex)) continue;
+                state.captures.push_back(path.substr(pos, last - pos));
+                match_children(n, last, state);
+                state.captures.pop_back();
+            }
+            return;
+    }
+}
+
+void route_tree::match_children(const node& n, size_t pos, search& state) {
+    const auto& path = state.path;
+    if (pos == path.size()) {
+        if (n.route < state.best) {
+            state.best = n.route;
+            *state.best_captures = state.captures;
+        }
+    } else {
+        for (const auto& child : n.children) {
+            if (child->prefix[0] == path[pos]) {
+                match_node(*child, pos, state);
+                break;
+            }
+        }
+    }
+    if (n.param) match_node(*n.param, pos, state);
+    for (const auto& child : n.regexes) match_node(*child, pos, state);
+}
+
+} // namespace thinger::http
@@ -0,0 +1,69 @@
+#ifndef THINGER_HTTP_ROUTE_TREE_HPP
+#define THINGER_HTTP_ROUTE_TREE_HPP
+
+#include <limits>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/container/small_vector.hpp>
+#include "route.hpp"
+
+namespace thinger::http {
+
+// Compressed radix tree over the route patterns registered for one method.
+//
+// Static text shares prefixes between routes, :param nodes match one or more non-slash
+// characters, and :param(regex) nodes run their regex on the candidate text only. Routes
+// keep their registration index: when several routes match a path, the one registered
+// first wins, as with a linear scan of the patterns.
+//
+// Patterns the tree cannot reproduce exactly (regex characters in the static text, regex
+// parameters with groups, alternation, anchors or lazy quantifiers, a parameter followed
+// by another one...) are matched with the whole route regex, in registration order.
+class route_tree {
+public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    struct match {
+        // index of the route in the registration order
+        size_t index = npos;
+        // parameter values in the order they appear in the pattern, pointing into the
+        // matched path; a default constructed view for an optional group that did not match
+        boost::container::small_vector<std::string_view, 8> captures;
+    };
+
+    route_tree();
+    ~route_tree();
+    route_tree(route_tree&&) noexcept;
+    route_tree& operator=(route_tree&&) noexcept;
+
+    // Add a route registered at the given index; indexes must be added in increasing order
+    void insert(const route& r, size_t index);
+
+    // Find the first registered route matching the path; routes is the vector indexed by insert.
+    // The captures point into path, which must outlive the match
+    bool find(const std::vector<route>& routes, std::string_view path, match& result) const;
+
+    // Number of routes matched with their whole regex instead of the tree
+    size_t regex_routes() const { return regex_routes_.size(); }
+
+private:
+    struct node;
+    struct search;
+
+    std::unique_ptr<node> root_;
+    std::vector<size_t> regex_routes_;
+
+    static node* insert_static(node* parent, std::string_view text, size_t index);
+    static node* insert_param(node* parent, size_t index);
+    static node* insert_regex(node* parent, std::string source, std::regex regex, size_t index);
+
+    static void match_node(const node& n, size_t pos, search& state);
+    static void match_children(const node& n, size_t pos, search& state);
+};
+
+} // namespace thinger::http
+
+#endif // THINGER_HTTP_ROUTE_TREE_HPP
@@ -1,5 +1,9 @@
 #include "server_connection.hpp"
 #include "request.hpp"
+#include "../util/http_date.hpp"
+#include <cstring>
+#include <exception>
+#include <utility>
 #include "../../util/logger.hpp"
 
 namespace thinger::http {
@@ -8,7 +12,10 @@ std::atomic<unsigned long> server_connection::connections(0);
 
 server_connection::server_connection(std::shared_ptr<asio::socket> socket)
     : socket_(std::move(socket))
-    , timeout_timer_(socket_->get_io_context()) {
+    , timeout_timer_(socket_->get_io_context())
+    , arena_(std::make_shared<::thinger::util::arena>())
+    , pipeline_signal_(socket_->get_io_context()) {
+    request_parser_.set_arena(arena_);
     ++connections;
     LOG_DEBUG("created http server connection total: {}", static_cast<unsigned>(connections));
 }
@@ -23,53 +30,124 @@ void server_connection::start(std::chrono::seconds timeout) {
     running_ = true;
     timeout_ = timeout;
 
-    // Start timeout timer
-    reset_timeout();
-
-    // Spawn the read loop coroutine
+    // Spawn the read loop coroutine (the timeout is armed from the connection's io_context)
     co_spawn(socket_->get_io_context(),
         [self = shared_from_this()]() -> awaitable<void> {
+            self->start_timeout();
             co_await self->read_loop();
         },
         detached);
 }
 
-void server_connection::reset_timeout() {
-    timeout_timer_.expires_after(timeout_);
-    timeout_timer_.async_wait([this, self = shared_from_this()](const boost::system::error_code& ec) {
-        if (ec) return; // Timer was cancelled
-
+void server_connection::start_timeout() {
+    // the timer is owned by this connection and cancelled on close, so no reference is kept
+    timeout_timer_.start(timeout_, [this] {
         LOG_DEBUG("http server connection timed out after {} seconds", timeout_.count());
         close();
     });
 }
 
+void server_connection::reset_timeout() {
+    timeout_timer_.touch();
+}
+
+void server_connection::reclaim_buffer(const uint8_t* pending, size_t size) {
+    // requests keep the buffer alive while their headers point into it, so it can
+    // only be overwritten once the last one is released
+    if (buffer_ && buffer_.use_count() == 1) {
+        if (size > 0) std::memmove(buffer_.get(), pending, size);
+        return;
+    }
+    auto previous = std::exchange(buffer_, read_buffer_pool::acquire());
+    request_parser_.set_input_buffer(buffer_, buffer_.get(), MAX_BUFFER_SIZE);
+    if (size > 0) std::memcpy(buffer_.get(), pending, size);
+}
+
+void server_connection::release_buffer() {
+    // buffers still pinned by requests are freed with them instead of returning to the pool
+    request_parser_.set_input_buffer(nullptr, nullptr, 0);
+    read_buffer_pool::release(buffer_);
+    request_parser_.shrink();
+    arena_->trim();
+}
+
+std::shared_ptr<http_stream> server_connection::make_stream(bool keep_alive) {
+    return allocate<http_stream>(++request_id_, keep_alive, arena_.get());
+}
+
 void server_connection::close() {
     running_ = false;
     timeout_timer_.cancel();
+    pipeline_signal_.cancel();
     socket_->close();
 }
 
+bool server_connection::can_pipeline(const http_request& request) const {
+    // requests with a body read it from the socket, and upgrades or closing requests take
+    // over or end the connection: those are handled once the previous ones are done
+    return max_pipelined_requests_ > 1 && request.keep_alive() && !request.upgrade() &&
+           !request.has_pending_body() && !request.is_chunked_transfer();
+}
+
+void server_connection::dispatch_pipelined(std::shared_ptr<request> req) {
+    ++pipelined_;
+    // the handler coroutine keeps the request; completion runs as a plain handler
+    co_spawn(socket_->get_io_context(), handler_(std::move(req)),
+        [this, self = shared_from_this()](std::exception_ptr error) {
+            if (error) {
+                try {
+                    std::rethrow_exception(error);
+                } catch (const std::exception& e) {
+                    LOG_ERROR("error handling pipelined request: {}", e.what());
+                } catch (...) {
+                    LOG_ERROR("error handling pipelined request");
+                }
+            }
+            reset_timeout();
+            --pipelined_;
+            pipeline_signal_.cancel();
+        });
+}
+
+awaitable<void> server_connection::wait_pipelined(size_t limit) {
+    while (pipelined_ >= limit && running_) {
+        pipeline_signal_.expires_at(boost::asio::steady_timer::time_point::max());
+        co_await pipeline_signal_.async_wait(use_nothrow_awaitable);
+    }
+}
+
 awaitable<void> server_connection::read_loop() {
     auto self = shared_from_this();
 
     // Parse headers only; body reading is managed by the handler layer
     request_parser_.set_headers_only(true);
 
-    size_t buffered = 0; // bytes of valid data in buffer_
+    size_t buffered = 0; // bytes of valid data in buffer_, starting at data
+    size_t last_read = 0;
+    uint8_t* data = nullptr;
 
     while (running_ && socket_->is_open()) {
         // If no buffered data, read from socket
         if (buffered == 0) {
-            auto [ec, bytes] = co_await socket_->read_some(buffer_, MAX_BUFFER_SIZE);
+            // Unless the last read filled the buffer, wait for the socket to be readable
+            // without holding a buffer, so idle connections do not keep one. TLS sockets
+            // read directly, as decrypted input may be pending without the socket being readable.
+            if (last_read < MAX_BUFFER_SIZE && !socket_->is_secure()) {
+                release_buffer();
+                auto ec = co_await socket_->wait(boost::asio::socket_base::wait_read);
+                if (ec) break;
+            }
+            reclaim_buffer();
+            data = buffer_.get();
+            auto [ec, bytes] = co_await socket_->read_some(data, MAX_BUFFER_SIZE);
             if (ec) break;
             reset_timeout();
-            buffered = bytes;
+            buffered = last_read = bytes;
         }
 
         // Parse available data
-        uint8_t* begin = buffer_;
-        uint8_t* end = buffer_ + buffered;
+        uint8_t* begin = data;
+        uint8_t* end = begin + buffered;
         boost::tribool result = request_parser_.parse(begin, end);
         size_t unconsumed = static_cast<size_t>(end - begin);
 
@@ -78,21 +156,34 @@ awaitable<void> server_connection::read_loop() {
             auto http_req = request_parser_.consume_request();
             http_req->set_ssl(socket_->is_secure());
 
-            size_t content_length = http_req->get_content_length();
-
-            auto stream = std::make_shared<http_stream>(++request_id_, http_req->keep_alive());
+            auto stream = make_stream(http_req->keep_alive());
 
             // Add to queue for pipelining
             {
                 std::lock_guard<std::mutex> lock(queue_mutex_);
-                request_queue_.push(stream);
+                request_queue_.push_back(stream);
             }
 
             // Log the request
             http_req->log("SERVER REQUEST", 0);
 
+            if (handler_ && can_pipeline(*http_req)) {
+                // Nothing else to read for this request: handle it while parsing the next
+                // one, as the stream order keeps the responses in sequence
+                co_await wait_pipelined(max_pipelined_requests_);
+                if (!running_) break;
+                dispatch_pipelined(allocate<request>(self, stream, http_req));
+                data = begin;
+                buffered = unconsumed;
+                continue;
+            }
+
+            // Requests that read from the socket wait for the pipelined ones to complete
+            co_await wait_pipelined(1);
+            if (!running_) break;
+
             // Create request and store read-ahead data
-            auto req = std::make_shared<request>(self, stream, http_req);
+            auto req = allocate<request>(self, stream, http_req);
             if (unconsumed > 0) {
                 req->set_read_ahead(begin, unconsumed);
             }
@@ -107,10 +198,13 @@ awaitable<void> server_connection::read_loop() {
             // The request tracks how many read-ahead bytes remain unconsumed.
             // Any leftover read-ahead bytes are pipelined data for the next request.
             size_t remaining_ahead = req->read_ahead_available();
+            req.reset();
+            http_req.reset();
             if (remaining_ahead > 0) {
                 // Copy residual read-ahead back to buffer_ for the next iteration
                 size_t ahead_start = unconsumed - remaining_ahead;
-                std::memmove(buffer_, begin + ahead_start, remaining_ahead);
+                reclaim_buffer(begin + ahead_start, remaining_ahead);
+                data = buffer_.get();
                 buffered = remaining_ahead;
             } else {
                 buffered = 0;
@@ -123,10 +217,10 @@ awaitable<void> server_connection::read_loop() {
         } else if (!result) {
             // Bad request
             LOG_ERROR("invalid http request");
-            auto stream = std::make_shared<http_stream>(++request_id_, false);
+            auto stream = make_stream(false);
             {
                 std::lock_guard<std::mutex> lock(queue_mutex_);
-                request_queue_.push(stream);
+                request_queue_.push_back(stream);
             }
             handle_stock_error(stream, http_response::status::bad_request);
             break;
@@ -139,67 +233,148 @@ awaitable<void> server_connection::read_loop() {
     // Connection ended
     running_ = false;
     timeout_timer_.cancel();
+    release_buffer();
 }
 
-awaitable<void> server_connection::write_frame(std::shared_ptr<http_stream> stream,
-                                                std::shared_ptr<http_frame> frame) {
-    // Log response
-    frame->log("SERVER RESPONSE", 0);
+awaitable<void> server_connection::write_frames(output_batch batch) {
+    // Log responses
+    for (const auto& [stream, frame] : batch.frames) {
+        frame->log("SERVER RESPONSE", 0);
+    }
 
-    // Write frame to socket
-    co_await frame->to_socket(socket_);
+    // Write all frames with a single gathered write, unless the frame needs its own path
+    const auto& first = batch.frames.front().second;
+    if (!first->supports_buffer()) {
+        co_await first->to_socket(socket_);
+    } else {
+        co_await socket_->write(batch.buffers);
+        write_buffer_pool::release(batch.output);
+    }
 
     // Reset timeout on activity
     reset_timeout();
 
-    // Check if stream is complete
-    if (frame->end_stream()) {
+    // Complete the streams that ended in this batch, in order
+    for (const auto& [stream, frame] : batch.frames) {
+        if (!frame->end_stream()) continue;
+
         stream->completed();
 
         if (!stream->keep_alive()) {
             close();
-        } else {
-            // Remove completed stream from queue
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            if (!request_queue_.empty()) {
-                request_queue_.pop();
+            break;
+        }
+
+        // Remove completed stream from queue
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!request_queue_.empty() && request_queue_.front() == stream) {
+            request_queue_.pop_front();
+        }
+    }
+}
+
+void server_connection::collect_frames(output_batch& batch) {
+    for (const auto& stream : request_queue_) {
+        bool ended = false;
+
+        while (!stream->empty_queue()) {
+            auto frame = stream->current_frame();
+            bool gathered = frame->supports_buffer();
+
+            // The first frame is always taken, the following ones while within the limits
+            if (!batch.frames.empty() &&
+                (!gathered || batch.buffers.size() >= MAX_WRITE_BUFFERS || batch.bytes >= MAX_WRITE_BYTES)) {
+                return;
+            }
+
+            stream->pop_frame();
+            if (batch.frames.empty()) batch.buffers.reserve(MAX_WRITE_BUFFERS);
+            batch.frames.emplace_back(stream, frame);
+
+            // Frames that cannot be gathered are written alone
+            if (!gathered) return;
+
+            size_t first_buffer = batch.buffers.size();
+            frame->fill_buffer(batch.buffers);
+            for (size_t i = first_buffer; i < batch.buffers.size(); ++i) {
+                batch.bytes += batch.buffers[i].size();
+            }
+
+            if (frame->end_stream()) {
+                ended = true;
+                break;
             }
         }
+
+        // Later responses must wait for this one to end, and nothing follows a
+        // response that closes the connection
+        if (!ended || !stream->keep_alive()) return;
+    }
+}
+
+void server_connection::coalesce_buffers(output_batch& batch) const {
+    if (max_coalesced_size_ == 0 || batch.buffers.size() < 2) return;
+
+    // Rewritten in place: each output buffer replaces at least one of the input ones
+    auto& buffers = batch.buffers;
+    size_t count = 0;
+    size_t used = 0;
+    size_t segment = 0;
+
+    auto flush_segment = [&] {
+        if (used == segment) return;
+        buffers[count++] = boost::asio::const_buffer(batch.output.get() + segment, used - segment);
+        segment = used;
+    };
+
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        auto piece = buffers[i];
+        if (piece.size() <= max_coalesced_size_ && used + piece.size() <= WRITE_BUFFER_SIZE) {
+            if (!batch.output) batch.output = write_buffer_pool::acquire();
+            std::memcpy(batch.output.get() + used, piece.data(), piece.size());
+            used += piece.size();
+        } else {
+            // large bodies, or pieces not fitting anymore, are written from where they are
+            flush_segment();
+            buffers[count++] = piece;
+        }
     }
+    flush_segment();
+    buffers.resize(count);
 }
 
 void server_connection::process_output_queue() {
     if (writing_) return;
 
-    std::shared_ptr<http_stream> stream;
-    std::shared_ptr<http_frame> frame;
-
+    output_batch batch;
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        if (request_queue_.empty()) return;
-
-        stream = request_queue_.front();
-        if (stream->empty_queue()) return;
+        collect_frames(batch);
+    }
 
-        frame = stream->current_frame();
-        stream->pop_frame();
+    if (batch.frames.empty()) {
+        // everything was written: give the arena memory back if no request is alive
+        arena_->trim();
+        return;
     }
 
+    coalesce_buffers(batch);
     writing_ = true;
 
-    co_spawn(socket_->get_io_context(),
-        [this, self = shared_from_this(), stream, frame]() -> awaitable<void> {
-            co_await write_frame(stream, frame);
+    // spawned directly with a plain completion handler, without a wrapping coroutine frame
+    co_spawn(socket_->get_io_context(), write_frames(std::move(batch)),
+        [this, self = shared_from_this()](std::exception_ptr) {
             writing_ = false;
 
             // Process more frames if available
             process_output_queue();
-        },
-        detached);
+        });
 }
 
 void server_connection::handle_stream(std::shared_ptr<http_stream> stream,
                                        std::shared_ptr<http_frame> frame) {
+    // the frame is complete: serialize it on the thread that built it
+    frame->finalize();
     boost::asio::dispatch(socket_->get_io_context(),
         [this, self = shared_from_this(), stream, frame] {
             stream->add_frame(frame);
@@ -224,7 +399,8 @@ void server_connection::handle_stream(std::shared_ptr<http_stream> stream,
 void server_connection::handle_stock_error(std::shared_ptr<http_stream> stream,
                                             http_response::status status) {
     auto http_error = http_response::stock_http_reply(status);
-    http_error->set_keep_alive(stream->keep_alive());
+    http_error->use_preamble(stream->keep_alive(), false);
+    http_error->add_header(header::date, util::http_date());
     handle_stream(stream, http_error);
 }
 
@@ -250,7 +426,7 @@ void server_connection::update_connection_timeout(std::chrono::seconds timeout)
     boost::asio::dispatch(socket_->get_io_context(),
         [this, self = shared_from_this(), timeout] {
             timeout_ = timeout;
-            reset_timeout();
+            if (running_) start_timeout();
         });
 }
 
@@ -1,9 +1,12 @@
 #ifndef THINGER_SERVER_HTTP_SERVER_CONNECTION_HPP
 #define THINGER_SERVER_HTTP_SERVER_CONNECTION_HPP
 
-#include <queue>
+#include <algorithm>
+#include <deque>
+#include <vector>
 #include <atomic>
 #include <mutex>
+#include <boost/asio/steady_timer.hpp>
 #include "request_factory.hpp"
 #include "../common/http_frame.hpp"
 #include "../common/http_request.hpp"
@@ -11,6 +14,9 @@
 #include "http_stream.hpp"
 #include "request_handler.hpp"
 #include "../../util/types.hpp"
+#include "../../util/buffer_pool.hpp"
+#include "../../util/arena.hpp"
+#include "../../asio/timing_wheel.hpp"
 
 namespace thinger::http {
 
@@ -19,8 +25,25 @@ class request;
 class server_connection : public std::enable_shared_from_this<server_connection>, public boost::noncopyable {
 
     static constexpr size_t MAX_BUFFER_SIZE = 4096;
+    using read_buffer_pool = ::thinger::util::buffer_pool<MAX_BUFFER_SIZE>;
     static constexpr auto DEFAULT_TIMEOUT = std::chrono::seconds{120};
     static constexpr size_t DEFAULT_MAX_BODY_SIZE = 8 * 1024 * 1024; // 8MB
+    // limits for gathering ready frames into a single write (64 iovecs fit in one writev)
+    static constexpr size_t MAX_WRITE_BUFFERS = 64;
+    static constexpr size_t MAX_WRITE_BYTES = 256 * 1024;
+    // output buffer for coalescing small pieces of a batch (the size of a TLS record)
+    static constexpr size_t WRITE_BUFFER_SIZE = 16 * 1024;
+    using write_buffer_pool = ::thinger::util::buffer_pool<WRITE_BUFFER_SIZE>;
+    static constexpr size_t DEFAULT_MAX_COALESCED_SIZE = 4096;
+
+    // frames taken from the in-order streams to be written together
+    struct output_batch {
+        std::vector<std::pair<std::shared_ptr<http_stream>, std::shared_ptr<http_frame>>> frames;
+        std::vector<boost::asio::const_buffer> buffers;
+        size_t bytes = 0;
+        // contiguous copy of the small buffers, taken from the pool while the batch is written
+        write_buffer_pool::buffer output;
+    };
 
 public:
     static std::atomic<unsigned long> connections;
@@ -51,50 +74,110 @@ public:
         handler_ = std::move(handler);
     }
 
+    // Create an object of a request in the connection arena when called from the connection's
+    // thread, or in the heap otherwise (the arena is only allocated from its own thread)
+    template<typename T, typename... Args>
+    std::shared_ptr<T> allocate(Args&&... args) {
+        if (socket_->get_io_context().get_executor().running_in_this_thread()) {
+            return std::allocate_shared<T>(::thinger::util::arena_allocator<T>(arena_), std::forward<Args>(args)...);
+        }
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
     // Set maximum allowed body size
     void set_max_body_size(size_t size) {
         max_body_size_ = size;
     }
 
+    // Set how many pipelined requests without body may be handled concurrently (1 = one at a time)
+    void set_max_pipelined_requests(size_t requests) {
+        max_pipelined_requests_ = requests > 0 ? requests : 1;
+    }
+
+    // Set the largest buffer copied into the contiguous output buffer instead of being written
+    // as its own iovec (0 = always scatter/gather). Capped to the output buffer size.
+    void set_max_coalesced_size(size_t size) {
+        max_coalesced_size_ = std::min(size, WRITE_BUFFER_SIZE);
+    }
+
 private:
     // Main read loop coroutine
     awaitable<void> read_loop();
 
-    // Write output queue
-    awaitable<void> write_frame(std::shared_ptr<http_stream> stream, std::shared_ptr<http_frame> frame);
+    // Write a batch of frames and run the completion bookkeeping of each stream
+    awaitable<void> write_frames(output_batch batch);
+
+    // Take the ready frames of the in-order streams, up to the write limits (queue_mutex_ held)
+    void collect_frames(output_batch& batch);
+
+    // Copy the small buffers of a batch into its output buffer, so headers and small bodies go
+    // out as a single contiguous buffer while large bodies are still referenced in place
+    void coalesce_buffers(output_batch& batch) const;
 
     // Process the output queue
     void process_output_queue();
 
+    // Whether a parsed request can be handled while the read loop keeps parsing
+    bool can_pipeline(const http_request& request) const;
+
+    // Handle a request concurrently with the read loop
+    void dispatch_pipelined(std::shared_ptr<request> req);
+
+    // Wait until fewer than limit pipelined requests are being handled
+    awaitable<void> wait_pipelined(size_t limit);
+
     // Handle stock error responses
     void handle_stock_error(std::shared_ptr<http_stream> stream, http_response::status status);
 
-    // Reset timeout timer
+    // Arm the idle timeout with timeout_
+    void start_timeout();
+
+    // Record activity on the connection, postponing the idle timeout
     void reset_timeout();
 
+    // Make buffer_ writable, moving any pending bytes to its start. A fresh buffer is
+    // taken from the pool if there is none or the current one is still pinned by a parsed request.
+    void reclaim_buffer(const uint8_t* pending = nullptr, size_t size = 0);
+
+    // Give buffer_ back to the pool while there is nothing to parse
+    void release_buffer();
+
+    // Create the stream of a new request, with its frame queue in the connection arena
+    std::shared_ptr<http_stream> make_stream(bool keep_alive);
+
     // Close connection
     void close();
 
 private:
     std::shared_ptr<asio::socket> socket_;
-    boost::asio::steady_timer timeout_timer_;
+    asio::wheel_timer timeout_timer_;
     std::chrono::seconds timeout_{DEFAULT_TIMEOUT};
 
-    uint8_t buffer_[MAX_BUFFER_SIZE];
+    // input buffer, only held while reading and shared with the requests whose headers reference it
+    read_buffer_pool::buffer buffer_;
     request_factory request_parser_;
 
+    // memory for the objects of the requests being handled, reused from one request to the next
+    std::shared_ptr<::thinger::util::arena> arena_;
+
     // Queue for HTTP pipelining
-    std::queue<std::shared_ptr<http_stream>> request_queue_;
+    std::deque<std::shared_ptr<http_stream>> request_queue_;
     std::mutex queue_mutex_;
 
     // Request handler callback (awaitable coroutine)
     std::function<awaitable<void>(std::shared_ptr<request>)> handler_;
 
+    // Pipelined requests being handled, and a timer cancelled each time one completes
+    size_t pipelined_{0};
+    boost::asio::steady_timer pipeline_signal_;
+
     // State
     bool writing_{false};
     bool running_{false};
     stream_id request_id_{0};
     size_t max_body_size_{DEFAULT_MAX_BODY_SIZE};
+    size_t max_pipelined_requests_{1};
+    size_t max_coalesced_size_{DEFAULT_MAX_COALESCED_SIZE};
 };
 
 }
@@ -6,6 +6,7 @@
 #include "../common/http_request.hpp"
 #include "../common/http_response.hpp"
 #include "../../asio/sockets/socket.hpp"
+#include "../../asio/timing_wheel.hpp"
 #include "../data/out_string.hpp"
 #include "../../util/logger.hpp"
 #include "../../util/types.hpp"
@@ -29,8 +30,7 @@ public:
 
     sse_connection(std::shared_ptr<asio::socket> socket) :
             socket_(socket),
-            timer_(socket->get_io_context()),
-            idle_(false)
+            timer_(socket->get_io_context())
     {
         connections++;
         LOG_DEBUG("created sse connection total: {}", unsigned(connections));
@@ -46,19 +46,12 @@ private:
 
     void handle_timeout()
     {
-        idle_ = true;
-        timer_.expires_after(std::chrono::seconds(60));
-        timer_.async_wait(
-            [this, self = shared_from_this()](const boost::system::error_code& e){
-                // if timer was not cancelled (just expired by itself)
-                if(e != boost::asio::error::operation_aborted && !idle_){
-                    handle_timeout();
-                }else if(idle_){
-                    // will terminate any pending async reads or writes
-                    socket_->close();
-                }
-            }
-        );
+        // close the connection after 60 seconds without writing any message; the
+        // handler keeps the connection alive until then (or until stop)
+        timer_.start(std::chrono::seconds(60), [this, self = shared_from_this()](){
+            // will terminate any pending async reads or writes
+            socket_->close();
+        });
     }
 
     void process_out_queue()
@@ -85,7 +78,7 @@ private:
 
                         auto [write_ec, write_bytes] = co_await socket_->write(buffers);
                         if (write_ec) break;
-                        idle_ = false;
+                        timer_.touch();
                         out_queue_.pop();
                     }
                     writing_ = false;
@@ -137,9 +130,7 @@ private:
     bool writing_ = false;
 
     /// Timer used for controlling HTTP timeout
-    boost::asio::steady_timer timer_;
-
-    bool idle_;
+    asio::wheel_timer timer_;
 };
 
 }
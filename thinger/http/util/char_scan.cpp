@@ -0,0 +1,180 @@
+#include "char_scan.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define THINGER_HTTP_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace thinger::http::util::scan {
+
+    namespace {
+
+        // same classification as request_factory::is_char, is_ctl and is_tspecial
+        constexpr std::array<bool, 256> make_token_table() {
+            std::array<bool, 256> table{};
+            for (int c = 0x21; c < 0x7F; ++c) table[c] = true;
+            for (unsigned char c : std::string_view("()<>@,;:\\\"/[]?={}")) table[c] = false;
+            return table;
+        }
+
+        constexpr auto token_table = make_token_table();
+
+        // --- SWAR (portable) ---
+
+        constexpr uint64_t ones = 0x0101010101010101ULL;
+        constexpr uint64_t highs = 0x8080808080808080ULL;
+
+        // non-zero if any byte of the word is lower than n (n <= 128)
+        inline uint64_t has_less(uint64_t x, uint8_t n) {
+            return (x - ones * n) & ~x & highs;
+        }
+
+        // non-zero if any byte of the word is equal to n
+        inline uint64_t has_byte(uint64_t x, uint8_t n) {
+            uint64_t y = x ^ (ones * n);
+            return (y - ones) & ~y & highs;
+        }
+
+        template<uint8_t Lowest>
+        const char* swar_find(const char* p, const char* end) {
+            while (end - p >= 8) {
+                uint64_t word;
+                std::memcpy(&word, p, sizeof(word));
+                if (has_less(word, Lowest) | has_byte(word, 0x7F)) break;
+                p += 8;
+            }
+            // locate the exact byte (or scan the tail)
+            while (p != end) {
+                auto c = static_cast<unsigned char>(*p);
+                if (c < Lowest || c == 0x7F) return p;
+                ++p;
+            }
+            return end;
+        }
+
+        const char* swar_value_end(const char* p, const char* end) {
+            return swar_find<0x20>(p, end);
+        }
+
+        const char* swar_uri_end(const char* p, const char* end) {
+            return swar_find<0x21>(p, end);
+        }
+
+#ifdef THINGER_HTTP_SCAN_X86
+
+        // --- SSE4.2: PCMPESTRI with byte ranges ---
+
+        template<uint8_t Lowest>
+        __attribute__((target("sse4.2")))
+        const char* sse42_find(const char* p, const char* end) {
+            // ranges [0x00, Lowest-1] and [0x7F, 0x7F], padded to a full register
+            alignas(16) static constexpr char ranges[16] = {0x00, Lowest - 1, 0x7F, 0x7F};
+            const __m128i ranges16 = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+            while (end - p >= 16) {
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                int index = _mm_cmpestri(ranges16, 4, data, 16,
+                                         _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+                if (index != 16) return p + index;
+                p += 16;
+            }
+            return swar_find<Lowest>(p, end);
+        }
+
+        __attribute__((target("sse4.2")))
+        const char* sse42_value_end(const char* p, const char* end) {
+            return sse42_find<0x20>(p, end);
+        }
+
+        __attribute__((target("sse4.2")))
+        const char* sse42_uri_end(const char* p, const char* end) {
+            return sse42_find<0x21>(p, end);
+        }
+
+        // --- AVX2: 32 bytes per iteration ---
+
+        template<uint8_t Lowest>
+        __attribute__((target("avx2")))
+        const char* avx2_find(const char* p, const char* end) {
+            // bytes are compared as signed: [0, Lowest) is "c > -1 && c < Lowest"
+            const __m256i lowest = _mm256_set1_epi8(static_cast<char>(Lowest));
+            const __m256i minus_one = _mm256_set1_epi8(-1);
+            const __m256i del = _mm256_set1_epi8(0x7F);
+            while (end - p >= 32) {
+                const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const __m256i ctl = _mm256_and_si256(_mm256_cmpgt_epi8(lowest, data),
+                                                     _mm256_cmpgt_epi8(data, minus_one));
+                const __m256i match = _mm256_or_si256(ctl, _mm256_cmpeq_epi8(data, del));
+                auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+                if (mask) return p + __builtin_ctz(mask);
+                p += 32;
+            }
+            return swar_find<Lowest>(p, end);
+        }
+
+        __attribute__((target("avx2")))
+        const char* avx2_value_end(const char* p, const char* end) {
+            return avx2_find<0x20>(p, end);
+        }
+
+        __attribute__((target("avx2")))
+        const char* avx2_uri_end(const char* p, const char* end) {
+            return avx2_find<0x21>(p, end);
+        }
+
+#endif
+
+        struct kernels {
+            const char* (*value_end)(const char*, const char*);
+            const char* (*uri_end)(const char*, const char*);
+            const char* name;
+        };
+
+        kernels detect() {
+#ifdef THINGER_HTTP_SCAN_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return {avx2_value_end, avx2_uri_end, "avx2"};
+            }
+            if (__builtin_cpu_supports("sse4.2")) {
+                return {sse42_value_end, sse42_uri_end, "sse4.2"};
+            }
+#endif
+            return {swar_value_end, swar_uri_end, "swar"};
+        }
+
+        const kernels& active() {
+            static const kernels selected = detect();
+            return selected;
+        }
+    }
+
+    const char* find_token_end(const char* begin, const char* end) {
+        // tokens are short (methods, header names), so a table lookup beats any setup cost
+        while (end - begin >= 4) {
+            if (!token_table[static_cast<unsigned char>(begin[0])]) return begin;
+            if (!token_table[static_cast<unsigned char>(begin[1])]) return begin + 1;
+            if (!token_table[static_cast<unsigned char>(begin[2])]) return begin + 2;
+            if (!token_table[static_cast<unsigned char>(begin[3])]) return begin + 3;
+            begin += 4;
+        }
+        while (begin != end && token_table[static_cast<unsigned char>(*begin)]) ++begin;
+        return begin;
+    }
+
+    const char* find_uri_end(const char* begin, const char* end) {
+        return active().uri_end(begin, end);
+    }
+
+    const char* find_value_end(const char* begin, const char* end) {
+        return active().value_end(begin, end);
+    }
+
+    const char* backend() {
+        return active().name;
+    }
+
+}
@@ -0,0 +1,28 @@
+#ifndef THINGER_HTTP_UTIL_CHAR_SCAN_HPP
+#define THINGER_HTTP_UTIL_CHAR_SCAN_HPP
+
+namespace thinger::http::util::scan {
+
+    // Block-oriented scanners used by the HTTP parsers to skip over whole runs of
+    // bytes instead of feeding them one by one to the state machine. Each function
+    // returns a pointer to the first byte in [begin, end) that terminates the run,
+    // or end if the whole range belongs to it.
+    //
+    // The implementation is selected once at runtime: AVX2 or SSE4.2 on x86-64
+    // CPUs supporting them, and a portable SWAR (8 bytes per word) loop otherwise.
+
+    /// First byte that is not an RFC 7230 token character (method, header name).
+    const char* find_token_end(const char* begin, const char* end);
+
+    /// First space or control character (request-target).
+    const char* find_uri_end(const char* begin, const char* end);
+
+    /// First control character, including CR and HTAB (header field value).
+    const char* find_value_end(const char* begin, const char* end);
+
+    /// Name of the backend selected for this CPU: "avx2", "sse4.2" or "swar".
+    const char* backend();
+
+}
+
+#endif
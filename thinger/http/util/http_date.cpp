@@ -0,0 +1,60 @@
+#include "http_date.hpp"
+#include <cstring>
+
+namespace thinger::http::util {
+
+    namespace {
+
+        constexpr const char* week_days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+        constexpr const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                          "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+        char* put_two_digits(char* out, int value) {
+            *out++ = static_cast<char>('0' + value / 10);
+            *out++ = static_cast<char>('0' + value % 10);
+            return out;
+        }
+
+        struct cached_date {
+            std::time_t second = -1;
+            char text[HTTP_DATE_SIZE];
+        };
+
+    }
+
+    void format_http_date(std::time_t time, char* out) {
+        std::tm tm{};
+        gmtime_r(&time, &tm);
+
+        // locale independent, unlike strftime: "Sun, 06 Nov 1994 08:49:37 GMT"
+        std::memcpy(out, week_days[tm.tm_wday], 3);
+        out[3] = ',';
+        out[4] = ' ';
+        char* p = put_two_digits(out + 5, tm.tm_mday);
+        *p++ = ' ';
+        std::memcpy(p, months[tm.tm_mon], 3);
+        p += 3;
+        *p++ = ' ';
+        int year = tm.tm_year + 1900;
+        p = put_two_digits(p, year / 100 % 100);
+        p = put_two_digits(p, year % 100);
+        *p++ = ' ';
+        p = put_two_digits(p, tm.tm_hour);
+        *p++ = ':';
+        p = put_two_digits(p, tm.tm_min);
+        *p++ = ':';
+        p = put_two_digits(p, tm.tm_sec);
+        std::memcpy(p, " GMT", 4);
+    }
+
+    std::string_view http_date() {
+        thread_local cached_date cache;
+        std::time_t now = std::time(nullptr);
+        if (now != cache.second) {
+            format_http_date(now, cache.text);
+            cache.second = now;
+        }
+        return {cache.text, HTTP_DATE_SIZE};
+    }
+
+}
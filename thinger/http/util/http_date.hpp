@@ -0,0 +1,23 @@
+#ifndef THINGER_HTTP_UTIL_HTTP_DATE_HPP
+#define THINGER_HTTP_UTIL_HTTP_DATE_HPP
+
+#include <cstddef>
+#include <ctime>
+#include <string_view>
+
+namespace thinger::http::util {
+
+    /// Length of an IMF-fixdate, i.e., "Sun, 06 Nov 1994 08:49:37 GMT".
+    constexpr size_t HTTP_DATE_SIZE = 29;
+
+    /// Current time as an IMF-fixdate (RFC 9110), for the Date header. The value is cached
+    /// per thread and only formatted again when the second changes, so the view is valid
+    /// until the next call from the same thread.
+    std::string_view http_date();
+
+    /// Format a time as an IMF-fixdate into out, which must hold HTTP_DATE_SIZE characters.
+    void format_http_date(std::time_t time, char* out);
+
+}
+
+#endif
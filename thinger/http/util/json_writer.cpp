@@ -0,0 +1,96 @@
+#include "json_writer.hpp"
+
+namespace thinger::http::util {
+
+    using ::thinger::util::output_buffer;
+
+    // serializer and output_adapter_protocol are nlohmann internals, stable across the 3.11
+    // releases, the version pinned in CMakeLists.txt
+    static_assert(NLOHMANN_JSON_VERSION_MAJOR == 3 && NLOHMANN_JSON_VERSION_MINOR == 11,
+                  "json_writer uses the nlohmann 3.11 serializer: review it when upgrading");
+
+    struct json_writer::adapter : nlohmann::detail::output_adapter_protocol<char> {
+        output_buffer* out = nullptr;
+
+        void write_character(char c) override {
+            out->push_back(c);
+        }
+
+        void write_characters(const char* s, std::size_t length) override {
+            out->append(s, length);
+        }
+    };
+
+    json_writer::json_writer(const nlohmann::json& value) :
+        root_(value),
+        adapter_(std::make_shared<adapter>()),
+        serializer_(adapter_, ' '),
+        key_(nlohmann::json::value_t::string) {}
+
+    bool json_writer::write(output_buffer& out, size_t limit) {
+        if (done_) return true;
+        adapter_->out = &out;
+
+        if (!started_) {
+            started_ = true;
+            open(root_, out);
+        }
+
+        while (!stack_.empty()) {
+            if (out.size() >= limit) return false;
+
+            auto& top = stack_.back();
+            bool object = top.container->is_object();
+            if (top.next == top.container->cend()) {
+                out.push_back(object ? '}' : ']');
+                stack_.pop_back();
+                continue;
+            }
+
+            if (!top.first) out.push_back(',');
+            top.first = false;
+            if (object) write_key(top.next.key(), out);
+
+            // advanced before open, which may grow the stack
+            const auto& value = *top.next;
+            ++top.next;
+            open(value, out);
+        }
+
+        done_ = true;
+        return true;
+    }
+
+    void json_writer::open(const nlohmann::json& value, output_buffer& out) {
+        if (value.is_structured() && !value.empty()) {
+            out.push_back(value.is_object() ? '{' : '[');
+            stack_.push_back({&value, value.cbegin(), true});
+        } else {
+            // scalars and empty containers are small
+            serializer_.dump(value, false, false, 0);
+        }
+    }
+
+    void json_writer::write_key(const std::string& key, output_buffer& out) {
+        // keys without characters to escape are written as they are
+        bool plain = true;
+        for (char c : key) {
+            auto u = static_cast<unsigned char>(c);
+            if (u < 0x20 || u > 0x7e || c == '"' || c == '\\') {
+                plain = false;
+                break;
+            }
+        }
+
+        if (plain) {
+            out.push_back('"');
+            out.append(key.data(), key.size());
+            out.push_back('"');
+        } else {
+            key_.get_ref<std::string&>() = key;
+            serializer_.dump(key_, false, false, 0);
+        }
+        out.push_back(':');
+    }
+
+}
@@ -0,0 +1,54 @@
+#ifndef THINGER_HTTP_UTIL_JSON_WRITER_HPP
+#define THINGER_HTTP_UTIL_JSON_WRITER_HPP
+
+#include <memory>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../../util/output_buffer.hpp"
+
+namespace thinger::http::util {
+
+    // Serializes a JSON document in parts, as nlohmann::json::dump() without indentation,
+    // stopping between values once the output reaches a size, so large documents can be
+    // written while they are serialized. Values are written straight into the output by
+    // the nlohmann serializer, without intermediate strings. The document must outlive
+    // the writer.
+    class json_writer {
+    public:
+        explicit json_writer(const nlohmann::json& value);
+
+        json_writer(const json_writer&) = delete;
+        json_writer& operator=(const json_writer&) = delete;
+
+        // Write into out until it holds at least limit bytes or the document ends. Returns
+        // true once the whole document was written
+        bool write(::thinger::util::output_buffer& out, size_t limit);
+
+        bool done() const { return done_; }
+
+    private:
+        // nlohmann output adapter appending to the output of the current write
+        struct adapter;
+
+        struct level {
+            const nlohmann::json* container;
+            nlohmann::json::const_iterator next;
+            bool first;
+        };
+
+        const nlohmann::json& root_;
+        std::shared_ptr<adapter> adapter_;
+        nlohmann::detail::serializer<nlohmann::json> serializer_;
+        // keys to escape are dumped from here, reusing its storage
+        nlohmann::json key_;
+        std::vector<level> stack_;
+        bool started_ = false;
+        bool done_ = false;
+
+        void open(const nlohmann::json& value, ::thinger::util::output_buffer& out);
+        void write_key(const std::string& key, ::thinger::util::output_buffer& out);
+    };
+
+}
+
+#endif
@@ -54,7 +54,13 @@ namespace thinger::http::util::url{
         return result;
     }
 
-    bool url_decode(const std::string &in, std::string &out) {
+    bool url_decode(std::string_view in, std::string &out) {
+        // nothing to decode: plain copy
+        if (!needs_decoding(in)) {
+            out.assign(in);
+            return true;
+        }
+
         out.clear();
         out.reserve(in.size());
 
@@ -75,7 +81,7 @@ namespace thinger::http::util::url{
         return true;
     }
 
-    std::string url_decode(const std::string &in) {
+    std::string url_decode(std::string_view in) {
         std::string out;
         if (url_decode(in, out)) {
             return out;
@@ -83,37 +89,97 @@ namespace thinger::http::util::url{
         return {};
     }
 
-    void parse_url_encoded_data(const std::string &data, std::multimap<std::string, std::string>& store) {
-        auto start = data.cbegin();
-        auto end = data.cend();
-        parse_url_encoded_data(start, end, store);
+    void parse_url_encoded_data(std::string_view data, std::multimap<std::string, std::string>& store) {
+        while (!data.empty()) {
+            // find the end of the current key=value pair
+            auto pair_end = data.find('&');
+            std::string_view pair = data.substr(0, pair_end);
+            data = pair_end == std::string_view::npos ? std::string_view{} : data.substr(pair_end + 1);
+
+            // find the '=' separator within the pair
+            auto eq_pos = pair.find('=');
+            std::string_view key = pair.substr(0, eq_pos);
+            std::string_view value = eq_pos == std::string_view::npos ? std::string_view{} : pair.substr(eq_pos + 1);
+
+            if (!key.empty()) {
+                store.emplace(url_decode(key), url_decode(value));
+            }
+        }
     }
 
     void parse_url_encoded_data(std::string::const_iterator& start, std::string::const_iterator& end, std::multimap<std::string, std::string>& store) {
         if (start == end) return;
+        parse_url_encoded_data(std::string_view(&*start, static_cast<size_t>(end - start)), store);
+        start = end;
+    }
 
-        auto it = start;
-        while (it != end) {
-            // find the end of the current key=value pair
-            auto pair_end = std::find(it, end, '&');
-
-            // find the '=' separator within the pair
-            auto eq_pos = std::find(it, pair_end, '=');
+    bool split_uri(std::string_view uri, uri_parts& parts) {
+        parts = {};
+        std::string_view rest = uri;
 
-            std::string key(it, eq_pos);
-            std::string value;
-            if (eq_pos != pair_end) {
-                value.assign(eq_pos + 1, pair_end);
+        // scheme: ALPHA *( ALPHA / DIGIT / "+" / "-" / "." ) ":"
+        if (!rest.empty() && std::isalpha(static_cast<unsigned char>(rest[0]))) {
+            size_t i = 1;
+            while (i < rest.size() && (std::isalnum(static_cast<unsigned char>(rest[i])) ||
+                                       rest[i] == '+' || rest[i] == '-' || rest[i] == '.')) {
+                ++i;
+            }
+            if (i < rest.size() && rest[i] == ':') {
+                parts.scheme = rest.substr(0, i);
+                rest.remove_prefix(i + 1);
             }
+        }
 
-            if (!key.empty()) {
-                store.emplace(url_decode(key), url_decode(value));
+        // authority: "//" [ userinfo "@" ] host [ ":" port ]
+        if (rest.size() >= 2 && rest[0] == '/' && rest[1] == '/') {
+            rest.remove_prefix(2);
+            parts.has_authority = true;
+            std::string_view authority = rest.substr(0, rest.find_first_of("/?#"));
+            rest.remove_prefix(authority.size());
+
+            auto at = authority.rfind('@');
+            if (at != std::string_view::npos) {
+                parts.userinfo = authority.substr(0, at);
+                authority.remove_prefix(at + 1);
             }
 
-            it = (pair_end != end) ? pair_end + 1 : end;
+            // IP-literal hosts are enclosed in brackets and contain ':'
+            size_t host_end = 0;
+            if (!authority.empty() && authority[0] == '[') {
+                host_end = authority.find(']');
+                if (host_end == std::string_view::npos) return false;
+                ++host_end;
+            } else {
+                host_end = std::min(authority.find(':'), authority.size());
+            }
+            parts.host = authority.substr(0, host_end);
+            authority.remove_prefix(host_end);
+
+            if (!authority.empty()) {
+                if (authority[0] != ':') return false;
+                parts.port = authority.substr(1);
+                if (parts.port.empty()) return false;
+                for (char c : parts.port) {
+                    if (c < '0' || c > '9') return false;
+                }
+            }
+            if (parts.host.empty()) return false;
         }
 
-        start = it;
+        // path, query and fragment
+        auto fragment = rest.find('#');
+        if (fragment != std::string_view::npos) {
+            parts.fragment = rest.substr(fragment + 1);
+            rest = rest.substr(0, fragment);
+        }
+        auto query = rest.find('?');
+        if (query != std::string_view::npos) {
+            parts.query = rest.substr(query + 1);
+            parts.has_query = true;
+            rest = rest.substr(0, query);
+        }
+        parts.path = rest;
+        return true;
     }
 
     std::string get_url_encoded_data(const std::multimap<std::string, std::string>& store) {
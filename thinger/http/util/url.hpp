@@ -4,19 +4,43 @@
 #include <algorithm>
 #include <cctype>
 #include <string>
+#include <string_view>
 #include <map>
 
 namespace thinger::http::util::url{
 
+    // Components of a URI reference (RFC 3986 section 3), as views into the split string.
+    // Missing components are empty; path always points to its position in the input.
+    struct uri_parts{
+        std::string_view scheme;
+        std::string_view userinfo;
+        std::string_view host;
+        std::string_view port;
+        std::string_view path;
+        std::string_view query;
+        std::string_view fragment;
+        bool has_authority = false;
+        bool has_query = false;
+    };
+
+    // Split scheme://userinfo@host:port/path?query#fragment without decoding anything.
+    // Returns false if the authority is malformed (empty host or non-numeric port).
+    bool split_uri(std::string_view uri, uri_parts& parts);
+
+    // True if the value contains '%' or '+', so url_decode would change it.
+    inline bool needs_decoding(std::string_view value){
+        return value.find_first_of("%+") != std::string_view::npos;
+    }
+
     std::string uri_path_encode(const std::string &value);
 
     std::string url_encode(const std::string &value);
 
-    bool url_decode(const std::string &in, std::string &out);
+    bool url_decode(std::string_view in, std::string &out);
 
-    std::string url_decode(const std::string &in);
+    std::string url_decode(std::string_view in);
 
-    void parse_url_encoded_data(const std::string &in, std::multimap<std::string, std::string>& store);
+    void parse_url_encoded_data(std::string_view in, std::multimap<std::string, std::string>& store);
 
     void parse_url_encoded_data(std::string::const_iterator& start, std::string::const_iterator& end, std::multimap<std::string, std::string>& store);
 
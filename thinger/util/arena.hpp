@@ -0,0 +1,149 @@
+#ifndef THINGER_UTIL_ARENA_HPP
+#define THINGER_UTIL_ARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include "buffer_pool.hpp"
+
+namespace thinger::util{
+
+    /**
+     * Monotonic memory arena for the objects created while handling the requests of a
+     * connection. Memory is not freed individually: once every allocation from the block has
+     * been released, the next one resets the arena and starts again from the beginning of its
+     * block, so a keep-alive connection handles each request with the same memory. The arena
+     * never grows past its block: while pipelined requests keep it from resetting, allocations
+     * that do not fit are served by the heap and freed individually, so the memory held by a
+     * connection stays bounded. The block comes from the per-thread buffer pool and is given
+     * back with trim() while the arena is unused.
+     *
+     * Allocations and trim() must happen on a single thread; deallocations may happen on any thread.
+     */
+    class arena : public std::pmr::memory_resource{
+    public:
+        static constexpr size_t BLOCK_SIZE = 4096;
+        using block_pool = buffer_pool<BLOCK_SIZE>;
+
+        arena() = default;
+
+        ~arena() override{
+            block_pool::release(block_);
+        }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        /// Number of allocations from the block not released yet.
+        size_t allocations() const{
+            return allocations_.load(std::memory_order_acquire);
+        }
+
+        /// Bytes allocated from the heap because the block was full, not released yet.
+        size_t heap_bytes() const{
+            return heap_bytes_.load(std::memory_order_acquire);
+        }
+
+        /// Bytes of the block in use.
+        size_t used() const{
+            return offset_;
+        }
+
+        /// Whether the arena holds a block.
+        bool holds_memory() const{
+            return base_.load(std::memory_order_acquire) != nullptr;
+        }
+
+        /// Give the memory back if nothing allocated from the arena is alive.
+        void trim(){
+            if(allocations() != 0) return;
+            base_.store(nullptr, std::memory_order_release);
+            offset_ = 0;
+            block_pool::release(block_);
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            if(!block_){
+                block_ = block_pool::acquire();
+                base_.store(reinterpret_cast<std::byte*>(block_.get()), std::memory_order_release);
+                offset_ = 0;
+            }else if(allocations() == 0){
+                // nothing is alive: start over from the beginning of the block
+                offset_ = 0;
+            }
+
+            auto* base = base_.load(std::memory_order_relaxed);
+            auto address = reinterpret_cast<std::uintptr_t>(base + offset_);
+            size_t start = offset_ + ((alignment - address % alignment) % alignment);
+            if(start + bytes <= BLOCK_SIZE){
+                offset_ = start + bytes;
+                allocations_.fetch_add(1, std::memory_order_relaxed);
+                return base + start;
+            }
+
+            // the block is full (or the allocation is larger than it): use the heap
+            void* ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            heap_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+            return ptr;
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override{
+            auto* base = base_.load(std::memory_order_acquire);
+            auto* address = static_cast<std::byte*>(ptr);
+            if(base && address >= base && address < base + BLOCK_SIZE){
+                allocations_.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+            heap_bytes_.fetch_sub(bytes, std::memory_order_release);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+            return this == &other;
+        }
+
+        std::atomic<size_t> allocations_{0};
+        std::atomic<size_t> heap_bytes_{0};
+        std::atomic<std::byte*> base_{nullptr};
+        size_t offset_ = 0;
+        block_pool::buffer block_;
+    };
+
+    /**
+     * Allocator taking memory from an arena, keeping the arena alive while anything allocated
+     * with it is. Intended for std::allocate_shared, so objects may outlive their connection.
+     */
+    template<typename T>
+    class arena_allocator{
+    public:
+        using value_type = T;
+
+        explicit arena_allocator(std::shared_ptr<arena> source) noexcept : arena_(std::move(source)) {}
+
+        template<typename U>
+        arena_allocator(const arena_allocator<U>& other) noexcept : arena_(other.arena_) {}
+
+        T* allocate(size_t n){
+            return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept{
+            arena_->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        template<typename U>
+        bool operator==(const arena_allocator<U>& other) const noexcept{
+            return arena_ == other.arena_;
+        }
+
+    private:
+        template<typename U> friend class arena_allocator;
+        std::shared_ptr<arena> arena_;
+    };
+
+}
+
+#endif
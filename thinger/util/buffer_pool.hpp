@@ -0,0 +1,76 @@
+#ifndef THINGER_UTIL_BUFFER_POOL_HPP
+#define THINGER_UTIL_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace thinger::util{
+
+    /**
+     * Per-thread pool of fixed size buffers, so connections only hold a read buffer while
+     * they have data to process instead of one for their whole lifetime. Buffers are shared
+     * pointers, so parsed requests can keep referencing them; a buffer returns to the pool
+     * only when it comes back unshared.
+     */
+    template<size_t Size>
+    class buffer_pool{
+    public:
+        static constexpr size_t BUFFER_SIZE = Size;
+
+        /// Maximum number of free buffers kept by each thread.
+        static constexpr size_t MAX_FREE_BUFFERS = 128;
+
+        using buffer = std::shared_ptr<uint8_t[]>;
+
+        /// Get a buffer from the calling thread's pool, allocating a new one if it is empty.
+        static buffer acquire(){
+            auto& buffers = free_buffers();
+            if(buffers.empty()) return std::make_shared_for_overwrite<uint8_t[]>(Size);
+            buffer result = std::move(buffers.back());
+            buffers.pop_back();
+            return result;
+        }
+
+        /// Give a buffer back to the calling thread's pool, leaving it empty.
+        static void release(buffer& b){
+            if(!b) return;
+            auto& buffers = free_buffers();
+            if(b.use_count() == 1 && buffers.size() < MAX_FREE_BUFFERS){
+                buffers.push_back(std::move(b));
+            }
+            b.reset();
+        }
+
+        /// Number of free buffers in the calling thread's pool.
+        static size_t available(){
+            return free_buffers().size();
+        }
+
+        /// Buffer acquired for the lifetime of a scope.
+        class lease{
+        public:
+            lease() : buffer_(acquire()) {}
+            ~lease(){ release(buffer_); }
+
+            lease(const lease&) = delete;
+            lease& operator=(const lease&) = delete;
+
+            uint8_t* data() const { return buffer_.get(); }
+            static constexpr size_t size() { return Size; }
+
+        private:
+            buffer buffer_;
+        };
+
+    private:
+        static std::vector<buffer>& free_buffers(){
+            thread_local std::vector<buffer> buffers;
+            return buffers;
+        }
+    };
+
+}
+
+#endif
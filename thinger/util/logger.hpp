@@ -69,6 +69,10 @@
     #define LOG_TRACE(...)    THINGER_LOG_IMPL(spdlog::level::trace, __VA_ARGS__)
     #define LOG_LEVEL(LEVEL, ...) THINGER_LOG_IMPL(static_cast<spdlog::level::level_enum>(LEVEL), __VA_ARGS__)
 
+    // Whether debug messages are logged, to skip building their arguments otherwise
+    #define LOG_DEBUG_ENABLED() \
+        (thinger::logging::get_logger() && thinger::logging::get_logger()->should_log(spdlog::level::debug))
+
     // Thinger specific macros
     #define THINGER_LOG(...)                LOG_INFO(__VA_ARGS__)
     #define THINGER_LOG_TAG(TAG, ...)       LOG_INFO("[{}] " __VA_ARGS__, TAG)
@@ -87,6 +91,7 @@
     #define LOG_DEBUG(...) void()
     #define LOG_TRACE(...) void()
     #define LOG_LEVEL(...) void()
+    #define LOG_DEBUG_ENABLED() false
 
     #define THINGER_LOG(...) void()
     #define THINGER_LOG_ERROR(...) void()
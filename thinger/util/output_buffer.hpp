@@ -0,0 +1,100 @@
+#ifndef THINGER_UTIL_OUTPUT_BUFFER_HPP
+#define THINGER_UTIL_OUTPUT_BUFFER_HPP
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/asio/buffer.hpp>
+#include "buffer_pool.hpp"
+
+namespace thinger::util{
+
+    /**
+     * Output that grows in fixed size blocks taken from the per-thread buffer pool, so large
+     * bodies are produced without reallocating and copying a contiguous string, and written
+     * from the blocks as a gathered write. Blocks go back to the pool when the output is
+     * cleared or destroyed.
+     */
+    class output_buffer{
+    public:
+        static constexpr size_t BLOCK_SIZE = 16 * 1024;
+        using block_pool = buffer_pool<BLOCK_SIZE>;
+
+        output_buffer() = default;
+        ~output_buffer(){ clear(); }
+
+        output_buffer(output_buffer&& other) noexcept :
+            blocks_(std::move(other.blocks_)), size_(std::exchange(other.size_, 0)) {}
+
+        output_buffer& operator=(output_buffer&& other) noexcept{
+            if(this != &other){
+                clear();
+                blocks_ = std::move(other.blocks_);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        output_buffer(const output_buffer&) = delete;
+        output_buffer& operator=(const output_buffer&) = delete;
+
+        void append(const char* data, size_t size){
+            while(size > 0){
+                size_t used = size_ % BLOCK_SIZE;
+                if(size_ == blocks_.size() * BLOCK_SIZE) blocks_.push_back(block_pool::acquire());
+                size_t n = std::min(size, BLOCK_SIZE - used);
+                std::memcpy(blocks_.back().get() + used, data, n);
+                data += n;
+                size -= n;
+                size_ += n;
+            }
+        }
+
+        void push_back(char c){
+            if(size_ == blocks_.size() * BLOCK_SIZE) blocks_.push_back(block_pool::acquire());
+            blocks_.back()[size_ % BLOCK_SIZE] = static_cast<uint8_t>(c);
+            ++size_;
+        }
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        void clear(){
+            for(auto& block : blocks_) block_pool::release(block);
+            blocks_.clear();
+            size_ = 0;
+        }
+
+        /// Call f(data, size) for each block, in order.
+        template<typename F>
+        void for_each(F&& f) const{
+            size_t remaining = size_;
+            for(const auto& block : blocks_){
+                size_t n = std::min(remaining, BLOCK_SIZE);
+                f(reinterpret_cast<const char*>(block.get()), n);
+                remaining -= n;
+            }
+        }
+
+        void to_buffer(std::vector<boost::asio::const_buffer>& buffer) const{
+            for_each([&](const char* data, size_t size){
+                buffer.emplace_back(data, size);
+            });
+        }
+
+        void append_to(std::string& out) const{
+            out.reserve(out.size() + size_);
+            for_each([&](const char* data, size_t size){
+                out.append(data, size);
+            });
+        }
+
+    private:
+        std::vector<block_pool::buffer> blocks_;
+        size_t size_ = 0;
+    };
+
+}
+
+#endif